@@ -28,6 +28,7 @@
 #include <media_group.h>
 #include <media_playlist.h>
 #include <media_bookmark.h>
+#include <media_cursor.h>
 
 
 #ifdef __cplusplus
@@ -43,6 +44,8 @@ extern "C" {
 /**
  * @brief Connects to the media content service.
  * @details Any media content related function call should be invoked after this function call.
+ * @remarks This function is thread safe and reference counted. Each thread reads through its own
+ * read-only connection; writes are serialized on a single connection.
  *
  * @return 0 on success, otherwise a negative error value.
  * @retval #MEDIA_CONTENT_ERROR_NONE Successful
@@ -67,6 +70,144 @@ int media_content_connect(void);
  */
 int media_content_disconnect(void);
 
+/**
+ * @brief Creates the group summary, which keeps the media count of every artist, genre, composer, year and album.
+ * @details Without the summary, the number of those groups and the media count of each of them are counted from
+ * every media on each call. Once it is enabled, triggers keep it up to date whenever the media table changes, and
+ * the count functions of those groups read it when their filter has no condition, order, offset or count.
+ * The summary is stored in the database, so it stays enabled for every application until media_content_disable_group_summary() is called.
+ *
+ * @remarks Calling this function again rebuilds the summary from the media table.
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #MEDIA_CONTENT_ERROR_DB_FAILED DB operation failed
+ * @retval #MEDIA_CONTENT_ERROR_DB_BUSY DB is busy
+ * @pre This function requires opened connection to content service by media_content_connect().
+ * @see media_content_disable_group_summary()
+ * @see media_group_get_group_count_from_db()
+ * @see media_group_get_media_count_from_db()
+ * @see media_album_get_album_count_from_db()
+ */
+int media_content_enable_group_summary(void);
+
+/**
+ * @brief Drops the group summary and its triggers.
+ *
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_DB_FAILED DB operation failed
+ * @retval #MEDIA_CONTENT_ERROR_DB_BUSY DB is busy
+ * @pre This function requires opened connection to content service by media_content_connect().
+ * @see media_content_enable_group_summary()
+ */
+int media_content_disable_group_summary(void);
+
+/**
+ * @brief Creates the usage version, which lets media_info_foreach_usage_from_db() keep the storage usage of the whole library in memory.
+ * @details Triggers bump the version whenever a media is added, removed, or changes its validity, storage, type, MIME type or size.
+ * The cached usage is read again only when the version is not the one it was read at, so changes made by any process are seen.
+ * The version is stored in the database, so it stays enabled for every application until media_content_disable_usage_cache() is called.
+ *
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_DB_FAILED DB operation failed
+ * @retval #MEDIA_CONTENT_ERROR_DB_BUSY DB is busy
+ * @pre This function requires opened connection to content service by media_content_connect().
+ * @see media_content_disable_usage_cache()
+ * @see media_info_foreach_usage_from_db()
+ */
+int media_content_enable_usage_cache(void);
+
+/**
+ * @brief Drops the usage version and its triggers, and the cached storage usage.
+ *
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_DB_FAILED DB operation failed
+ * @retval #MEDIA_CONTENT_ERROR_DB_BUSY DB is busy
+ * @pre This function requires opened connection to content service by media_content_connect().
+ * @see media_content_enable_usage_cache()
+ */
+int media_content_disable_usage_cache(void);
+
+/**
+ * @brief Creates the indexes for the common conditions and orders of media lists.
+ * @details They serve lists of one media type ordered by added or modified time, folders ordered by display name,
+ * and the media of an artist or an album. The indexes are stored in the database, so they are created only once.
+ * They make each insert and update of a media a little slower.
+ *
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_DB_FAILED DB operation failed
+ * @retval #MEDIA_CONTENT_ERROR_DB_BUSY DB is busy
+ * @pre This function requires opened connection to content service by media_content_connect().
+ * @see media_filter_get_query_plan()
+ */
+int media_content_create_indexes(void);
+
+/**
+ * @brief Starts recording the statistics of the queries run by this process.
+ * @details For each query, the number of runs, the time spent preparing and stepping it, and the number of rows
+ * returned and made into media info handles are recorded. Setting the MEDIA_CONTENT_STATS environment variable
+ * enables them from media_content_connect(), so an application can be measured without being rebuilt.
+ *
+ * @remarks Recording adds a little time to every query. Queries are told apart by their SQL, and at most 256 of them are recorded.
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @see media_content_disable_stats()
+ * @see media_content_get_stats()
+ */
+int media_content_enable_stats(void);
+
+/**
+ * @brief Stops recording the statistics of the queries.
+ * @details The statistics recorded so far can still be read with media_content_get_stats().
+ *
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @see media_content_enable_stats()
+ */
+int media_content_disable_stats(void);
+
+/**
+ * @brief Iterates through the statistics of the queries recorded since they were enabled or reset.
+ *
+ * @param[in] callback The callback function to invoke
+ * @param[in] user_data The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_OUT_OF_MEMORY Out of memory
+ * @post This function invokes media_content_stats_cb().
+ * @see media_content_enable_stats()
+ * @see media_content_reset_stats()
+ */
+int media_content_get_stats(media_content_stats_cb callback, void *user_data);
+
+/**
+ * @brief Clears the statistics of the queries.
+ *
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @see media_content_get_stats()
+ */
+int media_content_reset_stats(void);
+
+/**
+ * @brief Cancels an asynchronous request.
+ * @details Rows which are not read yet are skipped, and no callback of the request is called after this function returns
+ * if it is called in the thread which runs the main context of the request.
+ *
+ * @param[in] request_id The ID of the request
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter, or the request is already finished
+ * @see media_info_foreach_media_from_db_async()
+ * @see media_folder_get_folder_count_from_db_async()
+ */
+int media_content_cancel_request(unsigned int request_id);
+
 /**
  * @}
  */
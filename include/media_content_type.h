@@ -19,6 +19,7 @@
 #define __TIZEN_MEDIA_CONTENT_TYPE_H__
 
 #include <time.h>
+#include <glib.h>
 #include <tizen.h>
 
 #ifdef __cplusplus
@@ -96,6 +97,43 @@ typedef enum
 	MEDIA_CONTENT_COLLATE_RTRIM		= 2,		/**< collation RTRIM, trailing space characters are ignored */
 } media_content_collation_e;
 
+/**
+ * @ingroup CAPI_MEDIA_CONTENT_MODULE
+ * @brief The enumerations of media info field groups, used with media_filter_set_projection().
+ */
+typedef enum
+{
+	MEDIA_CONTENT_FIELD_CORE		= 0x01,		/**< id, path, name, type, mime type, size, times, thumbnail, description, rating, favourite, author, provider, content name, category, location tag, age rating, keyword, drm, storage type. Always loaded */
+	MEDIA_CONTENT_FIELD_LOCATION	= 0x02,		/**< longitude, latitude, altitude */
+	MEDIA_CONTENT_FIELD_IMAGE_META	= 0x04,		/**< image meta */
+	MEDIA_CONTENT_FIELD_AV_META		= 0x08,		/**< audio and video meta */
+	MEDIA_CONTENT_FIELD_ALL			= 0x0F,		/**< all fields */
+} media_content_field_group_e;
+
+/**
+ * @ingroup CAPI_MEDIA_CONTENT_MODULE
+ * @brief The enumerations of query plan flags, used with media_filter_get_query_plan().
+ */
+typedef enum
+{
+	MEDIA_CONTENT_QUERY_PLAN_INDEXED	= 0x00,		/**< every table is searched through an index */
+	MEDIA_CONTENT_QUERY_PLAN_FULL_SCAN	= 0x01,		/**< a table is read row by row */
+	MEDIA_CONTENT_QUERY_PLAN_TEMP_SORT	= 0x02,		/**< the rows are sorted in a temporary B-tree for the order */
+} media_content_query_plan_e;
+
+/**
+ * @ingroup CAPI_MEDIA_CONTENT_MODULE
+ * @brief The enumerations of aggregate operations, used with media_info_get_aggregate_from_db().
+ */
+typedef enum
+{
+	MEDIA_CONTENT_AGGREGATE_COUNT	= 0,	/**< number of media with a value */
+	MEDIA_CONTENT_AGGREGATE_SUM,			/**< sum of the values */
+	MEDIA_CONTENT_AGGREGATE_MIN,			/**< smallest value */
+	MEDIA_CONTENT_AGGREGATE_MAX,			/**< largest value */
+	MEDIA_CONTENT_AGGREGATE_AVG,			/**< average of the values */
+} media_content_aggregate_e;
+
 /**
  * @ingroup CAPI_MEDIA_CONTENT_MODULE
  * @brief The enumerations of media content error
@@ -110,6 +148,7 @@ typedef enum
 	MEDIA_CONTENT_ERROR_NETWORK					= TIZEN_ERROR_CONTENT_CLASS | 0x03,	/**< Network Fail */
 	MEDIA_CONTENT_ERROR_UNSUPPORTED_CONTENT		= TIZEN_ERROR_CONTENT_CLASS | 0x04,	/**< Unsupported Content */
 	MEDIA_CONTENT_ERROR_INVALID_OPERATION		= TIZEN_ERROR_CONTENT_CLASS | 0x05,	/**< Invalid Operation */
+	MEDIA_CONTENT_ERROR_NOT_LOADED				= TIZEN_ERROR_CONTENT_CLASS | 0x06,	/**< Field was not loaded, see media_filter_set_projection() */
 } media_content_error_e;
 
 /**
@@ -151,6 +190,12 @@ typedef enum {
  */
 typedef struct media_info_s *media_info_h;
 
+/**
+ * @ingroup CAPI_CONTENT_MEDIA_INFO_MODULE
+ * @brief The handle to media cursor.
+ */
+typedef struct media_cursor_s *media_cursor_h;
+
 /**
  * @ingroup CAPI_CONTENT_MEDIA_FOLDER_MODULE
  * @brief The handle to media folder.
@@ -211,6 +256,54 @@ typedef struct audio_meta_s *audio_meta_h;
  */
 typedef struct filter_s *filter_h;
 
+/**
+ * @ingroup CAPI_MEDIA_CONTENT_MODULE
+ * @brief The statistics of one query, used with media_content_get_stats().
+ * @details Times are in microseconds. The 99th percentiles are taken over the latest runs of the query.
+ */
+typedef struct
+{
+	int count;								/**< number of runs, from prepare to finalize */
+	unsigned long long prepare_total;		/**< total time spent preparing the statement */
+	unsigned long long prepare_avg;		/**< average prepare time */
+	unsigned long long prepare_p99;		/**< 99th percentile of prepare time */
+	unsigned long long step_total;			/**< total time spent stepping through the rows */
+	unsigned long long step_avg;			/**< average step time of a run */
+	unsigned long long step_p99;			/**< 99th percentile of step time of a run */
+	unsigned long long rows_returned;		/**< rows returned by the database */
+	unsigned long long rows_materialized;	/**< rows made into media info handles */
+} media_content_stats_s;
+
+/**
+ * @ingroup CAPI_CONTENT_MEDIA_INFO_MODULE
+ * @brief The structure of the arrays media_info_foreach_columns_from_db() fills, one entry per media.
+ * @details Arrays which are NULL are not filled. The path of the row @a i is at @a path + @a path_offset[i] and ends with '\0'.
+ */
+typedef struct
+{
+	int capacity;					/**< rows each array can hold, set by you */
+	int count;						/**< rows filled */
+	unsigned long long *size;		/**< size of the media */
+	int *media_type;				/**< #media_content_type_e of the media */
+	time_t *added_time;				/**< added time of the media */
+	int *path_offset;				/**< @a capacity + 1 offsets into @a path, the last one is the number of bytes used */
+	char *path;						/**< paths of the media */
+	int path_capacity;				/**< bytes @a path can hold, set by you */
+} media_info_columns_s;
+
+/**
+ * @ingroup CAPI_CONTENT_MEDIA_INFO_MODULE
+ * @brief The structure of a row of the storage usage, see media_info_foreach_usage_from_db().
+ */
+typedef struct
+{
+	media_content_storage_e storage_type;	/**< storage of the media */
+	media_content_type_e media_type;		/**< type of the media */
+	const char *mime_type;					/**< MIME type of the media, NULL if it is unknown */
+	int media_count;						/**< number of media */
+	unsigned long long total_size;			/**< sum of their sizes */
+} media_content_usage_s;
+
 /**
  * @ingroup CAPI_CONTENT_MEDIA_INFO_MODULE
  * @brief Iterates over a list of media info.
@@ -238,6 +331,107 @@ typedef struct filter_s *filter_h;
  */
 typedef bool (*media_info_cb)(media_info_h media, void *user_data);
 
+/**
+ * @ingroup CAPI_CONTENT_MEDIA_INFO_MODULE
+ * @brief Called with the result of every file passed to media_info_insert_batch_to_db().
+ *
+ * @details This callback is called once for every path, in the order of the given array.\n
+ *
+ * @remarks To use the @a media outside this function, copy the handle with #media_info_clone() function.
+ *
+ * @param[in] path The path to the media file
+ * @param[in] result #MEDIA_CONTENT_ERROR_NONE if the file is registered, otherwise the error of this file
+ * @param[in] media The handle to the registered media info, NULL if @a result is not #MEDIA_CONTENT_ERROR_NONE
+ * @param[in] user_data The user data passed from media_info_insert_batch_to_db()
+ * @return true to continue with the next file,
+ * @return false to stop registering the remaining files.
+ * @pre media_info_insert_batch_to_db() will invoke this function.
+ * @see media_info_clone()
+ * @see media_info_insert_batch_to_db()
+ */
+typedef bool (*media_insert_batch_cb)(const char *path, int result, media_info_h media, void *user_data);
+
+/**
+ * @ingroup CAPI_CONTENT_MEDIA_INFO_MODULE
+ * @brief Iterates over a list of media info, several at a time.
+ *
+ * @details This callback is called for every batch of available media info, in the order of the query.\n
+ *
+ * @remarks To use a handle of @a media outside this function, copy it with #media_info_clone() function.
+ *
+ * @param[in] media The array of handles to media info
+ * @param[in] count The number of handles in @a media
+ * @param[in] user_data The user data passed from the foreach function
+ * @return true to continue with the next batch,
+ * @return false to stop.
+ * @pre media_info_foreach_media_batch_from_db(), media_info_foreach_media_from_db_async() will invoke this function.
+ * @see media_info_clone()
+ * @see media_info_foreach_media_batch_from_db()
+ * @see media_info_foreach_media_from_db_async()
+ */
+typedef bool (*media_info_batch_cb)(media_info_h *media, int count, void *user_data);
+
+/**
+ * @ingroup CAPI_CONTENT_MEDIA_INFO_MODULE
+ * @brief Called each time the arrays passed to media_info_foreach_columns_from_db() are filled.
+ *
+ * @details This callback is called when the arrays are full, and once more with the last rows.\n
+ *
+ * @remarks The arrays are filled again with the next rows after this function returns.
+ *
+ * @param[in] columns The arrays, with @a count rows filled
+ * @param[in] user_data The user data passed from the foreach function
+ * @return true to continue with the next rows,
+ * @return false to stop.
+ * @pre media_info_foreach_columns_from_db() will invoke this function.
+ * @see media_info_foreach_columns_from_db()
+ */
+typedef bool (*media_info_columns_cb)(const media_info_columns_s *columns, void *user_data);
+
+/**
+ * @ingroup CAPI_CONTENT_MEDIA_INFO_MODULE
+ * @brief Iterates over the rows of the storage usage.
+ *
+ * @details This callback is called for every combination of storage, media type and MIME type which has media.\n
+ *
+ * @remarks You should not free @a usage returned by this function.
+ *
+ * @param[in] usage The row of the storage usage
+ * @param[in] user_data The user data passed from the foreach function
+ * @return true to continue with the next iteration of the loop,
+ * @return false to break out of the loop.
+ * @pre media_info_foreach_usage_from_db() will invoke this function.
+ * @see media_info_foreach_usage_from_db()
+ */
+typedef bool (*media_content_usage_cb)(const media_content_usage_s *usage, void *user_data);
+
+/**
+ * @ingroup CAPI_MEDIA_CONTENT_MODULE
+ * @brief Called when an asynchronous request is finished.
+ *
+ * @details This callback is called once, after the last result of the request. It is not called for a request cancelled by media_content_cancel_request().\n
+ *
+ * @param[in] error The error code of the request
+ * @param[in] user_data The user data passed from the asynchronous function
+ * @pre media_info_foreach_media_from_db_async() will invoke this function.
+ * @see media_content_cancel_request()
+ */
+typedef void (*media_content_request_completed_cb)(media_content_error_e error, void *user_data);
+
+/**
+ * @ingroup CAPI_MEDIA_CONTENT_MODULE
+ * @brief Called with the result of an asynchronous count.
+ *
+ * @details This callback is called once. It is not called for a request cancelled by media_content_cancel_request().\n
+ *
+ * @param[in] error The error code of the request
+ * @param[in] count The count, 0 if @a error is not #MEDIA_CONTENT_ERROR_NONE
+ * @param[in] user_data The user data passed from the asynchronous function
+ * @pre media_folder_get_folder_count_from_db_async() will invoke this function.
+ * @see media_content_cancel_request()
+ */
+typedef void (*media_content_count_completed_cb)(media_content_error_e error, int count, void *user_data);
+
 
 /**
  * @ingroup CAPI_CONTENT_MEDIA_INFO_MODULE
@@ -272,6 +466,24 @@ typedef void (*media_thumbnail_completed_cb)(media_content_error_e error, const
  */
 typedef bool (*media_folder_cb)(media_folder_h folder, void *user_data);
 
+/**
+ * @ingroup CAPI_CONTENT_MEDIA_FOLDER_MODULE
+ * @brief Iterates over folder list with the media count of every folder.
+ *
+ * @details This callback is called for every folder in the list, with the number of its media which meet the filter.\n
+ *
+ * @remarks To use the @a folder outside this function, copy the handle with #media_folder_clone() function.
+ *
+ * @param[in] folder The handle to media folder
+ * @param[in] media_count The number of media in the folder
+ * @param[in] user_data The user data passed from the foreach function
+ * @return true to continue with the next iteration of the loop,
+ * @return false to break out of the loop.
+ * @pre media_folder_foreach_folder_with_count_from_db() will invoke this function.
+ * @see media_folder_foreach_folder_with_count_from_db()
+ */
+typedef bool (*media_folder_count_cb)(media_folder_h folder, int media_count, void *user_data);
+
 /**
  * @ingroup CAPI_CONTENT_MEDIA_PLAYLIST_MODULE
  * @brief Iterates over playlist list.
@@ -290,6 +502,24 @@ typedef bool (*media_folder_cb)(media_folder_h folder, void *user_data);
  */
 typedef bool (*media_playlist_cb)(media_playlist_h playlist, void *user_data);
 
+/**
+ * @ingroup CAPI_CONTENT_MEDIA_PLAYLIST_MODULE
+ * @brief Iterates over playlist list with the media count of every playlist.
+ *
+ * @details This callback is called for every playlist in the list, with the number of its media which meet the filter.\n
+ *
+ * @remarks To use the @a playlist outside this function, copy the handle with #media_playlist_clone() function.
+ *
+ * @param[in] playlist The handle to media playlist
+ * @param[in] media_count The number of media in the playlist
+ * @param[in] user_data The user data passed from the foreach function
+ * @return true to continue with the next iteration of the loop,
+ * @return false to break out of the loop.
+ * @pre media_playlist_foreach_playlist_with_count_from_db() will invoke this function.
+ * @see media_playlist_foreach_playlist_with_count_from_db()
+ */
+typedef bool (*media_playlist_count_cb)(media_playlist_h playlist, int media_count, void *user_data);
+
 /**
  * @ingroup CAPI_CONTENT_MEDIA_PLAYLIST_MODULE
  * @brief Iterates over playlist member.
@@ -328,6 +558,24 @@ typedef bool(* playlist_member_cb)(int playlist_member_id, media_info_h media, v
  */
 typedef bool (*media_tag_cb)(media_tag_h tag, void *user_data);
 
+/**
+ * @ingroup CAPI_CONTENT_MEDIA_TAG_MODULE
+ * @brief Iterates over tag list with the media count of every tag.
+ *
+ * @details This callback is called for every tag in the list, with the number of its media which meet the filter.\n
+ *
+ * @remarks To use the @a tag outside this function, copy the handle with #media_tag_clone() function.
+ *
+ * @param[in] tag The handle to media tag
+ * @param[in] media_count The number of media in the tag
+ * @param[in] user_data The user data passed from the foreach function
+ * @return true to continue with the next iteration of the loop,
+ * @return false to break out of the loop.
+ * @pre media_tag_foreach_tag_with_count_from_db() will invoke this function.
+ * @see media_tag_foreach_tag_with_count_from_db()
+ */
+typedef bool (*media_tag_count_cb)(media_tag_h tag, int media_count, void *user_data);
+
 /**
  * @ingroup CAPI_CONTENT_MEDIA_BOOKMARK_MODULE
  * @brief Iterates over bookmark list
@@ -363,6 +611,24 @@ typedef bool (*media_bookmark_cb)(media_bookmark_h bookmark, void *user_data);
  */
 typedef bool (*media_album_cb)(media_album_h album, void *user_data);
 
+/**
+ * @ingroup CAPI_CONTENT_MEDIA_ALBUM_MODULE
+ * @brief Iterates over album list with the media count of every album.
+ *
+ * @details This callback is called for every album in the list, with the number of its media which meet the filter.\n
+ *
+ * @remarks To use the @a album outside this function, copy the handle with #media_album_clone() function.
+ *
+ * @param[in] album The handle to media album
+ * @param[in] media_count The number of media in the album
+ * @param[in] user_data The user data passed from the foreach function
+ * @return true to continue with the next iteration of the loop,
+ * @return false to break out of the loop.
+ * @pre media_album_foreach_album_with_count_from_db() will invoke this function.
+ * @see media_album_foreach_album_with_count_from_db()
+ */
+typedef bool (*media_album_count_cb)(media_album_h album, int media_count, void *user_data);
+
 typedef bool (*media_artist_cb)(const char *artist, void *user_data);
 typedef bool (*media_genre_cb)(const char *genre, void *user_data);
 typedef bool (*media_composer_cb)(const char *composer, void *user_data);
@@ -385,6 +651,40 @@ typedef bool (*media_year_cb)(const char *year, void *user_data);
  */
 typedef bool (*media_group_cb)(const char *group_name, void *user_data);
 
+/**
+ * @ingroup CAPI_CONTENT_MEDIA_GROUP_MODULE
+ * @brief Iterates over group list with the media count of every group.
+ *
+ * @details This callback is called for every group in the list, with the number of its media which meet the filter.\n
+ *
+ * @remarks You should not free group_name returned by this function.
+ *
+ * @param[in] group_name The name of media group
+ * @param[in] media_count The number of media in the group
+ * @param[in] user_data The user data passed from the foreach function
+ * @return true to continue with the next iteration of the loop,
+ * @return false to break out of the loop.
+ * @pre media_group_foreach_group_with_count_from_db() will invoke this function.
+ * @see media_group_foreach_group_with_count_from_db()
+ */
+typedef bool (*media_group_count_cb)(const char *group_name, int media_count, void *user_data);
+
+/**
+ * @ingroup CAPI_MEDIA_CONTENT_MODULE
+ * @brief Iterates over the statistics of the queries run since they were enabled or reset.
+ *
+ * @remarks You should not free query or stats returned by this function.
+ *
+ * @param[in] query The SQL of the query, with ? for its bound values
+ * @param[in] stats The statistics of the query
+ * @param[in] user_data The user data passed from the foreach function
+ * @return true to continue with the next iteration of the loop,
+ * @return false to break out of the loop.
+ * @pre media_content_get_stats() will invoke this function.
+ * @see media_content_get_stats()
+ */
+typedef bool (*media_content_stats_cb)(const char *query, const media_content_stats_s *stats, void *user_data);
+
 /**
  * @}
  */
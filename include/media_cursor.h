@@ -0,0 +1,129 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#ifndef __TIZEN_MEDIA_CURSOR_H__
+#define __TIZEN_MEDIA_CURSOR_H__
+
+#include <media_content_type.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+
+
+/**
+ * @addtogroup CAPI_CONTENT_MEDIA_INFO_MODULE
+ * @{
+ */
+
+/**
+ * @brief Opens a cursor over the media info which meets the condition of @a filter.
+ * @details The cursor gives the same rows as media_info_foreach_media_from_db(), but the caller pulls them
+ * with media_cursor_next() at its own pace. Rows are read from the database @a prefetch_count at a time.
+ *
+ * @remarks @a cursor must be released with media_cursor_close() by you.\n
+ * A cursor may be used from another thread than the one which opened it, but not after that thread disconnected or exited.
+ *
+ * @param[in] filter The handle to media filter, it can be NULL
+ * @param[in] prefetch_count The number of rows read at once, 0 for the default
+ * @param[out] cursor The handle to media cursor
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #MEDIA_CONTENT_ERROR_DB_FAILED DB operation failed
+ * @pre This function requires opened connection to content service by media_content_connect().
+ * @see media_content_connect()
+ * @see media_cursor_next()
+ * @see media_cursor_close()
+ */
+int media_cursor_open(filter_h filter, int prefetch_count, media_cursor_h *cursor);
+
+/**
+ * @brief Opens a cursor over the media info in the given folder.
+ * @details The cursor gives the same rows as media_folder_foreach_media_from_db().
+ *
+ * @remarks @a cursor must be released with media_cursor_close() by you.
+ *
+ * @param[in] folder_id The ID of media folder
+ * @param[in] filter The handle to media filter, it can be NULL
+ * @param[in] prefetch_count The number of rows read at once, 0 for the default
+ * @param[out] cursor The handle to media cursor
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #MEDIA_CONTENT_ERROR_DB_FAILED DB operation failed
+ * @pre This function requires opened connection to content service by media_content_connect().
+ * @see media_cursor_open()
+ * @see media_cursor_close()
+ */
+int media_cursor_open_by_folder(const char *folder_id, filter_h filter, int prefetch_count, media_cursor_h *cursor);
+
+/**
+ * @brief Moves the cursor to the next row.
+ *
+ * @param[in] cursor The handle to media cursor
+ * @param[out] available true if the cursor is on a row, false if every row has been read
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #MEDIA_CONTENT_ERROR_DB_FAILED DB operation failed
+ * @see media_cursor_get_media()
+ */
+int media_cursor_next(media_cursor_h cursor, bool *available);
+
+/**
+ * @brief Gets the media info of the current row.
+ *
+ * @remarks @a media is owned by the cursor. It is valid until the cursor reads its next page or is closed.
+ * To use it longer, copy the handle with media_info_clone().
+ *
+ * @param[in] cursor The handle to media cursor
+ * @param[out] media The handle to media info of the current row
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_OPERATION The cursor is not on a row
+ * @pre media_cursor_next() returned true in @a available.
+ * @see media_cursor_next()
+ * @see media_info_clone()
+ */
+int media_cursor_get_media(media_cursor_h cursor, media_info_h *media);
+
+/**
+ * @brief Closes the cursor and releases its resources.
+ *
+ * @param[in] cursor The handle to media cursor
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see media_cursor_open()
+ */
+int media_cursor_close(media_cursor_h cursor);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __TIZEN_MEDIA_CURSOR_H__ */
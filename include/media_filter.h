@@ -107,6 +107,85 @@ int media_filter_set_condition(filter_h filter, const char *condition, media_con
  */
 int media_filter_set_order(filter_h filter, media_content_order_e order_type, const char *order_keyword, media_content_collation_e collate_type);
 
+/**
+ * @brief Set the field groups of media info to be loaded by foreach functions.
+ * @details By default every field is loaded. Grid and list views which only show a few fields can skip the
+ * location and meta columns, which saves reading and copying them for every row.
+ * Getters of a field group which was not loaded return #MEDIA_CONTENT_ERROR_NOT_LOADED.
+ *
+ * @remarks #MEDIA_CONTENT_FIELD_CORE is always loaded.
+ * @param[in] filter The handle to media filter
+ * @param[in] field_groups Bitwise OR of #media_content_field_group_e values
+ * @return return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see media_filter_create()
+ * @see media_filter_get_projection()
+ */
+int media_filter_set_projection(filter_h filter, int field_groups);
+
+/**
+ * @brief Set the continuation token where the next page of media starts.
+ * @details With a token set, functions which list media info skip the rows up to and including the row the token
+ * was made from, instead of skipping @a offset rows. Reading a deep page then costs the same as reading the first one.
+ * An empty string starts at the first page, NULL goes back to the offset set by media_filter_set_offset().
+ *
+ * @remarks The filter must be ordered by a single field, and the order must not be changed while paging.
+ * Media with the same value of that field are ordered by their ID.\n
+ * Only the count set by media_filter_set_offset() is used in this mode. Groups, bookmarks and playlist members ignore the token.
+ * @param[in] filter The handle to media filter
+ * @param[in] token The token from media_filter_get_continuation_token(), an empty string, or NULL
+ * @return return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see media_filter_get_continuation_token()
+ * @see media_filter_set_order()
+ */
+int media_filter_set_continuation_token(filter_h filter, const char *token);
+
+/**
+ * @brief Get the continuation token which starts the page after @a media.
+ * @details Call it with the last media of a page and pass the token to media_filter_set_continuation_token()
+ * before asking for the next page.
+ *
+ * @remarks @a token must be released with free() by you.\n
+ * The token is opaque. It holds the value of the order field of @a media and its ID.
+ * @param[in] filter The handle to media filter, ordered by a single field
+ * @param[in] media The last media info of the page
+ * @param[out] token The continuation token
+ * @return return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_OPERATION The filter is not ordered by a single field
+ * @retval #MEDIA_CONTENT_ERROR_DB_FAILED DB operation failed
+ * @pre This function requires opened connection to content service by media_content_connect().
+ * @see media_filter_set_continuation_token()
+ */
+int media_filter_get_continuation_token(filter_h filter, media_info_h media, char **token);
+
+/**
+ * @brief Explains how the database runs media_info_foreach_media_from_db() with @a filter.
+ * @details @a plan is a combination of #media_content_query_plan_e flags. #MEDIA_CONTENT_QUERY_PLAN_FULL_SCAN means
+ * every media is read to find the ones which meet the condition, and #MEDIA_CONTENT_QUERY_PLAN_TEMP_SORT means
+ * they are all sorted before the first one is returned. Both grow with the size of the library;
+ * media_content_create_indexes() creates indexes for the common conditions and orders.
+ *
+ * @remarks @a detail must be released with free() by you. It has one line per step of the plan, as SQLite reports it.
+ * @param[in] filter The handle to media filter
+ * @param[out] plan The query plan flags
+ * @param[out] detail The steps of the query plan, it can be NULL
+ * @return return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #MEDIA_CONTENT_ERROR_DB_FAILED DB operation failed
+ * @pre This function requires opened connection to content service by media_content_connect().
+ * @see media_content_create_indexes()
+ */
+int media_filter_get_query_plan(filter_h filter, int *plan, char **detail);
+
 /**
  * @brief Gets the @a offset and @a count for the given @a filter used to limit number of items returned.
  *
@@ -153,6 +232,18 @@ int media_filter_get_condition(filter_h filter, char **condition, media_content_
  */
 int media_filter_get_order(filter_h filter, media_content_order_e* order_type, char **order_keyword, media_content_collation_e *collate_type);
 
+/**
+ * @brief Get the field groups of media info to be loaded by foreach functions.
+ *
+ * @param[in] filter The handle to media filter
+ * @param[out] field_groups Bitwise OR of #media_content_field_group_e values
+ * @return return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see media_filter_set_projection()
+ */
+int media_filter_get_projection(filter_h filter, int *field_groups);
+
 
 /**
  * @}
@@ -46,6 +46,33 @@ extern "C" {
  */
 int media_folder_get_folder_count_from_db(filter_h filter, int *folder_count);
 
+/**
+ * @brief Gets the number of folder for the passed @a filter from the media database without blocking the caller.
+ * @details This function runs media_folder_get_folder_count_from_db() on a worker thread of the library, which reads
+ * the database with its own connection, and calls @a callback with the count in the thread which runs @a context.
+ *
+ * @remarks The @a filter is copied, so it can be destroyed once this function returns.\n
+ * If NULL is passed to the @a context, the global default main context is used.
+ * @param[in] filter The handle to filter
+ * @param[in] context The main context to call @a callback in
+ * @param[in] callback The callback function to invoke with the count
+ * @param[in] user_data The user data to be passed to the callback function
+ * @param[out] request_id The ID of the request, to cancel it with media_content_cancel_request(), can be NULL
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_OPERATION The worker thread can not be started
+ * @pre This function requires opened connection to content service by media_content_connect().
+ * @post This function invokes media_content_count_completed_cb().
+ * @see media_content_connect()
+ * @see media_folder_get_folder_count_from_db()
+ * @see media_content_cancel_request()
+ *
+ */
+int media_folder_get_folder_count_from_db_async(filter_h filter, GMainContext *context, media_content_count_completed_cb callback,
+	void *user_data, unsigned int *request_id);
+
 /**
  * @brief Iterates through available media folders with optional @a filter from the media database.
  * @details This function gets media folder handles meeting the given 
@@ -68,6 +95,29 @@ int media_folder_get_folder_count_from_db(filter_h filter, int *folder_count);
  */
 int media_folder_foreach_folder_from_db(filter_h filter, media_folder_cb callback, void *user_data);
 
+/**
+ * @brief Iterates through the media folder with the number of media in every folder.
+ * @details The folders and their media count come from one query. Calling media_folder_get_media_count_from_db() for every folder
+ * from the callback of media_folder_foreach_folder_from_db() gives the same counts with one query per folder.
+ * If NULL is passed to the filter, no filtering is applied.
+ *
+ * @remarks The condition of @a filter is applied to the media which are counted. A folder is listed if at least one of its media meets it.
+ *
+ * @param[in] filter The handle to media filter
+ * @param[in] callback The callback function to invoke
+ * @param[in] user_data The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_OUT_OF_MEMORY Out of memory
+ * @pre This function requires opened connection to content service by media_content_connect().
+ * @post This function invokes media_folder_count_cb().
+ * @see #media_folder_count_cb
+ * @see media_folder_foreach_folder_from_db()
+ * @see media_folder_get_media_count_from_db()
+ */
+int media_folder_foreach_folder_with_count_from_db(filter_h filter, media_folder_count_cb callback, void *user_data);
+
 /**
  * @brief Gets the number of media files for the passed @a filter in the given @a folder from the media database.
  *
@@ -67,6 +67,29 @@ int media_album_get_album_count_from_db(filter_h filter, int *album_count);
  */
 int media_album_foreach_album_from_db(filter_h filter, media_album_cb callback, void *user_data);
 
+/**
+ * @brief Iterates through the media album with the number of media in every album.
+ * @details The albums and their media count come from one query. Calling media_album_get_media_count_from_db() for every album
+ * from the callback of media_album_foreach_album_from_db() gives the same counts with one query per album.
+ * If NULL is passed to the filter, no filtering is applied.
+ *
+ * @remarks The condition of @a filter is applied to the media which are counted. A album is listed if at least one of its media meets it.
+ *
+ * @param[in] filter The handle to media filter
+ * @param[in] callback The callback function to invoke
+ * @param[in] user_data The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_OUT_OF_MEMORY Out of memory
+ * @pre This function requires opened connection to content service by media_content_connect().
+ * @post This function invokes media_album_count_cb().
+ * @see #media_album_count_cb
+ * @see media_album_foreach_album_from_db()
+ * @see media_album_get_media_count_from_db()
+ */
+int media_album_foreach_album_with_count_from_db(filter_h filter, media_album_count_cb callback, void *user_data);
+
 /**
  * @brief Gets number of media info for the given album present in the media database.
  *
@@ -264,6 +287,30 @@ int media_group_get_group_count_from_db(filter_h filter, media_group_e group, in
  */
 int media_group_foreach_group_from_db(filter_h filter, media_group_e group, media_group_cb callback, void *user_data);
 
+/**
+ * @brief Iterates through the media group with the number of media in every group.
+ * @details The groups and their media count come from one query. Calling media_group_get_media_count_from_db() for every group
+ * from the callback of media_group_foreach_group_from_db() gives the same counts with one query per group.
+ * If NULL is passed to the filter, no filtering is applied.
+ *
+ * @remarks The condition of @a filter is applied to the media which are counted. A group is listed if at least one of its media meets it.
+ *
+ * @param[in] filter The handle to media filter
+ * @param[in] group The type of media group
+ * @param[in] callback The callback function to invoke
+ * @param[in] user_data The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_OUT_OF_MEMORY Out of memory
+ * @pre This function requires opened connection to content service by media_content_connect().
+ * @post This function invokes media_group_count_cb().
+ * @see #media_group_count_cb
+ * @see media_group_foreach_group_from_db()
+ * @see media_group_get_media_count_from_db()
+ */
+int media_group_foreach_group_with_count_from_db(filter_h filter, media_group_e group, media_group_count_cb callback, void *user_data);
+
  /**
  * @brief Gets number of media info for the given media group present in the media database.
  *
@@ -49,6 +49,28 @@ extern "C" {
  */
 int media_info_insert_to_db (const char *path, media_info_h *info);
 
+/**
+ * @brief Inserts media files into the media database.
+ * @details This function registers the files in chunks and reads the registered items back with one query per chunk,
+ * instead of one query per file as media_info_insert_to_db() does. The result of every file is passed to @a callback.
+ *
+ * @param[in] path_array The paths to the media files
+ * @param[in] array_length The number of paths in @a path_array
+ * @param[in] callback The callback function to invoke for every path
+ * @param[in] user_data The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value. The failure of a single file is reported to @a callback only.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #MEDIA_CONTENT_ERROR_DB_FAILED DB operation failed
+ * @pre This function requires opened connection to content service by media_content_connect().
+ * @post This function invokes media_insert_batch_cb().
+ * @see media_content_connect()
+ * @see media_info_insert_to_db()
+ * @see media_insert_batch_cb()
+ */
+int media_info_insert_batch_to_db(const char **path_array, unsigned int array_length, media_insert_batch_cb callback, void *user_data);
+
 /**
  * @brief Deletes media file from the media database.
  * @details This function deletes an media item from the content storage.
@@ -73,6 +95,7 @@ int media_info_delete_from_db(const char *media_id);
  * @return 0 on success, otherwise a negative error value.
  * @retval #MEDIA_CONTENT_ERROR_NONE Successful
  * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_OPERATION The handle was passed to a #media_info_cb and is released by the foreach function
  * @pre Get copy of media_info handle by calling media_info_clone()
  * @see media_info_clone()
  */
@@ -121,6 +144,48 @@ int media_info_clone(media_info_h *dst, media_info_h src);
  */
 int media_info_get_media_count_from_db(filter_h filter, int *media_count);
 
+/**
+ * @brief Computes an aggregate of a numeric field over the media info for the passed @a filter, in the media database.
+ * @details The aggregate is computed by a single query, without reading the media info.
+ * The @a field is one of #MEDIA_SIZE, #MEDIA_DURATION, #MEDIA_BITRATE, #MEDIA_WIDTH, #MEDIA_HEIGHT, #MEDIA_RATING and #MEDIA_PLAYED_COUNT.
+ * If NULL is passed to the @a filter, no filtering is applied. The offset and count of the @a filter apply before the aggregate.
+ * @remarks Media without a value of @a field are left out. If no media has a value, @a result is 0.
+ * @param[in] filter The handle to filter
+ * @param[in] field The field to aggregate
+ * @param[in] op The aggregate operation
+ * @param[out] result The aggregate
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_DB_FAILED DB operation failed
+ * @pre This function requires opened connection to content service by media_content_connect().
+ * @see media_content_connect()
+ * @see #media_content_aggregate_e
+ *
+ */
+int media_info_get_aggregate_from_db(filter_h filter, const char *field, media_content_aggregate_e op, double *result);
+
+/**
+ * @brief Iterates through the storage usage of the media for the passed @a filter, in the media database.
+ * @details The media are counted and their sizes summed per storage, media type and MIME type, in a single query.
+ * If NULL is passed to the @a filter, the whole library is counted. Then, if media_content_enable_usage_cache() was called,
+ * the rows are kept in memory and read again only once the media table has changed.
+ * @param[in] filter The handle to filter
+ * @param[in] callback The callback function to invoke
+ * @param[in] user_data The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #MEDIA_CONTENT_ERROR_DB_FAILED DB operation failed
+ * @pre This function requires opened connection to content service by media_content_connect().
+ * @post This function invokes media_content_usage_cb().
+ * @see media_content_connect()
+ * @see media_content_enable_usage_cache()
+ *
+ */
+int media_info_foreach_usage_from_db(filter_h filter, media_content_usage_cb callback, void *user_data);
+
 /**
  * @brief Iterates through media info from the media database.
  * @details This function gets all media info handles meeting the given @a filter. The @a callback function will be invoked for every retrieved media info.
@@ -141,6 +206,84 @@ int media_info_get_media_count_from_db(filter_h filter, int *media_count);
  */
 int media_info_foreach_media_from_db(filter_h filter, media_info_cb callback, void *user_data);
 
+/**
+ * @brief Iterates through media info from the media database, several at a time.
+ * @details This function gets all media info handles meeting the given @a filter, like media_info_foreach_media_from_db().
+ * The @a callback function will be invoked with up to @a batch_size retrieved media info at a time, so that the caller
+ * pays its own per call overhead once per batch.
+ * If NULL is passed to the @a filter, no filtering is applied.
+ * @param[in] filter The handle to media info filter
+ * @param[in] batch_size The maximum number of media info per call of @a callback, 0 for the default
+ * @param[in] callback The callback function to invoke
+ * @param[in] user_data The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_OUT_OF_MEMORY Out of memory
+ * @pre This function requires opened connection to content service by media_content_connect().
+ * @post This function invokes media_info_batch_cb().
+ * @see media_content_connect()
+ * @see #media_info_batch_cb
+ * @see media_info_foreach_media_from_db()
+ *
+ */
+int media_info_foreach_media_batch_from_db(filter_h filter, int batch_size, media_info_batch_cb callback, void *user_data);
+
+/**
+ * @brief Reads the size, type, added time and path of media from the media database into arrays.
+ * @details This function reads the media meeting the given @a filter straight into the arrays of @a columns, without making
+ * a media info handle for each of them. The @a callback function will be invoked each time the arrays are full, and once
+ * more with the last rows, so a whole library can be read with arrays of any size.
+ * If NULL is passed to the @a filter, no filtering is applied. The projection of the @a filter is not used.
+ * @remarks Arrays of @a columns which are NULL are not read. If @a path_offset is not NULL, @a path and @a path_capacity must be set,
+ * and @a path_capacity must be larger than the longest path.
+ * @param[in] filter The handle to media info filter
+ * @param[in] columns The arrays to fill, with @a capacity set
+ * @param[in] callback The callback function to invoke
+ * @param[in] user_data The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter, or a path is longer than @a path_capacity
+ * @retval #MEDIA_CONTENT_ERROR_DB_FAILED DB operation failed
+ * @pre This function requires opened connection to content service by media_content_connect().
+ * @post This function invokes media_info_columns_cb().
+ * @see media_content_connect()
+ * @see #media_info_columns_cb
+ *
+ */
+int media_info_foreach_columns_from_db(filter_h filter, media_info_columns_s *columns, media_info_columns_cb callback, void *user_data);
+
+/**
+ * @brief Iterates through media info from the media database without blocking the caller.
+ * @details This function runs the query of media_info_foreach_media_from_db() on a worker thread of the library, which reads
+ * the database with its own connection. The media info are handed to @a callback in batches of up to @a batch_size handles,
+ * and @a completed_cb is called after the last batch. Both are called in the thread which runs @a context.
+ * If NULL is passed to the @a filter, no filtering is applied.
+ * @remarks The @a filter is copied, so it can be destroyed once this function returns.\n
+ * If NULL is passed to the @a context, the global default main context is used.\n
+ * If @a callback returns false, the remaining rows are skipped and @a completed_cb is called with #MEDIA_CONTENT_ERROR_NONE.
+ * @param[in] filter The handle to media info filter
+ * @param[in] batch_size The maximum number of media info per call of @a callback, 0 for the default
+ * @param[in] context The main context to call @a callback and @a completed_cb in
+ * @param[in] callback The callback function to invoke for every batch
+ * @param[in] completed_cb The callback function to invoke when the request is finished, can be NULL
+ * @param[in] user_data The user data to be passed to the callback functions
+ * @param[out] request_id The ID of the request, to cancel it with media_content_cancel_request(), can be NULL
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_OPERATION The worker thread can not be started
+ * @pre This function requires opened connection to content service by media_content_connect().
+ * @post This function invokes media_info_batch_cb() and media_content_request_completed_cb().
+ * @see media_content_connect()
+ * @see media_info_foreach_media_from_db()
+ * @see media_content_cancel_request()
+ *
+ */
+int media_info_foreach_media_from_db_async(filter_h filter, int batch_size, GMainContext *context, media_info_batch_cb callback,
+	media_content_request_completed_cb completed_cb, void *user_data, unsigned int *request_id);
+
 /**
  * @brief Gets the number of media tag for the passed @a filter in the given @a media ID from the media database.
  *
@@ -220,6 +363,7 @@ int media_info_foreach_bookmark_from_db (const char *media_id, filter_h filter,
  * @return 0 on success, otherwise a negative error value.
  * @retval #MEDIA_CONTENT_ERROR_NONE Successful
  * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_NOT_LOADED The image meta was not loaded, see media_filter_set_projection()
  * @see image_meta_destroy()
  */
 int media_info_get_image(media_info_h media, image_meta_h *image);
@@ -236,6 +380,7 @@ int media_info_get_image(media_info_h media, image_meta_h *image);
  * @retval #MEDIA_CONTENT_ERROR_NONE Successful
  * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
  * @retval #MEDIA_CONTENT_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #MEDIA_CONTENT_ERROR_NOT_LOADED The audio and video meta was not loaded, see media_filter_set_projection()
  * @see video_meta_destroy()
  *
  */
@@ -253,6 +398,7 @@ int media_info_get_video(media_info_h media, video_meta_h *video);
  * @retval #MEDIA_CONTENT_ERROR_NONE Successful
  * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
  * @retval #MEDIA_CONTENT_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #MEDIA_CONTENT_ERROR_NOT_LOADED The audio and video meta was not loaded, see media_filter_set_projection()
  * @see audio_meta_destroy()
  */
 int media_info_get_audio(media_info_h media, audio_meta_h *audio);
@@ -400,6 +546,7 @@ int media_info_get_description(media_info_h media, char **description);
  * @return 0 on success, otherwise a negative error value.
  * @retval #MEDIA_CONTENT_ERROR_NONE Successful
  * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_NOT_LOADED The location was not loaded, see media_filter_set_projection()
  *
  */
 int media_info_get_longitude(media_info_h media, double* longitude);
@@ -412,6 +559,7 @@ int media_info_get_longitude(media_info_h media, double* longitude);
  * @return 0 on success, otherwise a negative error value.
  * @retval #MEDIA_CONTENT_ERROR_NONE Successful
  * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_NOT_LOADED The location was not loaded, see media_filter_set_projection()
  *
  */
 int media_info_get_latitude(media_info_h media, double* latitude);
@@ -424,6 +572,7 @@ int media_info_get_latitude(media_info_h media, double* latitude);
  * @return 0 on success, otherwise a negative error value.
  * @retval #MEDIA_CONTENT_ERROR_NONE Successful
  * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_NOT_LOADED The location was not loaded, see media_filter_set_projection()
  *
  */
 int media_info_get_altitude(media_info_h media, double* altitude);
@@ -639,6 +788,7 @@ int media_info_set_description(media_info_h media, const char *description);
  * @retval #MEDIA_CONTENT_ERROR_NONE Successful
  * @retval #MEDIA_CONTENT_ERROR_OUT_OF_MEMORY Out of memory
  * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_NOT_LOADED The location was not loaded, see media_filter_set_projection()
  * @post media_info_update_to_db()
  *
  */
@@ -653,6 +803,7 @@ int media_info_set_longitude(media_info_h media, double longitude);
  * @retval #MEDIA_CONTENT_ERROR_NONE Successful
  * @retval #MEDIA_CONTENT_ERROR_OUT_OF_MEMORY Out of memory
  * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_NOT_LOADED The location was not loaded, see media_filter_set_projection()
  * @post media_info_update_to_db()
  *
  */
@@ -667,6 +818,7 @@ int media_info_set_latitude(media_info_h media, double latitude);
  * @retval #MEDIA_CONTENT_ERROR_NONE Successful
  * @retval #MEDIA_CONTENT_ERROR_OUT_OF_MEMORY Out of memory
  * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_NOT_LOADED The location was not loaded, see media_filter_set_projection()
  * @post media_info_update_to_db()
  *
  */
@@ -24,6 +24,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <glib.h>
+#include <pthread.h>
 #include <media-svc.h>
 #include <media_content_type.h>
 #include <dlog.h>
@@ -42,7 +43,7 @@ extern "C" {
 #define SAFE_STRLCAT(dst, src, n)	g_strlcat(dst, src, n);
 #define SAFE_FREE(src)		{if(src) {free(src); src = NULL;}}
 #define STRING_VALID(str)		((str != NULL && strlen(str) > 0) ? TRUE : FALSE)
-#define SQLITE3_FINALIZE(x)	{if(x != NULL) {sqlite3_finalize(x);}}
+#define SQLITE3_FINALIZE(x)	{if(x != NULL) {_content_query_finalize(x); x = NULL;}}
 
 #define MEDIA_CONTENT_PATH_PHONE 	"/opt/media" 	/**< File path prefix of files stored in phone */
 #define MEDIA_CONTENT_PATH_MMC 		"/mnt/mmc"		/**< File path prefix of files stored in mmc card */
@@ -53,6 +54,13 @@ extern "C" {
 #define MAX_KEYWORD_SIZE 2048
 #define COLLATE_STR_SIZE 32
 #define MEDIA_CONTENT_UUID_SIZE	36
+#define MEDIA_CONTENT_STMT_CACHE_SIZE	32
+#define MEDIA_FILTER_COMPILED_SLOT	2
+#define MEDIA_CONTENT_PENDING_ITEM_SIZE	8	/* initial size of the pending change log of a tag or playlist */
+#define MEDIA_INFO_INSERT_BATCH_SIZE	100	/* files registered and read back per chunk, below the bind limit of sqlite */
+#define MEDIA_CURSOR_DEFAULT_PREFETCH	32	/* rows per page of a media cursor if no prefetch count is given */
+#define MEDIA_INFO_DEFAULT_BATCH_SIZE	64	/* media per call of a media_info_batch_cb if no batch size is given */
+#define MEDIA_CONTENT_ARENA_BLOCK_SIZE	(8 * 1024)
 
 typedef enum {
 	MEDIA_CONTENT_TYPE = 0,
@@ -72,6 +80,7 @@ typedef enum {
 	MEDIA_TAG_ADD,
 	MEDIA_TAG_REMOVE,
 	MEDIA_TAG_UPDATE_TAG_NAME,
+	MEDIA_TAG_FUNCTION_MAX,
 } tag_function_e;
 
 typedef enum {
@@ -79,6 +88,7 @@ typedef enum {
 	MEDIA_PLAYLIST_REMOVE,
 	MEDIA_PLAYLIST_UPDATE_PLAYLIST_NAME,
 	MEDIA_PLAYLIST_UPDATE_PLAY_ORDER,
+	MEDIA_PLAYLIST_FUNCTION_MAX,
 } playlist_function_e;
 
 typedef enum {
@@ -92,6 +102,14 @@ typedef enum {
 	MEDIA_GROUP_BOOKMARK_BY_MEDIA_ID,
 } group_list_e;
 
+typedef struct
+{
+	unsigned int attr_id;		// attribute map the strings below were translated with, 0 if empty
+	char *condition;			// translated condition including COLLATE, NULL if none
+	char *order;				// translated ORDER BY clause, NULL if none
+	char *seek_column;			// db field of the order if it is a single one, NULL otherwise
+}filter_compiled_s;
+
 typedef struct _filter_s
 {
 	char *condition;
@@ -101,6 +119,12 @@ typedef struct _filter_s
 	media_content_collation_e order_collate_type;
 	int offset;
 	int count;
+	int field_groups;			// media_content_field_group_e bits loaded by foreach
+	filter_compiled_s compiled[MEDIA_FILTER_COMPILED_SLOT];	// one per attribute map, cleared on set_condition/set_order
+	bool seek;					// continuation token set, media lists seek past it instead of using offset
+	char *seek_media_id;		// media_uuid of the last row of the previous page, NULL for the first page
+	char *seek_key;				// order key of that row, NULL if it was NULL
+	char *seek_last_token;		// token of the last row listed with the continuation token, NULL if none
 }filter_s;
 
 typedef struct
@@ -112,10 +136,20 @@ typedef struct
 	media_content_storage_e storage_type;
 }media_folder_s;
 
+typedef struct
+{
+	char *media_id;		// media_uuid
+	int function;			// Add, remove, modify
+	char *tag_name;		// tag_name
+}media_tag_item_s;
+
 typedef struct
 {
 	int tag_id;
 	char *name;
+	media_tag_item_s *items;		// pending changes, applied in order by media_tag_update_to_db()
+	int item_count;
+	int item_size;
 }media_tag_s;
 
 typedef struct
@@ -134,10 +168,22 @@ typedef struct
 	char *album_art_path;
 }media_album_s;
 
+typedef struct
+{
+	char *media_id;		// media_uuid
+	int function;			// Add, remove, modify
+	char *playlist_name;	// playlist_name
+	int playlist_member_id;	// playlist unique id of media. Same content which has same media_id can be added to Playlist
+	int play_order;		//play_order
+}media_playlist_item_s;
+
 typedef struct
 {
 	int playlist_id;	//playlist id
 	char *name;		// playlist name
+	media_playlist_item_s *items;	// pending changes, applied in order by media_playlist_update_to_db()
+	int item_count;
+	int item_size;
 }media_playlist_s;
 
 typedef struct
@@ -191,6 +237,18 @@ typedef struct
 	int played_position;
 }audio_meta_s;
 
+typedef struct _content_arena_block_s
+{
+	struct _content_arena_block_s *next;
+	size_t size;				// usable bytes after the header
+	size_t used;
+}content_arena_block_s;
+
+typedef struct
+{
+	content_arena_block_s *head;	// block being carved, older blocks follow
+}content_arena_s;
+
 typedef struct
 {
 	char *media_id;				//image id, audio id, video id
@@ -220,8 +278,22 @@ typedef struct
 	image_meta_s *image_meta;
 	video_meta_s *video_meta;
 	audio_meta_s *audio_meta;
+	int loaded_fields;			// media_content_field_group_e bits read from db
+	content_arena_s *arena;		// not NULL while the handle is borrowed by a foreach callback
 }media_info_s;
 
+typedef struct
+{
+	sqlite3_stmt *stmt;			// not cached, NULL once every row is read
+	int field_groups;			// media_content_field_group_e bits of the filter
+	int prefetch_count;		// rows read per page
+	media_info_s **page;		// rows of the current page, carved from arena
+	int page_count;
+	int position;				// current row in page, -1 before the first media_cursor_next()
+	content_arena_s arena;
+	pthread_mutex_t mutex;		// a cursor may be handed over to another thread
+}media_cursor_s;
+
 typedef struct
 {
 	char *name;
@@ -242,25 +314,10 @@ typedef struct
 	char *name;
 }media_year_s;
 
-typedef struct
-{
-	char *media_id;		// media_uuid
-	int function;			// Add, remove, modify
-	char *tag_name;		// tag_name
-}media_tag_item_s;
-
-typedef struct
-{
-	char *media_id;		// media_uuid
-	int function;			// Add, remove, modify
-	char *playlist_name;	// playlist_name
-	int playlist_member_id;	// playlist unique id of media. Same content which has same media_id can be added to Playlist
-	int play_order;		//play_order
-}media_playlist_item_s;
-
 typedef struct _attribute_map_s
 {
 	GHashTable *attr_map;
+	unsigned int attr_id;		// unique per created map, used to key compiled filters
 }attribute_s;
 
 typedef struct
@@ -272,6 +329,46 @@ typedef struct
 
 typedef struct attribute_s *attribute_h;
 
+typedef struct
+{
+	char *query;			// normalized query, key of query_map
+	sqlite3_stmt *stmt;
+	bool in_use;			// handed out and not released yet
+	GList *link;			// node in lru_list
+}stmt_cache_item_s;
+
+typedef struct _stmt_cache_s
+{
+	sqlite3 *db;
+	int capacity;
+	GHashTable *query_map;	// normalized query -> stmt_cache_item_s
+	GHashTable *stmt_map;		// sqlite3_stmt -> stmt_cache_item_s
+	GList *lru_list;			// most recently used first
+	unsigned int hit_count;
+	unsigned int miss_count;
+}stmt_cache_s;
+
+typedef struct stmt_cache_s *stmt_cache_h;
+
+typedef struct
+{
+	int type;				// SQLITE_INTEGER or SQLITE_TEXT
+	int int_value;
+	const char *text_value;	// not copied, must stay valid until the query is prepared
+}query_bind_s;
+
+typedef struct
+{
+	char *str;
+	int len;
+	int size;
+	bool borrowed;			// str is the per-thread buffer
+	int error;				// first error, later appends are ignored
+	query_bind_s *binds;
+	int bind_count;
+	int bind_size;
+}query_builder_s;
+
 /* DB Table */
 #define DB_TABLE_MEDIA			"media"
 #define DB_TABLE_FOLDER		"folder"
@@ -406,6 +503,66 @@ typedef struct attribute_s *attribute_h;
 //#define SELECT_PLAYLIST_LIST			SELECT_EMPTY_PLAYLIST" UNION "SELECT_PLAYLIST_FROM_PLAYLIST_PLAYLISTMAP_MEDIA_JOIN
 #define SELECT_TAG_LIST				"SELECT DISTINCT tag_id, name FROM "DB_VIEW_TAG" WHERE 1 "
 #define SELECT_PLAYLIST_LIST		"SELECT DISTINCT playlist_id, name FROM "DB_VIEW_PLAYLIST" WHERE 1 "
+
+/* Get Group List with the media count of every group, grouped by the *_GROUP_BY column */
+#define SELECT_ALBUM_LIST_WITH_COUNT		"SELECT a.album_id, a.name, a.artist, a.album_art, COUNT(*) FROM "ALBUM_MEDIA_JOIN
+#define SELECT_MEDIA_GROUP_LIST_WITH_COUNT	"SELECT %s, COUNT(*) FROM "DB_TABLE_MEDIA" WHERE validity=1 "
+#define SELECT_FOLDER_LIST_WITH_COUNT		"SELECT f.folder_uuid, f.path, f.name, f.storage_type, f.modified_time, COUNT(*) FROM "FOLDER_MEDIA_JOIN
+#define SELECT_TAG_LIST_WITH_COUNT			"SELECT tag_id, name, SUM(media_count>0) FROM "DB_VIEW_TAG" WHERE 1 "
+#define SELECT_PLAYLIST_LIST_WITH_COUNT	"SELECT playlist_id, name, SUM(media_count>0) FROM "DB_VIEW_PLAYLIST" WHERE 1 "
+#define ALBUM_GROUP_BY					"a.album_id"
+#define FOLDER_GROUP_BY					"f.folder_uuid"
+#define TAG_GROUP_BY						"tag_id"
+#define PLAYLIST_GROUP_BY					"playlist_id"
+
+/* Group summary, kept up to date by triggers on the media table once enabled */
+#define DB_TABLE_GROUP_SUMMARY				"media_group_summary"
+#define GROUP_SUMMARY_INSERT_TRIGGER		"media_group_summary_insert"
+#define GROUP_SUMMARY_UPDATE_TRIGGER		"media_group_summary_update"
+#define GROUP_SUMMARY_DELETE_TRIGGER		"media_group_summary_delete"
+#define GROUP_SUMMARY_ALBUM				-1		// group_type of the rows counted by album_id
+#define CREATE_GROUP_SUMMARY_TABLE		"CREATE TABLE IF NOT EXISTS "DB_TABLE_GROUP_SUMMARY" (group_type INTEGER NOT NULL, value TEXT, \
+											media_count INTEGER NOT NULL DEFAULT 0, total_size INTEGER NOT NULL DEFAULT 0, total_duration INTEGER NOT NULL DEFAULT 0); \
+											CREATE INDEX IF NOT EXISTS "DB_TABLE_GROUP_SUMMARY"_idx ON "DB_TABLE_GROUP_SUMMARY" (group_type, value);"
+#define DROP_GROUP_SUMMARY				"DROP TRIGGER IF EXISTS "GROUP_SUMMARY_INSERT_TRIGGER"; DROP TRIGGER IF EXISTS "GROUP_SUMMARY_UPDATE_TRIGGER"; \
+											DROP TRIGGER IF EXISTS "GROUP_SUMMARY_DELETE_TRIGGER"; DROP TABLE IF EXISTS "DB_TABLE_GROUP_SUMMARY";"
+#define SELECT_GROUP_SUMMARY_OBJECT_COUNT	"SELECT COUNT(*) FROM sqlite_master WHERE (type='table' AND name='"DB_TABLE_GROUP_SUMMARY"') OR (type='trigger' AND name IN \
+											('"GROUP_SUMMARY_INSERT_TRIGGER"', '"GROUP_SUMMARY_UPDATE_TRIGGER"', '"GROUP_SUMMARY_DELETE_TRIGGER"'))"
+#define GROUP_SUMMARY_OBJECT_COUNT		4
+#define SELECT_GROUP_SUMMARY_COUNT		"SELECT COUNT(*) FROM "DB_TABLE_GROUP_SUMMARY" WHERE group_type=?"
+#define SELECT_GROUP_SUMMARY_ALBUM_COUNT	"SELECT COUNT(*) FROM "DB_TABLE_GROUP_SUMMARY" AS s INNER JOIN "DB_TABLE_ALBUM" AS a ON (a.album_id = s.value) WHERE s.group_type=?"
+#define SELECT_GROUP_SUMMARY_MEDIA_COUNT	"SELECT media_count FROM "DB_TABLE_GROUP_SUMMARY" WHERE group_type=? AND value IS ?"
+/* In the order of the GROUP BY list of the media table, which is what it stands in for */
+#define SELECT_GROUP_SUMMARY_LIST			"SELECT value, media_count FROM "DB_TABLE_GROUP_SUMMARY" WHERE group_type=? ORDER BY value"
+
+/* Storage usage, and the version of the media rows it is made of, bumped by triggers once the usage cache is enabled */
+#define SELECT_MEDIA_USAGE				"SELECT storage_type, media_type, mime_type, COUNT(*), IFNULL(SUM(size), 0) FROM "DB_TABLE_MEDIA" WHERE validity=1"
+#define MEDIA_USAGE_GROUP_BY				"storage_type, media_type, mime_type"
+#define DB_TABLE_USAGE_VERSION			"media_usage_version"
+#define USAGE_VERSION_INSERT_TRIGGER		"media_usage_version_insert"
+#define USAGE_VERSION_UPDATE_TRIGGER		"media_usage_version_update"
+#define USAGE_VERSION_DELETE_TRIGGER		"media_usage_version_delete"
+#define USAGE_VERSION_BUMP				" BEGIN UPDATE "DB_TABLE_USAGE_VERSION" SET version=version+1; END;"
+#define CREATE_USAGE_VERSION				"CREATE TABLE IF NOT EXISTS "DB_TABLE_USAGE_VERSION" (version INTEGER NOT NULL); \
+											INSERT INTO "DB_TABLE_USAGE_VERSION" (version) SELECT 0 WHERE NOT EXISTS (SELECT 1 FROM "DB_TABLE_USAGE_VERSION"); \
+											CREATE TRIGGER IF NOT EXISTS "USAGE_VERSION_INSERT_TRIGGER" AFTER INSERT ON "DB_TABLE_MEDIA USAGE_VERSION_BUMP" \
+											CREATE TRIGGER IF NOT EXISTS "USAGE_VERSION_UPDATE_TRIGGER" AFTER UPDATE OF validity, storage_type, media_type, mime_type, size ON "DB_TABLE_MEDIA USAGE_VERSION_BUMP" \
+											CREATE TRIGGER IF NOT EXISTS "USAGE_VERSION_DELETE_TRIGGER" AFTER DELETE ON "DB_TABLE_MEDIA USAGE_VERSION_BUMP
+#define DROP_USAGE_VERSION				"DROP TRIGGER IF EXISTS "USAGE_VERSION_INSERT_TRIGGER"; DROP TRIGGER IF EXISTS "USAGE_VERSION_UPDATE_TRIGGER"; \
+											DROP TRIGGER IF EXISTS "USAGE_VERSION_DELETE_TRIGGER"; DROP TABLE IF EXISTS "DB_TABLE_USAGE_VERSION";"
+#define SELECT_USAGE_VERSION_OBJECT_COUNT	"SELECT COUNT(*) FROM sqlite_master WHERE (type='table' AND name='"DB_TABLE_USAGE_VERSION"') OR (type='trigger' AND name IN \
+											('"USAGE_VERSION_INSERT_TRIGGER"', '"USAGE_VERSION_UPDATE_TRIGGER"', '"USAGE_VERSION_DELETE_TRIGGER"'))"
+#define USAGE_VERSION_OBJECT_COUNT		4
+#define SELECT_USAGE_VERSION				"SELECT version FROM "DB_TABLE_USAGE_VERSION
+
+/* Indexes for the filters and orders of the common media lists. media_content_create_indexes() creates them on demand */
+#define CREATE_MEDIA_FILTER_INDEXES		"CREATE INDEX IF NOT EXISTS media_type_added_time_idx ON "DB_TABLE_MEDIA" (validity, media_type, added_time); \
+											CREATE INDEX IF NOT EXISTS media_type_modified_time_idx ON "DB_TABLE_MEDIA" (validity, media_type, modified_time); \
+											CREATE INDEX IF NOT EXISTS media_folder_file_name_idx ON "DB_TABLE_MEDIA" (validity, folder_uuid, file_name); \
+											CREATE INDEX IF NOT EXISTS media_artist_idx ON "DB_TABLE_MEDIA" (validity, artist); \
+											CREATE INDEX IF NOT EXISTS media_album_id_idx ON "DB_TABLE_MEDIA" (validity, album_id);"
+#define QUERY_PLAN_PREFIX					"EXPLAIN QUERY PLAN "
+
 #define SELECT_BOOKMARK_LIST		"SELECT DISTINCT b.bookmark_id, b.media_uuid, b.marked_time, b.thumbnail_path FROM "BOOKMARK_MEDIA_JOIN
 
 /* Get Group Count */
@@ -432,7 +589,7 @@ typedef struct attribute_s *attribute_h;
 #define SELECT_MEDIA_COUNT_FROM_YEAR				"SELECT COUNT(*) FROM "DB_TABLE_MEDIA" WHERE validity=1 AND year='%q'"
 #define SELECT_MEDIA_COUNT_FROM_GROUP			"SELECT COUNT(*) FROM ("SELECT_MEDIA_FROM_GROUP		//to apply limit condition.
 #define SELECT_MEDIA_COUNT_FROM_GROUP_NULL		"SELECT COUNT(*) FROM ("SELECT_MEDIA_FROM_GROUP_NULL	//to apply limit condition.
-#define SELECT_MEDIA_COUNT_FROM_FOLDER			"SELECT COUNT(*) FROM "DB_TABLE_MEDIA" WHERE validity=1 AND folder_uuid='%q'"
+#define SELECT_MEDIA_COUNT_FROM_FOLDER			"SELECT COUNT(*) FROM "DB_TABLE_MEDIA" WHERE validity=1 AND folder_uuid=?"
 //#define SELECT_MEDIA_COUNT_FROM_TAG				"SELECT COUNT(*) FROM "DB_TABLE_TAG_MAP" WHERE tag_id=%d AND media_uuid IN 													(SELECT media_uuid FROM "DB_TABLE_MEDIA" WHERE validity=1"
 //#define SELECT_MEDIA_COUNT_FROM_PLAYLIST		"SELECT COUNT(*) FROM "DB_TABLE_PLAYLIST_MAP" WHERE playlist_id=%d AND media_uuid IN  													(SELECT media_uuid FROM "DB_TABLE_MEDIA" WHERE validity=1"
 #define SELECT_MEDIA_COUNT_FROM_TAG				"SELECT COUNT(*) FROM "DB_VIEW_TAG" WHERE (tag_id=%d AND media_count>0) "
@@ -448,8 +605,9 @@ typedef struct attribute_s *attribute_h;
 
 /* Tag info*/
 #define INSERT_TAG_TO_TAG						"INSERT INTO "DB_TABLE_TAG" (name) VALUES (%Q)"
-#define REMOVE_TAG_ITEM_FROM_TAG_MAP		"DELETE FROM "DB_TABLE_TAG_MAP" WHERE tag_id=%d AND media_uuid='%q'"
-#define UPDATE_TAG_NAME_FROM_TAG			"UPDATE "DB_TABLE_TAG" SET name='%q' WHERE tag_id=%d"
+#define REMOVE_TAG_ITEM_FROM_TAG_MAP		"DELETE FROM "DB_TABLE_TAG_MAP" WHERE tag_id=? AND media_uuid=?"
+#define INSERT_TAG_ITEM_TO_TAG_MAP			"INSERT INTO "DB_TABLE_TAG_MAP" (tag_id, media_uuid) VALUES (?, ?)"
+#define UPDATE_TAG_NAME_FROM_TAG			"UPDATE "DB_TABLE_TAG" SET name=? WHERE tag_id=?"
 //#define SELECT_TAG_COUNT_BY_MEDIA_ID			"SELECT COUNT(*) FROM "DB_TABLE_TAG" WHERE tag_id IN (SELECT tag_id FROM "DB_TABLE_TAG_MAP" WHERE media_uuid = '%q')"
 //#define SELECT_TAG_LIST_BY_MEDIA_ID				"SELECT * FROM "DB_TABLE_TAG" WHERE tag_id IN (SELECT tag_id FROM "DB_TABLE_TAG_MAP" WHERE media_uuid = '%s')"
 #define SELECT_TAG_COUNT_BY_MEDIA_ID			"SELECT COUNT(*) FROM "DB_VIEW_TAG" WHERE media_uuid = '%q'"
@@ -457,17 +615,24 @@ typedef struct attribute_s *attribute_h;
 
 /* Playlist Info */
 #define INSERT_PLAYLIST_TO_PLAYLIST						"INSERT INTO "DB_TABLE_PLAYLIST" (name) VALUES (%Q)"
-#define UPDATE_PLAYLIST_NAME_FROM_PLAYLIST			"UPDATE "DB_TABLE_PLAYLIST" SET name='%q' WHERE playlist_id=%d"
+#define UPDATE_PLAYLIST_NAME_FROM_PLAYLIST			"UPDATE "DB_TABLE_PLAYLIST" SET name=? WHERE playlist_id=?"
 #define SELECT_PLAYLIST_ID_FROM_PLAYLIST				"SELECT playlist_id FROM "DB_TABLE_PLAYLIST" WHERE name='%q'"
 //#define SELECT_PLAYLIST_ITEM_ID_FROM_PLAYLIST_MAP		"SELECT pm._id, pm.media_uuid FROM "PLAYLISTMAP_MEDIA_JOIN" AND pm.playlist_id=%d"
 #define SELECT_PLAYLIST_ITEM_ID_FROM_PLAYLIST_VIEW		"SELECT pm_id, media_uuid FROM "DB_VIEW_PLAYLIST" WHERE playlist_id=%d "
+/* Appended after the projected MEDIA_INFO_ITEM columns, so the member id follows the media columns.
+ * The join is wrapped so that filter conditions can keep using the unqualified media column names. */
+#define FROM_PLAYLIST_MEMBER_MEDIA		", pm_id FROM (SELECT pm._id AS pm_id, pm.play_order AS play_order, m.* FROM "DB_TABLE_PLAYLIST_MAP" AS pm INNER JOIN "DB_TABLE_MEDIA" AS m \
+															ON (pm.media_uuid = m.media_uuid) WHERE pm.playlist_id=%d AND m.validity=1) WHERE 1"
+#define PLAYLIST_MEMBER_ID_COLUMN		44
+#define PLAYLIST_MEMBER_DEFAULT_ORDER	DB_FIELD_PLAYLIST_MEMBER_ORDER", pm_id"
 
 //#define SELECT_PLAY_ORDER_FROM_PLAYLIST_MAP			"SELECT play_order FROM "DB_TABLE_PLAYLIST_MAP" WHERE playlist_id=%d and _id=%d"
 #define SELECT_PLAY_ORDER_FROM_PLAYLIST_VIEW			"SELECT play_order FROM "DB_VIEW_PLAYLIST" WHERE playlist_id=%d and pm_id=%d"
 //#define SELECT_MAX_PLAY_ORDER_FROM_PLAYLIST_MAP	"SELECT MAX(play_order) FROM "DB_TABLE_PLAYLIST_MAP" WHERE playlist_id=%d"
 #define SELECT_MAX_PLAY_ORDER_FROM_PLAYLIST_VIEW	"SELECT MAX(play_order) FROM "DB_VIEW_PLAYLIST" WHERE playlist_id=%d"
-#define REMOVE_PLAYLIST_ITEM_FROM_PLAYLIST_MAP		"DELETE FROM "DB_TABLE_PLAYLIST_MAP" WHERE playlist_id=%d AND _id=%d"
-#define UPDATE_PLAYLIST_ORDER_FROM_PLAYLIST_MAP		"UPDATE "DB_TABLE_PLAYLIST_MAP" SET play_order=%d WHERE playlist_id=%d AND _id=%d"
+#define INSERT_PLAYLIST_ITEM_TO_PLAYLIST_MAP		"INSERT INTO "DB_TABLE_PLAYLIST_MAP" (playlist_id, media_uuid, play_order) VALUES (?, ?, ?)"
+#define REMOVE_PLAYLIST_ITEM_FROM_PLAYLIST_MAP		"DELETE FROM "DB_TABLE_PLAYLIST_MAP" WHERE playlist_id=? AND _id=?"
+#define UPDATE_PLAYLIST_ORDER_FROM_PLAYLIST_MAP		"UPDATE "DB_TABLE_PLAYLIST_MAP" SET play_order=? WHERE playlist_id=? AND _id=?"
 
 /* Bookmark */
 #define INSERT_BOOKMARK_TO_BOOKMARK	"INSERT INTO "DB_TABLE_BOOKMARK" (media_uuid, marked_time, thumbnail_path) VALUES ('%q', '%d', %Q)"
@@ -483,28 +648,53 @@ typedef struct attribute_s *attribute_h;
 #define SELECT_VIDEO_FROM_MEDIA	"SELECT "MEDIA_AV_META", width, height FROM "DB_TABLE_MEDIA" WHERE media_uuid='%s'"
 
 /* Update Meta*/
-#define UPDATE_AV_META_FROM_MEDIA	"UPDATE "DB_TABLE_MEDIA" SET played_count=%d, last_played_time=%d, last_played_position=%d WHERE media_uuid='%q'"
+#define UPDATE_AV_META_FROM_MEDIA	"UPDATE "DB_TABLE_MEDIA" SET played_count=?, last_played_time=?, last_played_position=? WHERE media_uuid=?"
 #define UPDATE_IMAGE_META_FROM_MEDIA	"UPDATE "DB_TABLE_MEDIA" SET orientation=%d WHERE media_uuid='%q'"
 
 /* Get Media list of Group */
 //#define MEDIA_INFO_ITEM "media_uuid, path, file_name, media_type, mime_type, size, added_time, modified_time, thumbnail_path, description,
 //							rating, favourite, author, provider, content_name, category, location_tag, age_rating, is_drm, storage_type"
-#define MEDIA_INFO_ITEM "media_uuid, path, file_name, media_type, mime_type, size, added_time, modified_time, thumbnail_path, description, \
-							rating, favourite, author, provider, content_name, category, location_tag, age_rating, keyword, is_drm, storage_type, longitude, latitude, altitude, width, height, datetaken, orientation, title, album, artist, genre, composer, year, recorded_date, copyright, track_num, bitrate, duration, played_count, last_played_time, last_played_position, samplerate, channel"
-
-#define SELECT_MEDIA_ITEM 					"SELECT "MEDIA_INFO_ITEM" FROM "DB_TABLE_MEDIA" WHERE validity=1"
-#define SELECT_MEDIA_FROM_MEDIA			"SELECT "MEDIA_INFO_ITEM" FROM "DB_TABLE_MEDIA" WHERE validity=1 AND media_uuid='%s'"
+#define MEDIA_INFO_ITEM_CORE		"media_uuid, path, file_name, media_type, mime_type, size, added_time, modified_time, thumbnail_path, description, \
+							rating, favourite, author, provider, content_name, category, location_tag, age_rating, keyword, is_drm, storage_type"
+#define MEDIA_INFO_ITEM_LOCATION	"longitude, latitude, altitude"
+#define MEDIA_INFO_ITEM_DIMENSION	"width, height"		//shared by image and video meta
+#define MEDIA_INFO_ITEM_IMAGE		"datetaken, orientation"
+#define MEDIA_INFO_ITEM_AV			"title, album, artist, genre, composer, year, recorded_date, copyright, track_num, bitrate, duration, played_count, last_played_time, last_played_position, samplerate, channel"
+/* Placeholders for groups which are not loaded, so that column indexes stay the same */
+#define MEDIA_INFO_ITEM_LOCATION_NONE	"NULL, NULL, NULL"
+#define MEDIA_INFO_ITEM_DIMENSION_NONE	"NULL, NULL"
+#define MEDIA_INFO_ITEM_IMAGE_NONE		"NULL, NULL"
+#define MEDIA_INFO_ITEM_AV_NONE			"NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL"
+#define MEDIA_INFO_ITEM MEDIA_INFO_ITEM_CORE", "MEDIA_INFO_ITEM_LOCATION", "MEDIA_INFO_ITEM_DIMENSION", "MEDIA_INFO_ITEM_IMAGE", "MEDIA_INFO_ITEM_AV
+/* Columns of media_info_columns_s, in the order of media_columns_e */
+#define MEDIA_INFO_COLUMNS			"size, media_type, added_time, path"
+
+/* FROM clauses of the media list queries, appended after the projected MEDIA_INFO_ITEM columns */
+#define FROM_MEDIA_ITEM					" FROM "DB_TABLE_MEDIA" WHERE validity=1"
+#define FROM_MEDIA_BY_ALBUM				FROM_MEDIA_ITEM" AND album_id=%d"
+#define FROM_MEDIA_BY_GROUP				FROM_MEDIA_ITEM" AND %s='%q'"
+#define FROM_MEDIA_BY_GROUP_NULL			FROM_MEDIA_ITEM" AND %s IS NULL"
+#define FROM_MEDIA_BY_FOLDER				FROM_MEDIA_ITEM" AND folder_uuid=?"
+#define FROM_MEDIA_BY_TAG				" FROM "DB_TABLE_MEDIA" WHERE media_uuid IN (SELECT media_uuid FROM "DB_TABLE_TAG_MAP" WHERE tag_id=%d) AND validity=1"
+#define FROM_MEDIA_BY_PLAYLIST			" FROM "DB_TABLE_MEDIA" WHERE media_uuid IN (SELECT media_uuid FROM "DB_TABLE_PLAYLIST_MAP" WHERE playlist_id=%d) AND validity=1"
+
+#define SELECT_MEDIA_ITEM 					"SELECT "MEDIA_INFO_ITEM FROM_MEDIA_ITEM
+#define SELECT_MEDIA_FROM_MEDIA			"SELECT "MEDIA_INFO_ITEM" FROM "DB_TABLE_MEDIA" WHERE validity=1 AND media_uuid=?"
+#define SELECT_MEDIA_SEEK_KEY				"SELECT %s FROM "DB_TABLE_MEDIA" WHERE media_uuid=?"
+/* Order key of a list with a continuation token, appended after the projected MEDIA_INFO_ITEM columns */
+#define MEDIA_SEEK_KEY_COLUMN			44
 #define SELECT_MEDIA_BY_PATH				"SELECT "MEDIA_INFO_ITEM" FROM "DB_TABLE_MEDIA" WHERE validity=1 AND path='%q'"
-#define SELECT_MEDIA_FROM_ALBUM			"SELECT "MEDIA_INFO_ITEM" FROM "DB_TABLE_MEDIA" WHERE validity=1 AND album_id=%d"
+#define SELECT_MEDIA_BY_PATH_LIST			"SELECT "MEDIA_INFO_ITEM" FROM "DB_TABLE_MEDIA" WHERE validity=1 AND path IN ("
+#define SELECT_MEDIA_FROM_ALBUM			"SELECT "MEDIA_INFO_ITEM FROM_MEDIA_BY_ALBUM
 #define SELECT_MEDIA_FROM_ARTIST			"SELECT "MEDIA_INFO_ITEM" FROM "DB_TABLE_MEDIA" WHERE validity=1 AND artist='%q'"
 #define SELECT_MEDIA_FROM_GENRE			"SELECT "MEDIA_INFO_ITEM" FROM "DB_TABLE_MEDIA" WHERE validity=1 AND genre='%q'"
 #define SELECT_MEDIA_FROM_COMPOSER		"SELECT "MEDIA_INFO_ITEM" FROM "DB_TABLE_MEDIA" WHERE validity=1 AND author='%q'"
 #define SELECT_MEDIA_FROM_YEAR			"SELECT "MEDIA_INFO_ITEM" FROM "DB_TABLE_MEDIA" WHERE validity=1 AND year='%q'"
-#define SELECT_MEDIA_FROM_GROUP			"SELECT "MEDIA_INFO_ITEM" FROM "DB_TABLE_MEDIA" WHERE validity=1 AND %s='%q'"
-#define SELECT_MEDIA_FROM_GROUP_NULL	"SELECT "MEDIA_INFO_ITEM" FROM "DB_TABLE_MEDIA" WHERE validity=1 AND %s IS NULL"
-#define SELECT_MEDIA_FROM_FOLDER			"SELECT "MEDIA_INFO_ITEM" FROM "DB_TABLE_MEDIA" WHERE validity=1 AND folder_uuid='%q'"
-#define SELECT_MEDIA_FROM_TAG				"SELECT "MEDIA_INFO_ITEM" FROM "DB_TABLE_MEDIA" WHERE media_uuid IN (SELECT media_uuid FROM "DB_TABLE_TAG_MAP" WHERE tag_id=%d) AND validity=1"
-#define SELECT_MEDIA_FROM_PLAYLIST		"SELECT "MEDIA_INFO_ITEM" FROM "DB_TABLE_MEDIA" WHERE media_uuid IN (SELECT media_uuid FROM "DB_TABLE_PLAYLIST_MAP" WHERE playlist_id=%d) AND validity=1"
+#define SELECT_MEDIA_FROM_GROUP			"SELECT "MEDIA_INFO_ITEM FROM_MEDIA_BY_GROUP
+#define SELECT_MEDIA_FROM_GROUP_NULL	"SELECT "MEDIA_INFO_ITEM FROM_MEDIA_BY_GROUP_NULL
+#define SELECT_MEDIA_FROM_FOLDER			"SELECT "MEDIA_INFO_ITEM FROM_MEDIA_BY_FOLDER
+#define SELECT_MEDIA_FROM_TAG				"SELECT "MEDIA_INFO_ITEM FROM_MEDIA_BY_TAG
+#define SELECT_MEDIA_FROM_PLAYLIST		"SELECT "MEDIA_INFO_ITEM FROM_MEDIA_BY_PLAYLIST
 
 /* Delete */
 #define DELETE_MEDIA_FROM_MEDIA				"DELETE FROM "DB_TABLE_MEDIA" WHERE media_uuid='%q'"
@@ -519,6 +709,21 @@ typedef struct attribute_s *attribute_h;
  */
 int _content_query_prepare(sqlite3_stmt **stmt, char *select_query, char *condition_query, char *option_query);
 
+/**
+ *@internal
+ */
+int _content_query_prepare_str(sqlite3_stmt **stmt, const char *query);
+
+/**
+ *@internal
+ */
+int _content_query_prepare_writer_str(sqlite3_stmt **stmt, const char *query);
+
+/**
+ *@internal
+ */
+int _content_query_prepare_uncached_str(sqlite3_stmt **stmt, const char *query);
+
 /**
  *@internal
  */
@@ -547,7 +752,153 @@ attribute_h _content_get_alias_attirbute_handle(void);
 /**
  *@internal
  */
-void _media_info_item_get_detail(sqlite3_stmt *stmt, media_info_h media);
+void _content_query_finalize(sqlite3_stmt *stmt);
+
+/**
+ *@internal
+ */
+int _content_query_bind_text(sqlite3_stmt *stmt, int index, const char *value);
+
+/**
+ *@internal
+ */
+int _content_query_bind_int(sqlite3_stmt *stmt, int index, int value);
+
+/**
+ *@internal
+ */
+int _content_query_step(sqlite3_stmt *stmt);
+
+/**
+ *@internal
+ */
+int _content_query_step_done(sqlite3_stmt *stmt);
+
+/**
+ *@internal
+ * Opens a write transaction on the writer connection. Writes of other threads wait until
+ * the calling thread ends it with _content_transaction_commit() or _content_transaction_rollback().
+ */
+int _content_transaction_begin(void);
+
+/**
+ *@internal
+ */
+int _content_transaction_commit(void);
+
+/**
+ *@internal
+ */
+void _content_transaction_rollback(void);
+
+/**
+ *@internal
+ */
+int _content_stmt_prepare(sqlite3 *db, const char *query, sqlite3_stmt **stmt);
+
+/**
+ *@internal
+ */
+int _content_stmt_cache_create(sqlite3 *db, int capacity, stmt_cache_h *cache);
+
+/**
+ *@internal
+ */
+int _content_stmt_cache_destroy(stmt_cache_h cache);
+
+/**
+ *@internal
+ */
+int _content_stmt_cache_prepare(stmt_cache_h cache, const char *query, sqlite3_stmt **stmt);
+
+/**
+ *@internal
+ */
+void _content_stmt_cache_release(stmt_cache_h cache, sqlite3_stmt *stmt);
+
+/**
+ *@internal
+ */
+void _content_stmt_cache_get_stats(stmt_cache_h cache, unsigned int *hit_count, unsigned int *miss_count);
+
+/**
+ *@internal
+ */
+void _content_query_builder_init(query_builder_s *query);
+
+/**
+ *@internal
+ */
+int _content_query_builder_append(query_builder_s *query, const char *str);
+
+/**
+ *@internal
+ */
+int _content_query_builder_appendf(query_builder_s *query, const char *format, ...);
+
+/**
+ *@internal
+ */
+int _content_query_builder_bind_text(query_builder_s *query, const char *value);
+
+/**
+ *@internal
+ */
+int _content_query_builder_bind_int(query_builder_s *query, int value);
+
+/**
+ *@internal
+ */
+int _content_query_builder_prepare(query_builder_s *query, sqlite3_stmt **stmt);
+
+/**
+ *@internal
+ */
+int _content_query_builder_prepare_uncached(query_builder_s *query, sqlite3_stmt **stmt);
+
+/**
+ *@internal
+ */
+void _content_query_builder_release(query_builder_s *query);
+
+/**
+ *@internal
+ * Bump allocator for handles which only live during one foreach callback.
+ * Memory is zeroed, and is given back all at once by _content_arena_reset() or _content_arena_release().
+ */
+void _content_arena_init(content_arena_s *arena);
+
+/**
+ *@internal
+ */
+void *_content_arena_alloc(content_arena_s *arena, size_t size);
+
+/**
+ *@internal
+ */
+char *_content_arena_strdup(content_arena_s *arena, const char *str);
+
+/**
+ *@internal
+ */
+void _content_arena_reset(content_arena_s *arena);
+
+/**
+ *@internal
+ */
+void _content_arena_release(content_arena_s *arena);
+
+/**
+ *@internal
+ * Strings and meta are carved from @a arena when it is not NULL, otherwise they are allocated one by one.
+ */
+void _media_info_item_get_detail(sqlite3_stmt *stmt, media_info_h media, int field_groups, content_arena_s *arena);
+
+/**
+ *@internal
+ * Appends "SELECT <MEDIA_INFO_ITEM>" with the columns of field groups which are not set in the filter replaced by NULL.
+ */
+void _media_info_append_columns(query_builder_s *query, filter_h filter);
 
 /**
  *@internal
@@ -564,21 +915,41 @@ int _media_db_get_media_group_count(media_group_e group, filter_h filter, int *g
  */
 int _media_db_get_media_group(media_group_e group, filter_h filter, media_group_cb callback, void *user_data);
 
+/**
+ *@internal
+ */
+int _media_db_get_media_group_with_count(media_group_e group, filter_h filter, media_group_count_cb callback, void *user_data);
+
 /**
  *@internal
  */
 int _media_db_get_album(filter_h filter, media_album_cb callback, void *user_data);
 
+/**
+ *@internal
+ */
+int _media_db_get_album_with_count(filter_h filter, media_album_count_cb callback, void *user_data);
+
 /**
  *@internal
  */
 int _media_db_get_folder(filter_h filter, media_folder_cb callback, void *user_data);
 
+/**
+ *@internal
+ */
+int _media_db_get_folder_with_count(filter_h filter, media_folder_count_cb callback, void *user_data);
+
 /**
  *@internal
  */
 int _media_db_get_playlist(filter_h filter, media_playlist_cb callback, void *user_data);
 
+/**
+ *@internal
+ */
+int _media_db_get_playlist_with_count(filter_h filter, media_playlist_count_cb callback, void *user_data);
+
 /**
  *@internal
  */
@@ -589,6 +960,74 @@ int _media_db_get_playlist_item(int playlist_id, filter_h filter, playlist_membe
  */
 int _media_db_get_tag(const char *media_id, filter_h filter, media_tag_cb callback, void *user_data);
 
+/**
+ *@internal
+ */
+int _media_db_get_tag_with_count(filter_h filter, media_tag_count_cb callback, void *user_data);
+
+/**
+ *@internal
+ * Checks whether the group summary tables exist, called on connect.
+ */
+void _media_group_summary_load(void);
+
+/**
+ *@internal
+ * true if counts of @a group_type can be read from the group summary with @a filter.
+ */
+bool _media_group_summary_is_usable(int group_type, filter_h filter);
+
+/**
+ *@internal
+ */
+int _media_group_summary_get_group_count(int group_type, int *group_count);
+
+/**
+ *@internal
+ */
+int _media_group_summary_get_media_count(int group_type, const char *value, int *media_count);
+
+/**
+ *@internal
+ */
+int _media_group_summary_foreach(int group_type, media_group_count_cb callback, void *user_data);
+
+/**
+ *@internal
+ * Checks whether the usage version table exists and drops the cached usage, called on connect.
+ */
+void _media_usage_load(void);
+
+/**
+ *@internal
+ */
+void _media_query_stats_load(void);
+
+/**
+ *@internal
+ */
+unsigned long long _media_query_stats_begin(void);
+
+/**
+ *@internal
+ */
+void _media_query_stats_prepared(sqlite3_stmt *stmt, unsigned long long begin);
+
+/**
+ *@internal
+ */
+void _media_query_stats_stepped(sqlite3_stmt *stmt, unsigned long long begin, bool row);
+
+/**
+ *@internal
+ */
+void _media_query_stats_materialized(sqlite3_stmt *stmt);
+
+/**
+ *@internal
+ */
+void _media_query_stats_finish(sqlite3_stmt *stmt);
+
 /**
  *@internal
  */
@@ -614,6 +1053,31 @@ int _media_db_get_group_item_by_id(int group_id, filter_h filter, media_info_cb
  */
 int _media_db_get_group_item(const char *group_name, filter_h filter, media_info_cb callback, void *user_data, group_list_e group_type);
 
+/**
+ *@internal
+ */
+int _media_db_get_group_item_batch(const char *group_name, filter_h filter, int batch_size, media_info_batch_cb callback, void *user_data, group_list_e group_type);
+
+/**
+ *@internal
+ */
+int _media_db_get_media_columns(filter_h filter, media_info_columns_s *columns, media_info_columns_cb callback, void *user_data);
+
+/**
+ *@internal
+ */
+int _media_db_get_media_aggregate(filter_h filter, const char *field, media_content_aggregate_e op, double *result);
+
+/**
+ *@internal
+ */
+int _media_db_open_group_item(const char *group_name, filter_h filter, group_list_e group_type, sqlite3_stmt **stmt);
+
+/**
+ *@internal
+ */
+int _media_db_get_group_item_plan(const char *group_name, filter_h filter, group_list_e group_type, int *plan, char **detail);
+
 /**
  *@internal
  */
@@ -684,25 +1148,161 @@ int _media_filter_attribute_destory(attribute_h attr);
  *
  */
 int _media_filter_attribute_generate(attribute_h attr, char *condition, media_content_collation_e collate_type, char **generated_condition);
-int _media_filter_attribute_option_generate(attribute_h attr, filter_h filter, char **generated_option);
+
+/**
+ * @brief Appends the condition and the ORDER BY/LIMIT clause of the filter to the query.
+ * @details The condition is appended as " AND <condition>". The translated condition and order clause
+ * are compiled once per attribute map and kept on the filter until media_filter_set_condition() or
+ * media_filter_set_order() is called again.
+ * @param[in] attr The handle to media filter attribute
+ * @param[in] filter The handle to media filter, NULL appends nothing
+ * @param[in] query The query builder to append to
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_OUT_OF_MEMORY Out of memory
+ *
+ */
+int _media_filter_attribute_append_query(attribute_h attr, filter_h filter, query_builder_s *query);
+
+/**
+ * @brief Same as _media_filter_attribute_append_query(), but orders by @a default_order when the filter has no order.
+ * @param[in] attr The handle to media filter attribute
+ * @param[in] filter The handle to media filter, NULL appends only the default order
+ * @param[in] default_order The column list used for "ORDER BY" if no order is set in the filter
+ * @param[in] query The query builder to append to
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_OUT_OF_MEMORY Out of memory
+ *
+ */
+int _media_filter_attribute_append_query_with_order(attribute_h attr, filter_h filter, const char *default_order, query_builder_s *query);
+
+/**
+ * @brief Same as _media_filter_attribute_append_query(), for queries which list rows of the media table.
+ * @details If a continuation token is set in the filter, the offset is replaced by a seek predicate on the order key
+ * and media_uuid, and media_uuid is added to the order to break ties.
+ * @param[in] attr The handle to media filter attribute
+ * @param[in] filter The handle to media filter, NULL appends nothing
+ * @param[in] query The query builder to append to
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_OPERATION A continuation token is set but the order is not a single field
+ * @retval #MEDIA_CONTENT_ERROR_OUT_OF_MEMORY Out of memory
+ *
+ */
+int _media_filter_attribute_append_media_query(attribute_h attr, filter_h filter, query_builder_s *query);
+
+/**
+ * @brief Same as _media_filter_attribute_append_query(), with "GROUP BY @a group_by" between the condition and the order.
+ * @details If the filter has no order, the groups are ordered by @a group_by.
+ * @param[in] attr The handle to media filter attribute
+ * @param[in] filter The handle to media filter, NULL appends only the GROUP BY clause
+ * @param[in] group_by The column list the rows are grouped by
+ * @param[in] query The query builder to append to
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_OUT_OF_MEMORY Out of memory
+ *
+ */
+int _media_filter_attribute_append_group_query(attribute_h attr, filter_h filter, const char *group_by, query_builder_s *query);
+
+/**
+ * @brief Appends the order key column of the continuation token set in the filter after the projected media columns.
+ * @details The column is read at #MEDIA_SEEK_KEY_COLUMN. Nothing is appended if no token is set.
+ * @param[in] filter The handle to media filter, NULL appends nothing
+ * @param[in] query The query builder to append to
+ *
+ */
+void _media_filter_append_seek_column(filter_h filter, query_builder_s *query);
+
+/**
+ * @brief Makes the continuation token of the current row of @a stmt.
+ * @details @a token is reused, and only grown when the token does not fit in @a token_size.
+ * @param[in] stmt The statement on the row
+ * @param[in] column The column of the order key
+ * @param[in] media_id The media_uuid of the row
+ * @param[in,out] token The token buffer, NULL to allocate one
+ * @param[in,out] token_size The size of @a token
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_OUT_OF_MEMORY Out of memory
+ *
+ */
+int _media_filter_make_seek_token(sqlite3_stmt *stmt, int column, const char *media_id, char **token, int *token_size);
+
+/**
+ * @brief Keeps the token of the last row listed with the filter, so that media_filter_get_continuation_token() does not query it again.
+ * @param[in] filter The handle to media filter
+ * @param[in] token The token, owned by the filter from now on
+ *
+ */
+void _media_filter_set_last_seek_token(filter_h filter, char *token);
+
+/**
+ *@internal
+ */
+int _media_filter_clone(filter_h filter, filter_h *clone);
+
+/**
+ *@internal
+ */
+const char *_media_filter_attribute_get_field(attribute_h attr, const char *user_attr);
+
+/* Log levels. Messages above MEDIA_CONTENT_LOG_LEVEL are compiled out, the others are checked against _content_log_level */
+#define MEDIA_CONTENT_LOG_NONE		0
+#define MEDIA_CONTENT_LOG_ERROR		1
+#define MEDIA_CONTENT_LOG_DEBUG		2
+#define MEDIA_CONTENT_LOG_VERBOSE	3		// every query, row or getter call
+#define MEDIA_CONTENT_LOG_ENV		"MEDIA_CONTENT_LOG_LEVEL"	// runtime level, read by media_content_connect()
+
+#ifndef MEDIA_CONTENT_LOG_LEVEL
+#ifdef TIZEN_DEBUG
+#define MEDIA_CONTENT_LOG_LEVEL		MEDIA_CONTENT_LOG_DEBUG
+#else
+#define MEDIA_CONTENT_LOG_LEVEL		MEDIA_CONTENT_LOG_ERROR
+#endif
+#endif
+
+extern int _content_log_level;
+
+/* The first test is a constant, so the whole message goes away when it is false */
+#define media_content_log_enabled(level)	((level) <= MEDIA_CONTENT_LOG_LEVEL && (level) <= _content_log_level)
 
 #define media_content_retv_if(expr, val) do { \
 			if(expr) { \
-				LOGE("[%s-%d]", __FUNCTION__, __LINE__);    \
+				if(media_content_log_enabled(MEDIA_CONTENT_LOG_ERROR)) \
+					LOGE("[%s-%d]", __FUNCTION__, __LINE__);    \
 				return (val); \
 			} \
 		} while (0)
 
 #define media_content_debug(fmt, arg...) do { \
-			LOGD("[%s-%d]"fmt"", __FUNCTION__, __LINE__,##arg);     \
+			if(media_content_log_enabled(MEDIA_CONTENT_LOG_DEBUG)) \
+				LOGD("[%s-%d]"fmt"", __FUNCTION__, __LINE__,##arg);     \
 		} while (0)
 
 #define media_content_error(fmt, arg...) do { \
-			LOGE("[%s-%d]"fmt"", __FUNCTION__, __LINE__,##arg);     \
+			if(media_content_log_enabled(MEDIA_CONTENT_LOG_ERROR)) \
+				LOGE("[%s-%d]"fmt"", __FUNCTION__, __LINE__,##arg);     \
 		} while (0)
 
 #define media_content_debug_func() do { \
-			LOGD("[%s-%d]", __FUNCTION__, __LINE__);     \
+			if(media_content_log_enabled(MEDIA_CONTENT_LOG_DEBUG)) \
+				LOGD("[%s-%d]", __FUNCTION__, __LINE__);     \
+		} while (0)
+
+#define media_content_verbose(fmt, arg...) do { \
+			if(media_content_log_enabled(MEDIA_CONTENT_LOG_VERBOSE)) \
+				LOGD("[%s-%d]"fmt"", __FUNCTION__, __LINE__,##arg);     \
+		} while (0)
+
+#define media_content_verbose_func() do { \
+			if(media_content_log_enabled(MEDIA_CONTENT_LOG_VERBOSE)) \
+				LOGD("[%s-%d]", __FUNCTION__, __LINE__);     \
 		} while (0)
 
 #ifdef __cplusplus
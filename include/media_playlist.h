@@ -67,6 +67,29 @@ int media_playlist_get_playlist_count_from_db(filter_h filter, int *playlist_cou
  */
 int media_playlist_foreach_playlist_from_db(filter_h filter, media_playlist_cb callback, void *user_data);
 
+/**
+ * @brief Iterates through the media playlist with the number of media in every playlist.
+ * @details The playlists and their media count come from one query. Calling media_playlist_get_media_count_from_db() for every playlist
+ * from the callback of media_playlist_foreach_playlist_from_db() gives the same counts with one query per playlist.
+ * If NULL is passed to the filter, no filtering is applied.
+ *
+ * @remarks The condition of @a filter is applied to the media which are counted. A playlist is listed if at least one of its media meets it.
+ *
+ * @param[in] filter The handle to media filter
+ * @param[in] callback The callback function to invoke
+ * @param[in] user_data The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_OUT_OF_MEMORY Out of memory
+ * @pre This function requires opened connection to content service by media_content_connect().
+ * @post This function invokes media_playlist_count_cb().
+ * @see #media_playlist_count_cb
+ * @see media_playlist_foreach_playlist_from_db()
+ * @see media_playlist_get_media_count_from_db()
+ */
+int media_playlist_foreach_playlist_with_count_from_db(filter_h filter, media_playlist_count_cb callback, void *user_data);
+
 /**
  * @brief Gets number of media info for the given playlist present in the media database.
  *
@@ -302,10 +325,15 @@ int media_playlist_get_play_order(media_playlist_h playlist, int playlist_member
  * database. For example, after using media_playlist_set_name() for setting the name of the playlist, media_playlist_update_to_db() function should be called so as to update 
  * the given playlist attibutes in the media database.
  *
+ * @remarks All pending changes are applied in one transaction. If one of them fails, none of them is applied.
+ * The pending changes are discarded in both cases.
+ *
  * @param[in] playlist The handle to media playlist
  * @return 0 on success, otherwise a negative error value.
  * @retval #MEDIA_CONTENT_ERROR_NONE Successful
  * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_DB_FAILED DB operation failed
+ * @retval #MEDIA_CONTENT_ERROR_DB_BUSY DB is busy
  * @pre This function requires opened connection to content service by media_content_connect().
  * @see media_content_connect()
  * @see media_playlist_destroy()
@@ -317,6 +345,26 @@ int media_playlist_get_play_order(media_playlist_h playlist, int playlist_member
  */
 int media_playlist_update_to_db(media_playlist_h playlist);
 
+/**
+ * @brief Updates the media playlist to the media database and gets the number of applied changes.
+ *
+ * @details This function is the same as media_playlist_update_to_db(), and additionally returns how many of the pending changes were applied.
+ *
+ * @remarks If the update fails, no change is applied and the pending changes are kept on the handle. They are freed by the next successful update or by destroy.
+ *
+ * @param[in] playlist The handle to media playlist
+ * @param[out] applied_count The number of applied changes, 0 if the transaction was rolled back. It can be NULL.
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_DB_FAILED DB operation failed
+ * @retval #MEDIA_CONTENT_ERROR_DB_BUSY DB is busy
+ * @pre This function requires opened connection to content service by media_content_connect().
+ * @see media_playlist_update_to_db()
+ *
+ */
+int media_playlist_update_to_db_with_count(media_playlist_h playlist, int *applied_count);
+
 /**
  * @}
  */
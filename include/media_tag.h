@@ -100,6 +100,29 @@ int media_tag_get_tag_count_from_db(filter_h filter, int *tag_count);
  */
 int media_tag_foreach_tag_from_db (filter_h filter, media_tag_cb callback, void *user_data);
 
+/**
+ * @brief Iterates through the media tag with the number of media in every tag.
+ * @details The tags and their media count come from one query. Calling media_tag_get_media_count_from_db() for every tag
+ * from the callback of media_tag_foreach_tag_from_db() gives the same counts with one query per tag.
+ * If NULL is passed to the filter, no filtering is applied.
+ *
+ * @remarks The condition of @a filter is applied to the media which are counted. A tag is listed if at least one of its media meets it.
+ *
+ * @param[in] filter The handle to media filter
+ * @param[in] callback The callback function to invoke
+ * @param[in] user_data The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_OUT_OF_MEMORY Out of memory
+ * @pre This function requires opened connection to content service by media_content_connect().
+ * @post This function invokes media_tag_count_cb().
+ * @see #media_tag_count_cb
+ * @see media_tag_foreach_tag_from_db()
+ * @see media_tag_get_media_count_from_db()
+ */
+int media_tag_foreach_tag_with_count_from_db(filter_h filter, media_tag_count_cb callback, void *user_data);
+
 /**
  * @brief Gets the number of media files for the passed @a filter in the given @a tag from the media database.
  *
@@ -275,10 +298,15 @@ int media_tag_set_name(media_tag_h tag, char *tag_name);
  * database. For example, after using media_tag_set_name() for setting the name of the tag, media_tag_update_to_db() function should be called so as to update 
  * the given tag attibutes in the media database.
  *
+ * @remarks All pending changes are applied in one transaction. If one of them fails, none of them is applied.
+ * The pending changes are discarded in both cases.
+ *
  * @param[in] tag The handle to media tag
  * @return 0 on success, otherwise a negative error value.
  * @retval #MEDIA_CONTENT_ERROR_NONE Successful
  * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_DB_FAILED DB operation failed
+ * @retval #MEDIA_CONTENT_ERROR_DB_BUSY DB is busy
  * @pre This function requires opened connection to content service by media_content_connect().
  * @see media_content_connect()
  * @see media_tag_destroy()
@@ -289,6 +317,26 @@ int media_tag_set_name(media_tag_h tag, char *tag_name);
  */
 int media_tag_update_to_db(media_tag_h tag);
 
+/**
+ * @brief Updates the media tag to the media database and gets the number of applied changes.
+ *
+ * @details This function is the same as media_tag_update_to_db(), and additionally returns how many of the pending changes were applied.
+ *
+ * @remarks If the update fails, no change is applied and the pending changes are kept on the handle. They are freed by the next successful update or by destroy.
+ *
+ * @param[in] tag The handle to media tag
+ * @param[out] applied_count The number of applied changes, 0 if the transaction was rolled back. It can be NULL.
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #MEDIA_CONTENT_ERROR_NONE Successful
+ * @retval #MEDIA_CONTENT_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #MEDIA_CONTENT_ERROR_DB_FAILED DB operation failed
+ * @retval #MEDIA_CONTENT_ERROR_DB_BUSY DB is busy
+ * @pre This function requires opened connection to content service by media_content_connect().
+ * @see media_tag_update_to_db()
+ *
+ */
+int media_tag_update_to_db_with_count(media_tag_h tag, int *applied_count);
+
 /**
  * @}
  */
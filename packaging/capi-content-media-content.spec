@@ -11,6 +11,7 @@ BuildRequires:  pkgconfig(capi-base-common)
 BuildRequires:  pkgconfig(libmedia-service)
 BuildRequires:  pkgconfig(media-thumbnail)
 BuildRequires:  pkgconfig(libmedia-utils)
+BuildRequires:  pkgconfig(glib-2.0)
 
 
 Requires(post): /sbin/ldconfig
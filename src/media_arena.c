@@ -0,0 +1,135 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include <media_info_private.h>
+
+
+#define ARENA_ALIGN(size)	(((size) + sizeof(double) - 1) & ~(sizeof(double) - 1))
+#define ARENA_HEADER_SIZE	ARENA_ALIGN(sizeof(content_arena_block_s))
+
+static content_arena_block_s *__media_arena_block_new(size_t size);
+
+static content_arena_block_s *__media_arena_block_new(size_t size)
+{
+	content_arena_block_s *block = NULL;
+
+	if(size < MEDIA_CONTENT_ARENA_BLOCK_SIZE)
+		size = MEDIA_CONTENT_ARENA_BLOCK_SIZE;
+
+	block = (content_arena_block_s*)malloc(ARENA_HEADER_SIZE + size);
+	if(block == NULL)
+		return NULL;
+
+	block->next = NULL;
+	block->size = size;
+	block->used = 0;
+
+	return block;
+}
+
+void _content_arena_init(content_arena_s *arena)
+{
+	arena->head = NULL;
+}
+
+void *_content_arena_alloc(content_arena_s *arena, size_t size)
+{
+	content_arena_block_s *block = arena->head;
+	char *ptr = NULL;
+
+	size = ARENA_ALIGN(size);
+
+	if(block == NULL || block->used + size > block->size)
+	{
+		block = __media_arena_block_new(size);
+		if(block == NULL)
+		{
+			media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
+			return NULL;
+		}
+
+		block->next = arena->head;
+		arena->head = block;
+	}
+
+	ptr = (char*)block + ARENA_HEADER_SIZE + block->used;
+	block->used += size;
+	memset(ptr, 0x00, size);
+
+	return ptr;
+}
+
+char *_content_arena_strdup(content_arena_s *arena, const char *str)
+{
+	size_t len = 0;
+	char *dup = NULL;
+
+	if(str == NULL)
+		return NULL;
+
+	len = strlen(str);
+
+	dup = (char*)_content_arena_alloc(arena, len + 1);
+	if(dup != NULL)
+		memcpy(dup, str, len + 1);
+
+	return dup;
+}
+
+/* Keeps the largest block, so that a scan stops calling malloc once one block holds a whole row */
+void _content_arena_reset(content_arena_s *arena)
+{
+	content_arena_block_s *block = arena->head;
+	content_arena_block_s *next = NULL;
+	content_arena_block_s *keep = arena->head;
+
+	for(; block != NULL; block = block->next)
+	{
+		if(block->size > keep->size)
+			keep = block;
+	}
+
+	for(block = arena->head; block != NULL; block = next)
+	{
+		next = block->next;
+		if(block != keep)
+			free(block);
+	}
+
+	if(keep != NULL)
+	{
+		keep->next = NULL;
+		keep->used = 0;
+	}
+
+	arena->head = keep;
+}
+
+void _content_arena_release(content_arena_s *arena)
+{
+	content_arena_block_s *block = arena->head;
+	content_arena_block_s *next = NULL;
+
+	while(block != NULL)
+	{
+		next = block->next;
+		free(block);
+		block = next;
+	}
+
+	arena->head = NULL;
+}
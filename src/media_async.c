@@ -0,0 +1,474 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include <media_content.h>
+#include <media_info_private.h>
+
+
+#define MEDIA_ASYNC_THREAD_COUNT	2		// workers, each reads with the read connection of its thread
+#define MEDIA_ASYNC_MAX_PENDING		4		// batches waiting for the main context before the worker waits
+
+typedef enum
+{
+	MEDIA_ASYNC_FOREACH_MEDIA,
+	MEDIA_ASYNC_FOLDER_COUNT,
+}media_async_type_e;
+
+typedef struct
+{
+	content_arena_s arena;		// items and their strings, released after the callback
+	media_info_h *items;
+	int count;
+}media_async_batch_s;
+
+typedef struct
+{
+	unsigned int id;
+	int ref;								// the request table, the worker and an attached source
+	media_async_type_e type;
+	filter_h filter;						// copy of the filter of the caller, NULL if none
+	int batch_size;
+	GMainContext *context;
+	media_info_batch_cb batch_cb;
+	media_content_request_completed_cb completed_cb;
+	media_content_count_completed_cb count_cb;
+	void *user_data;
+	int stopped;							// rows are not wanted anymore, read by the worker without the lock
+	bool cancelled;							// no callback is called anymore
+	bool finished;							// the worker is done, result and count are set
+	int result;
+	int count;
+	GQueue *batches;						// media_async_batch_s* waiting for the main context
+	bool dispatching;						// a source is attached to the context
+	pthread_cond_t cond;					// signaled when a batch is taken or the request is stopped
+}media_async_request_s;
+
+/* Guards the request table, the pool and every field of the requests but stopped */
+static pthread_mutex_t g_async_mutex = PTHREAD_MUTEX_INITIALIZER;
+static GThreadPool *g_async_pool = NULL;
+static GHashTable *g_async_requests = NULL;		// id -> media_async_request_s*, until the request is finished or cancelled
+static unsigned int g_async_last_id = 0;
+
+static void __media_async_unref(media_async_request_s *request);
+static void __media_async_batch_free(media_async_batch_s *batch);
+static void __media_async_source_destroy(gpointer data);
+static void __media_async_dispatch_locked(media_async_request_s *request);
+static gboolean __media_async_dispatch(gpointer data);
+static int __media_async_post(media_async_request_s *request, media_async_batch_s *batch);
+static int __media_async_foreach_media(media_async_request_s *request);
+static void __media_async_run(gpointer data, gpointer pool_data);
+static int __media_async_request(media_async_request_s *request, filter_h filter, GMainContext *context, unsigned int *request_id);
+
+/* Called with g_async_mutex held */
+static void __media_async_unref(media_async_request_s *request)
+{
+	media_async_batch_s *batch = NULL;
+
+	if(--request->ref > 0)
+		return;
+
+	while((batch = (media_async_batch_s*)g_queue_pop_head(request->batches)) != NULL)
+		__media_async_batch_free(batch);
+
+	g_queue_free(request->batches);
+	pthread_cond_destroy(&request->cond);
+	g_main_context_unref(request->context);
+
+	if(request->filter != NULL)
+		media_filter_destroy(request->filter);
+
+	SAFE_FREE(request);
+}
+
+static void __media_async_batch_free(media_async_batch_s *batch)
+{
+	_content_arena_release(&batch->arena);
+	SAFE_FREE(batch->items);
+	SAFE_FREE(batch);
+}
+
+static void __media_async_source_destroy(gpointer data)
+{
+	pthread_mutex_lock(&g_async_mutex);
+	__media_async_unref((media_async_request_s*)data);
+	pthread_mutex_unlock(&g_async_mutex);
+}
+
+/* Called with g_async_mutex held, whenever there is something for the main context */
+static void __media_async_dispatch_locked(media_async_request_s *request)
+{
+	GSource *source = NULL;
+
+	if(request->dispatching || request->cancelled)
+		return;
+
+	source = g_idle_source_new();
+	g_source_set_callback(source, __media_async_dispatch, request, __media_async_source_destroy);
+
+	request->ref++;
+	request->dispatching = TRUE;
+
+	g_source_attach(source, request->context);
+	g_source_unref(source);
+}
+
+/* Runs in the main context, one batch per iteration so that the context stays responsive */
+static gboolean __media_async_dispatch(gpointer data)
+{
+	media_async_request_s *request = (media_async_request_s*)data;
+	media_async_batch_s *batch = NULL;
+
+	pthread_mutex_lock(&g_async_mutex);
+
+	if(request->cancelled)
+	{
+		request->dispatching = FALSE;
+		pthread_mutex_unlock(&g_async_mutex);
+		return FALSE;
+	}
+
+	batch = (media_async_batch_s*)g_queue_pop_head(request->batches);
+	if(batch != NULL)
+	{
+		pthread_cond_signal(&request->cond);
+		pthread_mutex_unlock(&g_async_mutex);
+
+		if(!g_atomic_int_get(&request->stopped) && request->batch_cb(batch->items, batch->count, request->user_data) == false)
+		{
+			pthread_mutex_lock(&g_async_mutex);
+			g_atomic_int_set(&request->stopped, 1);
+			pthread_cond_signal(&request->cond);
+			pthread_mutex_unlock(&g_async_mutex);
+		}
+
+		__media_async_batch_free(batch);
+
+		return TRUE;
+	}
+
+	request->dispatching = FALSE;
+
+	if(!request->finished)
+	{
+		/* The worker attaches a new source with its next batch */
+		pthread_mutex_unlock(&g_async_mutex);
+		return FALSE;
+	}
+
+	g_hash_table_remove(g_async_requests, GUINT_TO_POINTER(request->id));
+	pthread_mutex_unlock(&g_async_mutex);
+
+	if(request->type == MEDIA_ASYNC_FOLDER_COUNT)
+		request->count_cb(request->result, request->count, request->user_data);
+	else if(request->completed_cb != NULL)
+		request->completed_cb(request->result, request->user_data);
+
+	return FALSE;
+}
+
+/* Hands a batch to the main context. The worker waits while the main context is MEDIA_ASYNC_MAX_PENDING batches behind */
+static int __media_async_post(media_async_request_s *request, media_async_batch_s *batch)
+{
+	pthread_mutex_lock(&g_async_mutex);
+
+	while(!g_atomic_int_get(&request->stopped) && g_queue_get_length(request->batches) >= MEDIA_ASYNC_MAX_PENDING)
+		pthread_cond_wait(&request->cond, &g_async_mutex);
+
+	if(g_atomic_int_get(&request->stopped))
+	{
+		pthread_mutex_unlock(&g_async_mutex);
+		__media_async_batch_free(batch);
+		return MEDIA_CONTENT_ERROR_NONE;
+	}
+
+	g_queue_push_tail(request->batches, batch);
+	__media_async_dispatch_locked(request);
+
+	pthread_mutex_unlock(&g_async_mutex);
+
+	return MEDIA_CONTENT_ERROR_NONE;
+}
+
+/* Same rows as media_info_foreach_media_from_db(), carved from one arena per batch */
+static int __media_async_foreach_media(media_async_request_s *request)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	int err = SQLITE_OK;
+	int field_groups = (request->filter != NULL) ? ((filter_s*)request->filter)->field_groups : MEDIA_CONTENT_FIELD_ALL;
+	sqlite3_stmt *stmt = NULL;
+	media_info_s *item = NULL;
+	media_async_batch_s *batch = NULL;
+
+	ret = _media_db_open_group_item(NULL, request->filter, MEDIA_GROUP_NONE, &stmt);
+	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
+
+	while(ret == MEDIA_CONTENT_ERROR_NONE && !g_atomic_int_get(&request->stopped))
+	{
+		err = _content_query_step(stmt);
+		if(err != SQLITE_ROW)
+		{
+			if(err != SQLITE_DONE)
+			{
+				media_content_error("DB_FAILED(0x%08x) fail to sqlite3_step(), %s", MEDIA_CONTENT_ERROR_DB_FAILED, sqlite3_errmsg(sqlite3_db_handle(stmt)));
+				ret = MEDIA_CONTENT_ERROR_DB_FAILED;
+			}
+			break;
+		}
+
+		if(batch == NULL)
+		{
+			batch = (media_async_batch_s*)calloc(1, sizeof(media_async_batch_s));
+			if(batch != NULL)
+			{
+				batch->items = (media_info_h*)calloc(request->batch_size, sizeof(media_info_h));
+				if(batch->items == NULL)
+					SAFE_FREE(batch);
+			}
+
+			if(batch == NULL)
+			{
+				media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
+				ret = MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
+				break;
+			}
+
+			_content_arena_init(&batch->arena);
+		}
+
+		item = (media_info_s*)_content_arena_alloc(&batch->arena, sizeof(media_info_s));
+		if(item == NULL)
+		{
+			media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
+			ret = MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
+			break;
+		}
+
+		_media_info_item_get_detail(stmt, (media_info_h)item, field_groups, &batch->arena);
+		batch->items[batch->count++] = (media_info_h)item;
+
+		if(batch->count == request->batch_size)
+		{
+			ret = __media_async_post(request, batch);
+			batch = NULL;
+		}
+	}
+
+	SQLITE3_FINALIZE(stmt);
+
+	/* Rows read before an error are still delivered, ahead of the error */
+	if(batch != NULL)
+		__media_async_post(request, batch);
+
+	return ret;
+}
+
+static void __media_async_run(gpointer data, gpointer pool_data)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	int count = 0;
+	media_async_request_s *request = (media_async_request_s*)data;
+
+	if(!g_atomic_int_get(&request->stopped))
+	{
+		if(request->type == MEDIA_ASYNC_FOLDER_COUNT)
+			ret = media_folder_get_folder_count_from_db(request->filter, &count);
+		else
+			ret = __media_async_foreach_media(request);
+	}
+
+	pthread_mutex_lock(&g_async_mutex);
+
+	request->result = ret;
+	request->count = (ret == MEDIA_CONTENT_ERROR_NONE) ? count : 0;
+	request->finished = TRUE;
+	__media_async_dispatch_locked(request);
+	__media_async_unref(request);
+
+	pthread_mutex_unlock(&g_async_mutex);
+
+	/* Taken by __media_async_request() */
+	media_content_disconnect();
+}
+
+/* Queues a request filled by the caller. The connection is held until the worker is done with it */
+static int __media_async_request(media_async_request_s *request, filter_h filter, GMainContext *context, unsigned int *request_id)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	GError *error = NULL;
+
+	if(filter != NULL)
+	{
+		ret = _media_filter_clone(filter, &request->filter);
+		if(ret != MEDIA_CONTENT_ERROR_NONE)
+		{
+			SAFE_FREE(request);
+			return ret;
+		}
+	}
+
+	ret = media_content_connect();
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+	{
+		if(request->filter != NULL)
+			media_filter_destroy(request->filter);
+		SAFE_FREE(request);
+		return ret;
+	}
+
+	request->context = g_main_context_ref((context != NULL) ? context : g_main_context_default());
+	request->batches = g_queue_new();
+	pthread_cond_init(&request->cond, NULL);
+
+	pthread_mutex_lock(&g_async_mutex);
+
+	if(g_async_pool == NULL)
+	{
+		g_async_pool = g_thread_pool_new(__media_async_run, NULL, MEDIA_ASYNC_THREAD_COUNT, FALSE, &error);
+		if(g_async_pool == NULL)
+		{
+			media_content_error("INVALID_OPERATION(0x%08x) fail to create the worker pool, %s", MEDIA_CONTENT_ERROR_INVALID_OPERATION, (error != NULL) ? error->message : "");
+			g_clear_error(&error);
+			ret = MEDIA_CONTENT_ERROR_INVALID_OPERATION;
+		}
+	}
+
+	if(ret == MEDIA_CONTENT_ERROR_NONE && g_async_requests == NULL)
+		g_async_requests = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, (GDestroyNotify)__media_async_unref);
+
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+	{
+		/* 0 is never an ID, so that callers can use it for no request */
+		if(++g_async_last_id == 0)
+			++g_async_last_id;
+
+		request->id = g_async_last_id;
+		request->ref = 2;
+		g_hash_table_insert(g_async_requests, GUINT_TO_POINTER(request->id), request);
+
+		if(!g_thread_pool_push(g_async_pool, request, &error))
+		{
+			media_content_error("INVALID_OPERATION(0x%08x) fail to start the request, %s", MEDIA_CONTENT_ERROR_INVALID_OPERATION, (error != NULL) ? error->message : "");
+			g_clear_error(&error);
+			ret = MEDIA_CONTENT_ERROR_INVALID_OPERATION;
+
+			request->ref--;
+			g_hash_table_remove(g_async_requests, GUINT_TO_POINTER(request->id));
+		}
+		else if(request_id != NULL)
+		{
+			*request_id = request->id;
+		}
+	}
+	else
+	{
+		request->ref = 1;
+		__media_async_unref(request);
+	}
+
+	pthread_mutex_unlock(&g_async_mutex);
+
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+		media_content_disconnect();
+
+	return ret;
+}
+
+int media_info_foreach_media_from_db_async(filter_h filter, int batch_size, GMainContext *context, media_info_batch_cb callback,
+	media_content_request_completed_cb completed_cb, void *user_data, unsigned int *request_id)
+{
+	media_async_request_s *request = NULL;
+
+	media_content_debug_func();
+
+	if(callback == NULL || batch_size < 0)
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+
+	request = (media_async_request_s*)calloc(1, sizeof(media_async_request_s));
+	if(request == NULL)
+	{
+		media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
+		return MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
+	}
+
+	request->type = MEDIA_ASYNC_FOREACH_MEDIA;
+	request->batch_size = (batch_size > 0) ? batch_size : MEDIA_INFO_DEFAULT_BATCH_SIZE;
+	request->batch_cb = callback;
+	request->completed_cb = completed_cb;
+	request->user_data = user_data;
+
+	return __media_async_request(request, filter, context, request_id);
+}
+
+int media_folder_get_folder_count_from_db_async(filter_h filter, GMainContext *context, media_content_count_completed_cb callback,
+	void *user_data, unsigned int *request_id)
+{
+	media_async_request_s *request = NULL;
+
+	media_content_debug_func();
+
+	if(callback == NULL)
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+
+	request = (media_async_request_s*)calloc(1, sizeof(media_async_request_s));
+	if(request == NULL)
+	{
+		media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
+		return MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
+	}
+
+	request->type = MEDIA_ASYNC_FOLDER_COUNT;
+	request->count_cb = callback;
+	request->user_data = user_data;
+
+	return __media_async_request(request, filter, context, request_id);
+}
+
+int media_content_cancel_request(unsigned int request_id)
+{
+	media_async_request_s *request = NULL;
+
+	media_content_debug_func();
+
+	pthread_mutex_lock(&g_async_mutex);
+
+	if(g_async_requests != NULL)
+		request = (media_async_request_s*)g_hash_table_lookup(g_async_requests, GUINT_TO_POINTER(request_id));
+
+	if(request == NULL)
+	{
+		pthread_mutex_unlock(&g_async_mutex);
+		media_content_error("INVALID_PARAMETER(0x%08x) no request [%u]", MEDIA_CONTENT_ERROR_INVALID_PARAMETER, request_id);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+
+	/* The worker stops at its next row, queued batches are freed by the attached source */
+	g_atomic_int_set(&request->stopped, 1);
+	request->cancelled = TRUE;
+	pthread_cond_signal(&request->cond);
+
+	g_hash_table_remove(g_async_requests, GUINT_TO_POINTER(request_id));
+
+	pthread_mutex_unlock(&g_async_mutex);
+
+	return MEDIA_CONTENT_ERROR_NONE;
+}
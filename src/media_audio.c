@@ -700,13 +700,24 @@ int audio_meta_update_to_db(audio_meta_h audio)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
 	audio_meta_s *_audio = (audio_meta_s*)audio;
-	char *sql = NULL;
+	sqlite3_stmt *stmt = NULL;
 
 	if(_audio != NULL && STRING_VALID(_audio->media_id))
 	{
-		sql = sqlite3_mprintf(UPDATE_AV_META_FROM_MEDIA, _audio->played_count, _audio->played_time, _audio->played_position, _audio->media_id);
-		ret = _content_query_sql(sql);
-		sqlite3_free(sql);
+		ret = _content_query_prepare(&stmt, UPDATE_AV_META_FROM_MEDIA, NULL, NULL);
+		media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
+
+		ret = _content_query_bind_int(stmt, 1, _audio->played_count);
+		if(ret == MEDIA_CONTENT_ERROR_NONE)
+			ret = _content_query_bind_int(stmt, 2, _audio->played_time);
+		if(ret == MEDIA_CONTENT_ERROR_NONE)
+			ret = _content_query_bind_int(stmt, 3, _audio->played_position);
+		if(ret == MEDIA_CONTENT_ERROR_NONE)
+			ret = _content_query_bind_text(stmt, 4, _audio->media_id);
+		if(ret == MEDIA_CONTENT_ERROR_NONE)
+			ret = _content_query_step_done(stmt);
+
+		SQLITE3_FINALIZE(stmt);
 	}
 	else
 	{
@@ -19,18 +19,52 @@
 #include <media_content.h>
 #include <media_info_private.h>
 #include <media-util-err.h>
+#include <pthread.h>
 
 
+#define MEDIA_CONTENT_DB_BUSY_TIMEOUT	1000	/* ms */
+
+/* Read-only connection owned by one thread. It is created on the first SELECT
+ * issued by that thread and freed when the thread exits. Only that thread
+ * opens or closes it; a disconnect bumps g_read_conn_generation instead. */
+typedef struct
+{
+	sqlite3 *db;
+	stmt_cache_h stmt_cache;
+	gint generation;			// g_read_conn_generation when db was opened
+	pthread_mutex_t lock;		// stmt_cache, statements may be finalized by another thread
+}read_conn_s;
+
 static attribute_h g_attr_handle = NULL;
 static attribute_h g_alias_attr_handle = NULL;
-static MediaSvcHandle *db_handle = NULL;
+static MediaSvcHandle *db_handle = NULL;		/* the single writer connection */
+static stmt_cache_h g_stmt_cache = NULL;		/* statement cache of db_handle */
 static int ref_count = 0;
+static char *g_db_path = NULL;
+static GList *g_read_conn_list = NULL;
+static gint g_read_conn_generation = 0;		/* bumped under g_content_mutex when the last client disconnects */
+
+static pthread_mutex_t g_content_mutex = PTHREAD_MUTEX_INITIALIZER;	/* connect state and g_read_conn_list */
+static pthread_mutex_t g_writer_mutex = PTHREAD_MUTEX_INITIALIZER;		/* g_stmt_cache */
+static pthread_mutex_t g_transaction_mutex;		/* recursive, held by the thread which owns the open write transaction */
+static pthread_once_t g_transaction_once = PTHREAD_ONCE_INIT;
+static pthread_once_t g_read_conn_once = PTHREAD_ONCE_INIT;
+static pthread_key_t g_read_conn_key;
+
+int _content_log_level = MEDIA_CONTENT_LOG_LEVEL;	/* see media_content_log_enabled() */
 
 
 static int __media_content_create_attr_handle(void);
 static int __media_content_create_alias_attr_handle(void);
 static int __media_content_create_attribute_handle(void);
 static int __media_content_destroy_attribute_handle(void);
+static void __media_content_read_conn_close(read_conn_s *conn);
+static void __media_content_read_conn_free(void *data);
+static void __media_content_read_conn_key_create(void);
+static read_conn_s *__media_content_get_read_conn(void);
+static bool __media_content_is_read_query(const char *query);
+static void __media_content_transaction_mutex_init(void);
+static int __media_content_prepare(sqlite3_stmt **stmt, const char *query, bool use_writer, bool use_cache);
 
 
 static int __media_content_create_attr_handle(void)
@@ -393,12 +427,199 @@ static int __media_content_destroy_attribute_handle(void)
 
 	ret = _media_filter_attribute_destory(g_attr_handle);
 	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
+	g_attr_handle = NULL;
 
 	ret = _media_filter_attribute_destory(g_alias_attr_handle);
+	g_alias_attr_handle = NULL;
 
 	return ret;
 }
 
+static void __media_content_read_conn_close(read_conn_s *conn)
+{
+	if(conn->stmt_cache != NULL)
+	{
+		pthread_mutex_lock(&conn->lock);
+		_content_stmt_cache_destroy(conn->stmt_cache);
+		conn->stmt_cache = NULL;
+		pthread_mutex_unlock(&conn->lock);
+	}
+
+	if(conn->db != NULL)
+	{
+		/* Statements still stepped elsewhere keep the connection until they are finalized */
+		if(sqlite3_close_v2(conn->db) != SQLITE_OK)
+		{
+			media_content_error("fail to close read connection, %s", sqlite3_errmsg(conn->db));
+			return;
+		}
+		conn->db = NULL;
+	}
+}
+
+static void __media_content_read_conn_free(void *data)
+{
+	read_conn_s *conn = (read_conn_s*)data;
+
+	pthread_mutex_lock(&g_content_mutex);
+	g_read_conn_list = g_list_remove(g_read_conn_list, conn);
+	__media_content_read_conn_close(conn);
+	pthread_mutex_unlock(&g_content_mutex);
+
+	pthread_mutex_destroy(&conn->lock);
+	SAFE_FREE(conn);
+}
+
+static void __media_content_read_conn_key_create(void)
+{
+	pthread_key_create(&g_read_conn_key, __media_content_read_conn_free);
+}
+
+/* Returns the read connection of the calling thread, or NULL when reads have to
+ * go through the writer connection (e.g. the database file can not be opened). */
+static read_conn_s *__media_content_get_read_conn(void)
+{
+	int err = SQLITE_OK;
+	read_conn_s *conn = NULL;
+
+	pthread_once(&g_read_conn_once, __media_content_read_conn_key_create);
+
+	conn = (read_conn_s*)pthread_getspecific(g_read_conn_key);
+	if(conn != NULL && conn->db != NULL && conn->generation == g_atomic_int_get(&g_read_conn_generation))
+		return conn;
+
+	pthread_mutex_lock(&g_content_mutex);
+
+	/* Opened before the last disconnect */
+	if(conn != NULL && conn->db != NULL)
+	{
+		__media_content_read_conn_close(conn);
+		if(conn->db != NULL)
+		{
+			pthread_mutex_unlock(&g_content_mutex);
+			return NULL;
+		}
+	}
+
+	if(!STRING_VALID(g_db_path))
+	{
+		pthread_mutex_unlock(&g_content_mutex);
+		return NULL;
+	}
+
+	if(conn == NULL)
+	{
+		conn = (read_conn_s*)calloc(1, sizeof(read_conn_s));
+		if(conn == NULL)
+		{
+			pthread_mutex_unlock(&g_content_mutex);
+			media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
+			return NULL;
+		}
+
+		pthread_mutex_init(&conn->lock, NULL);
+		pthread_setspecific(g_read_conn_key, conn);
+		g_read_conn_list = g_list_append(g_read_conn_list, conn);
+	}
+
+	conn->generation = g_atomic_int_get(&g_read_conn_generation);
+
+	err = sqlite3_open_v2(g_db_path, &conn->db, SQLITE_OPEN_READONLY, NULL);
+	if(err == SQLITE_OK)
+	{
+		sqlite3_busy_timeout(conn->db, MEDIA_CONTENT_DB_BUSY_TIMEOUT);
+		err = _content_stmt_cache_create(conn->db, MEDIA_CONTENT_STMT_CACHE_SIZE, &conn->stmt_cache);
+	}
+	else
+	{
+		media_content_error("fail to open read connection [%s], %s", g_db_path, sqlite3_errmsg(conn->db));
+	}
+
+	if(err != MEDIA_CONTENT_ERROR_NONE)
+		__media_content_read_conn_close(conn);
+
+	pthread_mutex_unlock(&g_content_mutex);
+
+	return (conn->db != NULL) ? conn : NULL;
+}
+
+static bool __media_content_is_read_query(const char *query)
+{
+	while(*query == ' ')
+		query++;
+
+	return (strncasecmp(query, "SELECT", strlen("SELECT")) == 0) ? TRUE : FALSE;
+}
+
+static void __media_content_transaction_mutex_init(void)
+{
+	pthread_mutexattr_t attr;
+
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(&g_transaction_mutex, &attr);
+	pthread_mutexattr_destroy(&attr);
+}
+
+static int __media_content_prepare(sqlite3_stmt **stmt, const char *query, bool use_writer, bool use_cache)
+{
+	int err = MEDIA_CONTENT_ERROR_NONE;
+	read_conn_s *read_conn = NULL;
+	unsigned long long begin = 0;
+
+	if(!STRING_VALID(query) || stmt == NULL)
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+
+	media_content_verbose("Query : [%s]", query);
+
+	if(!use_writer && __media_content_is_read_query(query))
+		read_conn = __media_content_get_read_conn();
+
+	begin = _media_query_stats_begin();
+
+	if(read_conn != NULL)
+	{
+		if(!use_cache)
+		{
+			err = _content_stmt_prepare(read_conn->db, query, stmt);
+		}
+		else
+		{
+			pthread_mutex_lock(&read_conn->lock);
+			err = _content_stmt_cache_prepare(read_conn->stmt_cache, query, stmt);
+			pthread_mutex_unlock(&read_conn->lock);
+		}
+	}
+	else
+	{
+		/* The last disconnect drops g_stmt_cache and closes db_handle under g_writer_mutex.
+		 * db_handle may be left open for statements still being stepped. */
+		pthread_mutex_lock(&g_writer_mutex);
+
+		if(db_handle == NULL || g_stmt_cache == NULL)
+		{
+			pthread_mutex_unlock(&g_writer_mutex);
+			media_content_error("DB_FAILED(0x%08x) database is not connected", MEDIA_CONTENT_ERROR_DB_FAILED);
+			return MEDIA_CONTENT_ERROR_DB_FAILED;
+		}
+
+		if(!use_cache)
+			err = _content_stmt_prepare((sqlite3*)db_handle, query, stmt);
+		else
+			err = _content_stmt_cache_prepare(g_stmt_cache, query, stmt);
+
+		pthread_mutex_unlock(&g_writer_mutex);
+	}
+
+	if(err == MEDIA_CONTENT_ERROR_NONE)
+		_media_query_stats_prepared(*stmt, begin);
+
+	return err;
+}
+
 attribute_h _content_get_attirbute_handle(void)
 {
 	return g_attr_handle;
@@ -414,57 +635,197 @@ MediaSvcHandle* _content_get_db_handle(void)
 	return db_handle;
 }
 
+int _content_query_prepare_str(sqlite3_stmt **stmt, const char *query)
+{
+	return __media_content_prepare(stmt, query, FALSE, TRUE);
+}
+
+/* For statements which outlive the call, e.g. cursors; they are not shared through the statement cache */
+int _content_query_prepare_uncached_str(sqlite3_stmt **stmt, const char *query)
+{
+	return __media_content_prepare(stmt, query, FALSE, FALSE);
+}
+
+/* Reads which have to see the uncommitted changes of the current write transaction */
+int _content_query_prepare_writer_str(sqlite3_stmt **stmt, const char *query)
+{
+	return __media_content_prepare(stmt, query, TRUE, TRUE);
+}
+
 int _content_query_prepare(sqlite3_stmt **stmt, char *select_query, char *condition_query, char *option_query)
 {
-	int len = 0;
 	int err = MEDIA_CONTENT_ERROR_NONE;
-	char query[MAX_QUERY_SIZE];
-	memset(query, '\0', sizeof(query));
+	query_builder_s query;
 
-	if(db_handle == NULL)
+	if(!STRING_VALID(select_query))
 	{
-		media_content_error("DB_FAILED(0x%08x) database is not connected", MEDIA_CONTENT_ERROR_DB_FAILED);
-		return MEDIA_CONTENT_ERROR_DB_FAILED;
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
 	}
 
-	if(STRING_VALID(select_query)) {
-		if(!STRING_VALID(condition_query)) {
-			condition_query = " ";
-		}
+	if(!STRING_VALID(condition_query) && !STRING_VALID(option_query))
+		return _content_query_prepare_str(stmt, select_query);
 
-		if(!STRING_VALID(option_query)) {
-			option_query = " ";
+	_content_query_builder_init(&query);
+	_content_query_builder_append(&query, select_query);
+	_content_query_builder_append(&query, QUERY_KEYWORD_SPACE);
+	if(STRING_VALID(condition_query))
+		_content_query_builder_append(&query, condition_query);
+	_content_query_builder_append(&query, QUERY_KEYWORD_SPACE);
+	if(STRING_VALID(option_query))
+		_content_query_builder_append(&query, option_query);
 
-		}
+	err = _content_query_builder_prepare(&query, stmt);
+	_content_query_builder_release(&query);
 
-		//query = sqlite3_mprintf("%s %s %s", select_query, condition_query, option_query);
-		len = snprintf(query, sizeof(query), "%s %s %s", select_query, condition_query, option_query);
-		if (len > 0) {
-			query[len] = '\0';
-		} else {
-			media_content_error("snprintf failed");
-			return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
-		}
+	return err;
+}
+
+void _content_query_finalize(sqlite3_stmt *stmt)
+{
+	sqlite3 *db = NULL;
+	read_conn_s *conn = NULL;
+	GList *iter = NULL;
+
+	if(stmt == NULL)
+		return;
+
+	_media_query_stats_finish(stmt);
+
+	/* Statements owned by a cache are only reset; others are finalized */
+	db = sqlite3_db_handle(stmt);
+
+	if(db_handle != NULL && db == (sqlite3*)db_handle)
+	{
+		pthread_mutex_lock(&g_writer_mutex);
+		_content_stmt_cache_release(g_stmt_cache, stmt);
+		pthread_mutex_unlock(&g_writer_mutex);
+		return;
+	}
+
+	/* Only the owning thread replaces its connection, so its own one is checked without g_content_mutex */
+	pthread_once(&g_read_conn_once, __media_content_read_conn_key_create);
+	conn = (read_conn_s*)pthread_getspecific(g_read_conn_key);
 
-		media_content_debug("Query : [%s]", query);
+	if(conn == NULL || conn->db != db)
+	{
+		pthread_mutex_lock(&g_content_mutex);
 
-		err = sqlite3_prepare_v2((sqlite3*)db_handle, query, strlen(query), stmt, NULL);
-		if(err != SQLITE_OK)
+		for(iter = g_read_conn_list; iter != NULL; iter = iter->next)
 		{
-			media_content_error("DB_FAILED(0x%08x) fail to sqlite3_prepare(), %s", MEDIA_CONTENT_ERROR_DB_FAILED, sqlite3_errmsg((sqlite3*)db_handle));
+			conn = (read_conn_s*)iter->data;
+			if(conn->db == db)
+				break;
+		}
 
-			if (err == SQLITE_BUSY)
-				return MEDIA_CONTENT_ERROR_DB_BUSY;
-			else
-				return MEDIA_CONTENT_ERROR_DB_FAILED;
+		if(iter != NULL)
+		{
+			pthread_mutex_lock(&conn->lock);
+			_content_stmt_cache_release(conn->stmt_cache, stmt);
+			pthread_mutex_unlock(&conn->lock);
+		}
+		else
+		{
+			/* Uncached, or left behind by a connection which has been closed */
+			sqlite3_finalize(stmt);
 		}
+
+		pthread_mutex_unlock(&g_content_mutex);
+		return;
+	}
+
+	pthread_mutex_lock(&conn->lock);
+	_content_stmt_cache_release(conn->stmt_cache, stmt);
+	pthread_mutex_unlock(&conn->lock);
+}
+
+static int __media_content_bind_error(sqlite3_stmt *stmt, int err)
+{
+	if(err == SQLITE_OK)
+		return MEDIA_CONTENT_ERROR_NONE;
+
+	media_content_error("DB_FAILED(0x%08x) fail to bind, %s", MEDIA_CONTENT_ERROR_DB_FAILED, sqlite3_errmsg(sqlite3_db_handle(stmt)));
+
+	if(err == SQLITE_NOMEM)
+		return MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
+	else
+		return MEDIA_CONTENT_ERROR_DB_FAILED;
+}
+
+int _content_query_bind_text(sqlite3_stmt *stmt, int index, const char *value)
+{
+	int err = SQLITE_OK;
+
+	if(stmt == NULL || index <= 0)
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
 	}
+
+	if(value == NULL)
+		err = sqlite3_bind_null(stmt, index);
 	else
+		err = sqlite3_bind_text(stmt, index, value, -1, SQLITE_TRANSIENT);
+
+	return __media_content_bind_error(stmt, err);
+}
+
+int _content_query_bind_int(sqlite3_stmt *stmt, int index, int value)
+{
+	if(stmt == NULL || index <= 0)
 	{
 		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
 		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
 	}
 
+	return __media_content_bind_error(stmt, sqlite3_bind_int(stmt, index, value));
+}
+
+int _content_query_step(sqlite3_stmt *stmt)
+{
+	int err = SQLITE_OK;
+	unsigned long long begin = _media_query_stats_begin();
+
+	err = sqlite3_step(stmt);
+	_media_query_stats_stepped(stmt, begin, (err == SQLITE_ROW) ? TRUE : FALSE);
+
+	return err;
+}
+
+int _content_query_step_done(sqlite3_stmt *stmt)
+{
+	int err = SQLITE_OK;
+
+	if(stmt == NULL)
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+
+	/* Writes of other threads must not end up inside an open transaction */
+	if(sqlite3_db_handle(stmt) == (sqlite3*)db_handle)
+	{
+		pthread_once(&g_transaction_once, __media_content_transaction_mutex_init);
+
+		pthread_mutex_lock(&g_transaction_mutex);
+		err = _content_query_step(stmt);
+		pthread_mutex_unlock(&g_transaction_mutex);
+	}
+	else
+	{
+		err = _content_query_step(stmt);
+	}
+
+	if(err != SQLITE_DONE && err != SQLITE_ROW)
+	{
+		media_content_error("DB_FAILED(0x%08x) fail to sqlite3_step(), %s", MEDIA_CONTENT_ERROR_DB_FAILED, sqlite3_errmsg(sqlite3_db_handle(stmt)));
+
+		if(err == SQLITE_BUSY)
+			return MEDIA_CONTENT_ERROR_DB_BUSY;
+		else
+			return MEDIA_CONTENT_ERROR_DB_FAILED;
+	}
+
 	return MEDIA_CONTENT_ERROR_NONE;
 }
 
@@ -532,7 +893,12 @@ int _content_query_sql(char *query_str)
 		return MEDIA_CONTENT_ERROR_DB_FAILED;
 	}
 
+	pthread_once(&g_transaction_once, __media_content_transaction_mutex_init);
+
+	pthread_mutex_lock(&g_transaction_mutex);
 	err = sqlite3_exec(db_handle, query_str, NULL, NULL, &err_msg);
+	pthread_mutex_unlock(&g_transaction_mutex);
+
 	if(SQLITE_OK != err)
 	{
 		if(err_msg)
@@ -551,7 +917,7 @@ int _content_query_sql(char *query_str)
 	}
 	else
 	{
-		media_content_debug("DB_SUCCESS: %s", query_str);
+		media_content_verbose("DB_SUCCESS: %s", query_str);
 	}
 
 	if(err_msg)
@@ -560,12 +926,57 @@ int _content_query_sql(char *query_str)
 	return MEDIA_CONTENT_ERROR_NONE;
 }
 
+int _content_transaction_begin(void)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+
+	pthread_once(&g_transaction_once, __media_content_transaction_mutex_init);
+
+	pthread_mutex_lock(&g_transaction_mutex);
+
+	/* IMMEDIATE takes the write lock up front, so the batch can not fail half way with SQLITE_BUSY */
+	ret = _content_query_sql("BEGIN IMMEDIATE");
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+		pthread_mutex_unlock(&g_transaction_mutex);
+
+	return ret;
+}
+
+int _content_transaction_commit(void)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+
+	ret = _content_query_sql("COMMIT");
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+		_content_query_sql("ROLLBACK");
+
+	pthread_mutex_unlock(&g_transaction_mutex);
+
+	return ret;
+}
+
+void _content_transaction_rollback(void)
+{
+	_content_query_sql("ROLLBACK");
+
+	pthread_mutex_unlock(&g_transaction_mutex);
+}
+
 int media_content_connect(void)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
+	const char *db_path = NULL;
+	const char *log_level = NULL;
+	bool opened = FALSE;
+
+	pthread_mutex_lock(&g_content_mutex);
 
 	if(ref_count == 0)
 	{
+		log_level = getenv(MEDIA_CONTENT_LOG_ENV);
+		if(STRING_VALID(log_level))
+			_content_log_level = atoi(log_level);
+
 		if(db_handle == NULL)
 		{
 			ret = media_svc_connect(&db_handle);
@@ -573,12 +984,41 @@ int media_content_connect(void)
 
 		ret = _content_error_capi(MEDIA_CONTENT_TYPE, ret);
 
-		if(ret == MEDIA_CONTENT_ERROR_NONE) {
+		/* Kept by a disconnect which had to leave the writer open */
+		if(ret == MEDIA_CONTENT_ERROR_NONE && g_attr_handle == NULL) {
 			ret = __media_content_create_attribute_handle();
 		}
+
+		if(ret == MEDIA_CONTENT_ERROR_NONE && g_stmt_cache == NULL) {
+			ret = _content_stmt_cache_create((sqlite3*)db_handle, MEDIA_CONTENT_STMT_CACHE_SIZE, &g_stmt_cache);
+		}
+
+		if(ret == MEDIA_CONTENT_ERROR_NONE) {
+			/* WAL lets the per-thread read connections run alongside the writer */
+			if(_content_query_sql("PRAGMA journal_mode=WAL") != MEDIA_CONTENT_ERROR_NONE)
+				media_content_error("fail to switch to WAL, reads may wait for the writer");
+
+			db_path = sqlite3_db_filename((sqlite3*)db_handle, "main");
+			if(STRING_VALID(db_path))
+				g_db_path = strdup(db_path);
+
+			_media_query_stats_load();
+			opened = TRUE;
+		}
 	}
 
-	ref_count++;
+	/* A failed open is retried by the next connect */
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ref_count++;
+
+	pthread_mutex_unlock(&g_content_mutex);
+
+	/* Reads open the read connection of this thread, which takes g_content_mutex */
+	if(opened)
+	{
+		_media_group_summary_load();
+		_media_usage_load();
+	}
 
 	return ret;
 }
@@ -586,6 +1026,11 @@ int media_content_connect(void)
 int media_content_disconnect(void)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
+	read_conn_s *conn = NULL;
+
+	pthread_once(&g_read_conn_once, __media_content_read_conn_key_create);
+
+	pthread_mutex_lock(&g_content_mutex);
 
 	if(ref_count > 0)
 	{
@@ -593,13 +1038,39 @@ int media_content_disconnect(void)
 	}
 	else
 	{
+		pthread_mutex_unlock(&g_content_mutex);
 		media_content_error("DB_FAILED(0x%08x) database is not connected", MEDIA_CONTENT_ERROR_DB_FAILED);
 		return MEDIA_CONTENT_ERROR_DB_FAILED;
 	}
 
 	if(ref_count == 0)
 	{
-		if(db_handle != NULL)
+		/* Other threads close their connection on their next query, or when they exit */
+		g_atomic_int_inc(&g_read_conn_generation);
+
+		conn = (read_conn_s*)pthread_getspecific(g_read_conn_key);
+		if(conn != NULL)
+			__media_content_read_conn_close(conn);
+
+		SAFE_FREE(g_db_path);
+
+		pthread_mutex_lock(&g_writer_mutex);
+
+		if(g_stmt_cache != NULL)
+		{
+			/* Cached statements must be finalized before the connection is closed */
+			_content_stmt_cache_destroy(g_stmt_cache);
+			g_stmt_cache = NULL;
+		}
+
+		if(db_handle != NULL && sqlite3_next_stmt((sqlite3*)db_handle, NULL) != NULL)
+		{
+			/* Still stepped by another thread; the connection is reused by the next connect,
+			 * or closed by the next last disconnect */
+			media_content_error("DB_BUSY(0x%08x) statements of the writer connection are still open", MEDIA_CONTENT_ERROR_DB_BUSY);
+			ret = MEDIA_CONTENT_ERROR_DB_BUSY;
+		}
+		else if(db_handle != NULL)
 		{
 			ret = media_svc_disconnect(db_handle);
 			ret = _content_error_capi(MEDIA_CONTENT_TYPE, ret);
@@ -609,7 +1080,30 @@ int media_content_disconnect(void)
 				db_handle = NULL;
 			}
 		}
+
+		pthread_mutex_unlock(&g_writer_mutex);
 	}
 
+	pthread_mutex_unlock(&g_content_mutex);
+
 	return ret;
 }
+
+int media_content_create_indexes(void)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+
+	media_content_debug_func();
+
+	ret = _content_transaction_begin();
+	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
+
+	ret = _content_query_sql(CREATE_MEDIA_FILTER_INDEXES);
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+	{
+		_content_transaction_rollback();
+		return ret;
+	}
+
+	return _content_transaction_commit();
+}
@@ -0,0 +1,209 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include <media_content.h>
+#include <media_info_private.h>
+
+
+static int __media_cursor_open(const char *group_name, filter_h filter, group_list_e group_type, int prefetch_count, media_cursor_h *cursor);
+static int __media_cursor_fill_page(media_cursor_s *cursor);
+
+static int __media_cursor_open(const char *group_name, filter_h filter, group_list_e group_type, int prefetch_count, media_cursor_h *cursor)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	media_cursor_s *_cursor = NULL;
+
+	if(cursor == NULL || prefetch_count < 0)
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+
+	_cursor = (media_cursor_s*)calloc(1, sizeof(media_cursor_s));
+	if(_cursor == NULL)
+	{
+		media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
+		return MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
+	}
+
+	_cursor->prefetch_count = (prefetch_count > 0) ? prefetch_count : MEDIA_CURSOR_DEFAULT_PREFETCH;
+	_cursor->field_groups = (filter != NULL) ? ((filter_s*)filter)->field_groups : MEDIA_CONTENT_FIELD_ALL;
+	_cursor->position = -1;
+
+	_cursor->page = (media_info_s**)calloc(_cursor->prefetch_count, sizeof(media_info_s*));
+	if(_cursor->page == NULL)
+	{
+		SAFE_FREE(_cursor);
+		media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
+		return MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
+	}
+
+	ret = _media_db_open_group_item(group_name, filter, group_type, &_cursor->stmt);
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+	{
+		SAFE_FREE(_cursor->page);
+		SAFE_FREE(_cursor);
+		return ret;
+	}
+
+	_content_arena_init(&_cursor->arena);
+	pthread_mutex_init(&_cursor->mutex, NULL);
+
+	*cursor = (media_cursor_h)_cursor;
+
+	return MEDIA_CONTENT_ERROR_NONE;
+}
+
+/* Replaces the current page with the next prefetch_count rows. The statement is
+ * finalized as soon as it is done, so a fully read cursor holds no read snapshot. */
+static int __media_cursor_fill_page(media_cursor_s *cursor)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	int err = SQLITE_OK;
+	media_info_s *item = NULL;
+
+	_content_arena_reset(&cursor->arena);
+	cursor->page_count = 0;
+	cursor->position = -1;
+
+	while(cursor->stmt != NULL && cursor->page_count < cursor->prefetch_count)
+	{
+		err = _content_query_step(cursor->stmt);
+		if(err != SQLITE_ROW)
+		{
+			if(err != SQLITE_DONE)
+			{
+				media_content_error("DB_FAILED(0x%08x) fail to sqlite3_step(), %s", MEDIA_CONTENT_ERROR_DB_FAILED, sqlite3_errmsg(sqlite3_db_handle(cursor->stmt)));
+				ret = MEDIA_CONTENT_ERROR_DB_FAILED;
+			}
+
+			SQLITE3_FINALIZE(cursor->stmt);
+			break;
+		}
+
+		item = (media_info_s*)_content_arena_alloc(&cursor->arena, sizeof(media_info_s));
+		if(item == NULL)
+		{
+			media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
+			ret = MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
+			break;
+		}
+
+		_media_info_item_get_detail(cursor->stmt, (media_info_h)item, cursor->field_groups, &cursor->arena);
+		cursor->page[cursor->page_count++] = item;
+	}
+
+	return ret;
+}
+
+int media_cursor_open(filter_h filter, int prefetch_count, media_cursor_h *cursor)
+{
+	media_content_debug_func();
+
+	return __media_cursor_open(NULL, filter, MEDIA_GROUP_NONE, prefetch_count, cursor);
+}
+
+int media_cursor_open_by_folder(const char *folder_id, filter_h filter, int prefetch_count, media_cursor_h *cursor)
+{
+	media_content_debug_func();
+
+	if(!STRING_VALID(folder_id))
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+
+	return __media_cursor_open(folder_id, filter, MEDIA_GROUP_FOLDER, prefetch_count, cursor);
+}
+
+int media_cursor_next(media_cursor_h cursor, bool *available)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	media_cursor_s *_cursor = (media_cursor_s*)cursor;
+
+	if(_cursor == NULL || available == NULL)
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+
+	pthread_mutex_lock(&_cursor->mutex);
+
+	if(_cursor->position + 1 < _cursor->page_count)
+	{
+		_cursor->position++;
+	}
+	else
+	{
+		ret = __media_cursor_fill_page(_cursor);
+		if(ret == MEDIA_CONTENT_ERROR_NONE && _cursor->page_count > 0)
+			_cursor->position = 0;
+	}
+
+	*available = (ret == MEDIA_CONTENT_ERROR_NONE && _cursor->position >= 0) ? TRUE : FALSE;
+
+	pthread_mutex_unlock(&_cursor->mutex);
+
+	return ret;
+}
+
+int media_cursor_get_media(media_cursor_h cursor, media_info_h *media)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	media_cursor_s *_cursor = (media_cursor_s*)cursor;
+
+	if(_cursor == NULL || media == NULL)
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+
+	pthread_mutex_lock(&_cursor->mutex);
+
+	if(_cursor->position >= 0 && _cursor->position < _cursor->page_count)
+	{
+		*media = (media_info_h)_cursor->page[_cursor->position];
+	}
+	else
+	{
+		media_content_error("INVALID_OPERATION(0x%08x) cursor is not on a row", MEDIA_CONTENT_ERROR_INVALID_OPERATION);
+		ret = MEDIA_CONTENT_ERROR_INVALID_OPERATION;
+	}
+
+	pthread_mutex_unlock(&_cursor->mutex);
+
+	return ret;
+}
+
+int media_cursor_close(media_cursor_h cursor)
+{
+	media_cursor_s *_cursor = (media_cursor_s*)cursor;
+
+	if(_cursor == NULL)
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+
+	SQLITE3_FINALIZE(_cursor->stmt);
+	_content_arena_release(&_cursor->arena);
+	pthread_mutex_destroy(&_cursor->mutex);
+	SAFE_FREE(_cursor->page);
+	SAFE_FREE(_cursor);
+
+	return MEDIA_CONTENT_ERROR_NONE;
+}
@@ -19,6 +19,15 @@
 #include <media_info_private.h>
 
 static char * __media_db_get_group_name(media_group_e group);
+static int __media_db_get_count(query_builder_s *query, int *count);
+static int __media_db_get_media_item(query_builder_s *query, filter_h filter, int batch_size, media_info_cb callback, media_info_batch_cb batch_callback, void *user_data);
+static bool __media_db_add_media_columns(sqlite3_stmt *stmt, media_info_columns_s *columns);
+static int __media_db_make_group_item_query(const char *group_name, filter_h filter, group_list_e group_type, query_builder_s *query);
+static int __media_db_get_media_group(media_group_e group, filter_h filter, media_group_cb callback, media_group_count_cb count_callback, void *user_data);
+static int __media_db_get_album(filter_h filter, media_album_cb callback, media_album_count_cb count_callback, void *user_data);
+static int __media_db_get_folder(filter_h filter, media_folder_cb callback, media_folder_count_cb count_callback, void *user_data);
+static int __media_db_get_playlist(filter_h filter, media_playlist_cb callback, media_playlist_count_cb count_callback, void *user_data);
+static int __media_db_get_tag(const char *media_id, filter_h filter, media_tag_cb callback, media_tag_count_cb count_callback, void *user_data);
 
 static char * __media_db_get_group_name(media_group_e group)
 {
@@ -83,19 +92,220 @@ static char * __media_db_get_group_name(media_group_e group)
 	return NULL;
 }
 
-int _media_db_get_group_count(filter_h filter, group_list_e group_type, int *group_count)
+/* Numeric fields media_info_get_aggregate_from_db() accepts, as user attributes */
+static const char *g_aggregate_fields[] =
+{
+	MEDIA_SIZE,
+	MEDIA_DURATION,
+	MEDIA_BITRATE,
+	MEDIA_WIDTH,
+	MEDIA_HEIGHT,
+	MEDIA_RATING,
+	MEDIA_PLAYED_COUNT,
+};
+
+/* Indexed by media_content_aggregate_e */
+static const char *g_aggregate_functions[] =
+{
+	"COUNT",
+	"SUM",
+	"MIN",
+	"MAX",
+	"AVG",
+};
+
+static int __media_db_get_count(query_builder_s *query, int *count)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	sqlite3_stmt *stmt = NULL;
+
+	ret = _content_query_builder_prepare(query, &stmt);
+	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
+
+	while(_content_query_step(stmt) == SQLITE_ROW)
+	{
+		*count = (int)sqlite3_column_int(stmt, 0);
+		media_content_debug("count : [%d]", *count);
+	}
+
+	SQLITE3_FINALIZE(stmt);
+
+	return ret;
+}
+
+/* Rows go to callback one by one, or to batch_callback batch_size at a time if it is set */
+static int __media_db_get_media_item(query_builder_s *query, filter_h filter, int batch_size, media_info_cb callback, media_info_batch_cb batch_callback, void *user_data)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
 	sqlite3_stmt *stmt = NULL;
-	filter_s *_filter = NULL;
-	char select_query[DEFAULT_QUERY_SIZE];
-	char *condition_query = NULL;
-	char *option_query = NULL;
+	int field_groups = (filter != NULL) ? ((filter_s*)filter)->field_groups : MEDIA_CONTENT_FIELD_ALL;
+	content_arena_s arena;
+	media_info_h *items = NULL;
+	int count = 0;
+	bool cont = TRUE;
+	bool seek = FALSE;
+	char *last_token = NULL;
+	int last_token_size = 0;
+
+	if(batch_callback != NULL)
+	{
+		items = (media_info_h*)calloc(batch_size, sizeof(media_info_h));
+		if(items == NULL)
+		{
+			media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
+			return MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
+		}
+	}
+
+	ret = _content_query_builder_prepare(query, &stmt);
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+	{
+		SAFE_FREE(items);
+		return ret;
+	}
+
+	/* The handles are only borrowed by the callback, so the rows are carved from
+	 * an arena which is rewound for the next row or batch instead of freed field by field. */
+	_content_arena_init(&arena);
+
+	/* A list with a continuation token also reads the order key, so the token of its last row is ready without another query */
+	seek = (sqlite3_column_count(stmt) > MEDIA_SEEK_KEY_COLUMN);
+
+	while(cont && _content_query_step(stmt) == SQLITE_ROW)
+	{
+		media_info_s *item = (media_info_s*)_content_arena_alloc(&arena, sizeof(media_info_s));
+		if(item == NULL)
+		{
+			media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
+			ret = MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
+			break;
+		}
+
+		_media_info_item_get_detail(stmt, (media_info_h)item, field_groups, &arena);
+
+		if(seek && STRING_VALID(item->media_id))
+		{
+			ret = _media_filter_make_seek_token(stmt, MEDIA_SEEK_KEY_COLUMN, item->media_id, &last_token, &last_token_size);
+			if(ret != MEDIA_CONTENT_ERROR_NONE)
+				break;
+		}
+
+		if(items == NULL)
+		{
+			cont = callback((media_info_h)item, user_data);
+			_content_arena_reset(&arena);
+			continue;
+		}
+
+		items[count++] = (media_info_h)item;
+		if(count == batch_size)
+		{
+			cont = batch_callback(items, count, user_data);
+			count = 0;
+			_content_arena_reset(&arena);
+		}
+	}
+
+	/* The last rows. After an error the rows of the unfinished batch are dropped with the arena */
+	if(ret == MEDIA_CONTENT_ERROR_NONE && cont && count > 0)
+		batch_callback(items, count, user_data);
+
+	_content_arena_release(&arena);
+	SQLITE3_FINALIZE(stmt);
+	SAFE_FREE(items);
+
+	if(seek && ret == MEDIA_CONTENT_ERROR_NONE && last_token != NULL)
+		_media_filter_set_last_seek_token(filter, last_token);
+	else
+		SAFE_FREE(last_token);
+
+	return ret;
+}
+
+typedef enum
+{
+	MEDIA_COLUMN_SIZE,
+	MEDIA_COLUMN_TYPE,
+	MEDIA_COLUMN_ADDED_TIME,
+	MEDIA_COLUMN_PATH,
+}media_columns_e;
+
+/* Appends the row to the columns which are set. FALSE if its path does not fit in what is left of the path buffer */
+static bool __media_db_add_media_columns(sqlite3_stmt *stmt, media_info_columns_s *columns)
+{
+	int row = columns->count;
+	int used = 0;
+	int len = 0;
+
+	if(columns->path_offset != NULL)
+	{
+		used = columns->path_offset[row];
+		len = sqlite3_column_bytes(stmt, MEDIA_COLUMN_PATH);
+		if(used + len + 1 > columns->path_capacity)
+			return FALSE;
+
+		if(len > 0)
+			memcpy(columns->path + used, sqlite3_column_text(stmt, MEDIA_COLUMN_PATH), len);
+		columns->path[used + len] = '\0';
+		columns->path_offset[row + 1] = used + len + 1;
+	}
+
+	if(columns->size != NULL)
+		columns->size[row] = (unsigned long long)sqlite3_column_int64(stmt, MEDIA_COLUMN_SIZE);
+	if(columns->media_type != NULL)
+		columns->media_type[row] = sqlite3_column_int(stmt, MEDIA_COLUMN_TYPE);
+	if(columns->added_time != NULL)
+		columns->added_time[row] = (time_t)sqlite3_column_int64(stmt, MEDIA_COLUMN_ADDED_TIME);
+
+	columns->count++;
+
+	return TRUE;
+}
+
+static int __media_db_make_group_item_query(const char *group_name, filter_h filter, group_list_e group_type, query_builder_s *query)
+{
+	if(group_type == MEDIA_GROUP_NONE)
+	{
+		_media_info_append_columns(query, filter);
+		_media_filter_append_seek_column(filter, query);
+		_content_query_builder_append(query, FROM_MEDIA_ITEM);
+	}
+	else if(group_type == MEDIA_GROUP_FOLDER)
+	{
+		_media_info_append_columns(query, filter);
+		_media_filter_append_seek_column(filter, query);
+		_content_query_builder_append(query, FROM_MEDIA_BY_FOLDER);
+		_content_query_builder_bind_text(query, group_name);
+	}
+	else if(group_type == MEDIA_GROUP_BOOKMARK_BY_MEDIA_ID)
+	{
+		_content_query_builder_appendf(query, SELECT_BOOKMARK_LIST_BY_MEDIA_ID, group_name);
+
+		return _media_filter_attribute_append_query(_content_get_attirbute_handle(), filter, query);
+	}
+	else
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+
+	return _media_filter_attribute_append_media_query(_content_get_attirbute_handle(), filter, query);
+}
+
+int _media_db_get_group_count(filter_h filter, group_list_e group_type, int *group_count)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	query_builder_s query;
+	const char *select_query = NULL;
 	attribute_h attr;
 
 	media_content_debug_func();
 
-	memset(select_query, 0x00, sizeof(select_query));
+	if(group_type == MEDIA_GROUP_ALBUM && _media_group_summary_is_usable(GROUP_SUMMARY_ALBUM, filter))
+	{
+		if(_media_group_summary_get_group_count(GROUP_SUMMARY_ALBUM, group_count) == MEDIA_CONTENT_ERROR_NONE)
+			return MEDIA_CONTENT_ERROR_NONE;
+	}
 
 	attr = _content_get_attirbute_handle();
 
@@ -110,84 +320,32 @@ int _media_db_get_group_count(filter_h filter, group_list_e group_type, int *gro
 			break;
 		case MEDIA_GROUP_ALBUM:
 			attr = _content_get_alias_attirbute_handle();
-			//snprintf(select_query, sizeof(select_query), SELECT_ALBUM_COUNT);
-			if(!SAFE_STRLCPY(select_query, SELECT_ALBUM_COUNT, sizeof(select_query)))
-			{
-				media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
-				return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
-			}
-
+			select_query = SELECT_ALBUM_COUNT;
 			break;
 		case MEDIA_GROUP_FOLDER:
 			attr = _content_get_alias_attirbute_handle();
-			//snprintf(select_query, sizeof(select_query), SELECT_FOLDER_COUNT);
-			if(!SAFE_STRLCPY(select_query, SELECT_FOLDER_COUNT, sizeof(select_query)))
-			{
-				media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
-				return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
-			}
+			select_query = SELECT_FOLDER_COUNT;
 			break;
 		case MEDIA_GROUP_PLAYLIST:
-			//attr = _content_get_alias_attirbute_handle();
-			//snprintf(select_query, sizeof(select_query), SELECT_PLAYLIST_COUNT);
-			if(!SAFE_STRLCPY(select_query, SELECT_PLAYLIST_COUNT, sizeof(select_query)))
-			{
-				media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
-				return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
-			}
+			select_query = SELECT_PLAYLIST_COUNT;
 			break;
 		case MEDIA_GROUP_TAG:
-			//attr = _content_get_alias_attirbute_handle();
-			//snprintf(select_query, sizeof(select_query), SELECT_TAG_COUNT);
-			if(!SAFE_STRLCPY(select_query, SELECT_TAG_COUNT, sizeof(select_query)))
-			{
-				media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
-				return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
-			}
+			select_query = SELECT_TAG_COUNT;
 			break;
 		case MEDIA_GROUP_BOOKMARK:
 			attr = _content_get_alias_attirbute_handle();
-			//snprintf(select_query, sizeof(select_query), SELECT_BOOKMARK_COUNT);
-			if(!SAFE_STRLCPY(select_query, SELECT_BOOKMARK_COUNT, sizeof(select_query)))
-			{
-				media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
-				return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
-			}
+			select_query = SELECT_BOOKMARK_COUNT;
 			break;
 	}
 
-	if(filter != NULL)
-	{
-		_filter = (filter_s*)filter;
-
-		if(STRING_VALID(_filter->condition))
-		{
-			ret = _media_filter_attribute_generate(attr, _filter->condition, _filter->condition_collate_type, &condition_query);
-			media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
-		}
-
-		ret = _media_filter_attribute_option_generate(attr, filter, &option_query);
-		media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
-
-		if(STRING_VALID(condition_query))
-		{
-			SAFE_STRLCAT(select_query, QUERY_KEYWORD_SPACE, sizeof(select_query));
-			SAFE_STRLCAT(select_query, QUERY_KEYWORD_AND, sizeof(select_query));
-		}
-	}
-
-	ret = _content_query_prepare(&stmt, select_query, condition_query, option_query);
-	SAFE_FREE(condition_query);
-	SAFE_FREE(option_query);
-	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
+	_content_query_builder_init(&query);
+	_content_query_builder_append(&query, select_query);
 
-	while(sqlite3_step(stmt) == SQLITE_ROW)
-	{
-		*group_count = (int)sqlite3_column_int(stmt, 0);
-		media_content_debug("group count : [%d]", *group_count);
-	}
+	ret = _media_filter_attribute_append_query(attr, filter, &query);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = __media_db_get_count(&query, group_count);
 
-	SQLITE3_FINALIZE(stmt);
+	_content_query_builder_release(&query);
 
 	return ret;
 }
@@ -195,119 +353,82 @@ int _media_db_get_group_count(filter_h filter, group_list_e group_type, int *gro
 int _media_db_get_media_group_count(media_group_e group, filter_h filter, int *group_count)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
-	sqlite3_stmt *stmt = NULL;
-	filter_s *_filter = NULL;
-	char select_query[DEFAULT_QUERY_SIZE];
-	char *condition_query = NULL;
-	char *option_query = NULL;
+	query_builder_s query;
 
 	media_content_debug_func();
 
-	memset(select_query, 0x00, sizeof(select_query));
-
-	snprintf(select_query, sizeof(select_query), SELECT_MEDIA_GROUP_COUNT, __media_db_get_group_name(group));
-
-	if(filter != NULL)
+	if(_media_group_summary_is_usable(group, filter))
 	{
-		_filter = (filter_s*)filter;
-
-		if(STRING_VALID(_filter->condition))
-		{
-			ret = _media_filter_attribute_generate(_content_get_attirbute_handle(), _filter->condition, _filter->condition_collate_type, &condition_query);
-			media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
-		}
-
-		ret = _media_filter_attribute_option_generate(_content_get_attirbute_handle(), filter, &option_query);
-		media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
-
-		if(STRING_VALID(condition_query))
-		{
-			SAFE_STRLCAT(select_query, QUERY_KEYWORD_SPACE, sizeof(select_query));
-			SAFE_STRLCAT(select_query, QUERY_KEYWORD_AND, sizeof(select_query));
-		}
-
-		SAFE_STRLCAT(select_query, QUERY_KEYWORD_SPACE, sizeof(select_query));
-		if(STRING_VALID(condition_query))
-			SAFE_STRLCAT(select_query, condition_query, sizeof(select_query));
-		if(STRING_VALID(option_query))
-			SAFE_STRLCAT(select_query, option_query, sizeof(select_query));
-
-		SAFE_FREE(condition_query);
-		SAFE_FREE(option_query);
+		if(_media_group_summary_get_group_count(group, group_count) == MEDIA_CONTENT_ERROR_NONE)
+			return MEDIA_CONTENT_ERROR_NONE;
 	}
 
-	SAFE_STRLCAT(select_query, QUERY_KEYWORD_BRACKET, sizeof(select_query));
+	_content_query_builder_init(&query);
+	_content_query_builder_appendf(&query, SELECT_MEDIA_GROUP_COUNT, __media_db_get_group_name(group));
 
-	ret = _content_query_prepare(&stmt, select_query, condition_query, option_query);
-	SAFE_FREE(condition_query);
-	SAFE_FREE(option_query);
-	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
+	ret = _media_filter_attribute_append_query(_content_get_attirbute_handle(), filter, &query);
+	_content_query_builder_append(&query, QUERY_KEYWORD_BRACKET);
 
-	while(sqlite3_step(stmt) == SQLITE_ROW)
-	{
-		*group_count = (int)sqlite3_column_int(stmt, 0);
-		media_content_debug("group count : [%d]", *group_count);
-	}
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = __media_db_get_count(&query, group_count);
 
-	SQLITE3_FINALIZE(stmt);
+	_content_query_builder_release(&query);
 
 	return ret;
 }
 
-int _media_db_get_media_group(media_group_e group, filter_h filter, media_group_cb callback, void *user_data)
+/* With count_callback, the groups and their media count come from one GROUP BY query
+ * instead of one count query per group */
+static int __media_db_get_media_group(media_group_e group, filter_h filter, media_group_cb callback, media_group_count_cb count_callback, void *user_data)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
-	char select_query[DEFAULT_QUERY_SIZE];
-	char *condition_query = NULL;
-	char *option_query = NULL;
+	query_builder_s query;
 	char *name = NULL;
 	sqlite3_stmt *stmt = NULL;
-	filter_s *_filter = NULL;
-
-	memset(select_query, 0x00, sizeof(select_query));
+	bool cont = TRUE;
 
-	snprintf(select_query, sizeof(select_query), SELECT_MEDIA_GROUP_LIST, __media_db_get_group_name(group));
-
-	if(filter != NULL)
+	if(count_callback != NULL && _media_group_summary_is_usable(group, filter))
 	{
-		_filter = (filter_s*)filter;
-
-		if(_filter->condition)
-		{
-			ret = _media_filter_attribute_generate(_content_get_attirbute_handle(), _filter->condition, _filter->condition_collate_type, &condition_query);
-			media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
-		}
+		if(_media_group_summary_foreach(group, count_callback, user_data) == MEDIA_CONTENT_ERROR_NONE)
+			return MEDIA_CONTENT_ERROR_NONE;
+	}
 
-		ret = _media_filter_attribute_option_generate(_content_get_attirbute_handle(), filter, &option_query);
-		media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
+	_content_query_builder_init(&query);
 
-		if(STRING_VALID(condition_query))
-		{
-			SAFE_STRLCAT(select_query, QUERY_KEYWORD_SPACE, sizeof(select_query));
-			SAFE_STRLCAT(select_query, QUERY_KEYWORD_AND, sizeof(select_query));
-		}
+	if(count_callback != NULL)
+	{
+		_content_query_builder_appendf(&query, SELECT_MEDIA_GROUP_LIST_WITH_COUNT, __media_db_get_group_name(group));
+		ret = _media_filter_attribute_append_group_query(_content_get_attirbute_handle(), filter, __media_db_get_group_name(group), &query);
+	}
+	else
+	{
+		_content_query_builder_appendf(&query, SELECT_MEDIA_GROUP_LIST, __media_db_get_group_name(group));
+		ret = _media_filter_attribute_append_query(_content_get_attirbute_handle(), filter, &query);
 	}
 
-	ret = _content_query_prepare(&stmt, select_query, condition_query, option_query);
-	SAFE_FREE(condition_query);
-	SAFE_FREE(option_query);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = _content_query_builder_prepare(&query, &stmt);
+
+	_content_query_builder_release(&query);
 	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
 
-	while(sqlite3_step(stmt) == SQLITE_ROW)
+	while(_content_query_step(stmt) == SQLITE_ROW)
 	{
 		if(STRING_VALID((const char *)sqlite3_column_text(stmt, 0)))
 		{
 			name = strdup((const char *)sqlite3_column_text(stmt, 0));
-			media_content_debug("group name : [%s]", name);
+			media_content_verbose("group name : [%s]", name);
 		}
 
-		if(callback(name, user_data) == false)
-		{
-			SAFE_FREE(name);
-			break;
-		}
+		if(count_callback != NULL)
+			cont = count_callback(name, (int)sqlite3_column_int(stmt, 1), user_data);
+		else
+			cont = callback(name, user_data);
 
 		SAFE_FREE(name);
+
+		if(cont == false)
+			break;
 	}
 
 	SQLITE3_FINALIZE(stmt);
@@ -315,50 +436,41 @@ int _media_db_get_media_group(media_group_e group, filter_h filter, media_group_
 	return ret;
 }
 
-int _media_db_get_album(filter_h filter, media_album_cb callback, void *user_data)
+int _media_db_get_media_group(media_group_e group, filter_h filter, media_group_cb callback, void *user_data)
+{
+	return __media_db_get_media_group(group, filter, callback, NULL, user_data);
+}
+
+int _media_db_get_media_group_with_count(media_group_e group, filter_h filter, media_group_count_cb callback, void *user_data)
+{
+	return __media_db_get_media_group(group, filter, NULL, callback, user_data);
+}
+
+static int __media_db_get_album(filter_h filter, media_album_cb callback, media_album_count_cb count_callback, void *user_data)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
-	char select_query[DEFAULT_QUERY_SIZE];
-	char *condition_query = NULL;
-	char *option_query = NULL;
+	query_builder_s query;
 	sqlite3_stmt *stmt = NULL;
-	filter_s *_filter = NULL;
-
-	memset(select_query, 0x00, sizeof(select_query));
+	bool cont = TRUE;
 
-	//snprintf(select_query, sizeof(select_query), SELECT_ALBUM_LIST);
-	if(!SAFE_STRLCPY(select_query, SELECT_ALBUM_LIST, sizeof(select_query)))
+	_content_query_builder_init(&query);
+	if(count_callback != NULL)
 	{
-		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
-		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+		_content_query_builder_append(&query, SELECT_ALBUM_LIST_WITH_COUNT);
+		ret = _media_filter_attribute_append_group_query(_content_get_alias_attirbute_handle(), filter, ALBUM_GROUP_BY, &query);
 	}
-
-	if(filter != NULL)
+	else
 	{
-		_filter = (filter_s*)filter;
-
-		if(_filter->condition)
-		{
-			ret = _media_filter_attribute_generate(_content_get_alias_attirbute_handle(), _filter->condition, _filter->condition_collate_type, &condition_query);
-			media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
-		}
-
-		ret = _media_filter_attribute_option_generate(_content_get_alias_attirbute_handle(), filter, &option_query);
-		media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
-
-		if(STRING_VALID(condition_query))
-		{
-			SAFE_STRLCAT(select_query, QUERY_KEYWORD_SPACE, sizeof(select_query));
-			SAFE_STRLCAT(select_query, QUERY_KEYWORD_AND, sizeof(select_query));
-		}
+		_content_query_builder_append(&query, SELECT_ALBUM_LIST);
+		ret = _media_filter_attribute_append_query(_content_get_alias_attirbute_handle(), filter, &query);
 	}
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = _content_query_builder_prepare(&query, &stmt);
 
-	ret = _content_query_prepare(&stmt, select_query, condition_query, option_query);
-	SAFE_FREE(condition_query);
-	SAFE_FREE(option_query);
+	_content_query_builder_release(&query);
 	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
 
-	while(sqlite3_step(stmt) == SQLITE_ROW)
+	while(_content_query_step(stmt) == SQLITE_ROW)
 	{
 		media_album_s *album = (media_album_s*)calloc(1, sizeof(media_album_s));
 
@@ -380,13 +492,15 @@ int _media_db_get_album(filter_h filter, media_album_cb callback, void *user_dat
 		if(STRING_VALID((const char *)sqlite3_column_text(stmt, 3)))
 			album->album_art_path = strdup((const char *)sqlite3_column_text(stmt, 3));
 
-		if(callback((media_album_h)album, user_data) == false)
-		{
-			media_album_destroy((media_album_h)album);
-			break;
-		}
+		if(count_callback != NULL)
+			cont = count_callback((media_album_h)album, (int)sqlite3_column_int(stmt, 4), user_data);
+		else
+			cont = callback((media_album_h)album, user_data);
 
 		media_album_destroy((media_album_h)album);
+
+		if(cont == false)
+			break;
 	}
 
 	SQLITE3_FINALIZE(stmt);
@@ -394,50 +508,41 @@ int _media_db_get_album(filter_h filter, media_album_cb callback, void *user_dat
 	return ret;
 }
 
-int _media_db_get_folder(filter_h filter, media_folder_cb callback, void *user_data)
+int _media_db_get_album(filter_h filter, media_album_cb callback, void *user_data)
+{
+	return __media_db_get_album(filter, callback, NULL, user_data);
+}
+
+int _media_db_get_album_with_count(filter_h filter, media_album_count_cb callback, void *user_data)
+{
+	return __media_db_get_album(filter, NULL, callback, user_data);
+}
+
+static int __media_db_get_folder(filter_h filter, media_folder_cb callback, media_folder_count_cb count_callback, void *user_data)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
-	char select_query[DEFAULT_QUERY_SIZE];
-	char *condition_query = NULL;
-	char *option_query = NULL;
+	query_builder_s query;
 	sqlite3_stmt *stmt = NULL;
-	filter_s *_filter = NULL;
+	bool cont = TRUE;
 
-	memset(select_query, 0x00, sizeof(select_query));
-
-	//snprintf(select_query, sizeof(select_query), SELECT_FOLDER_LIST);
-	if(!SAFE_STRLCPY(select_query, SELECT_FOLDER_LIST, sizeof(select_query)))
+	_content_query_builder_init(&query);
+	if(count_callback != NULL)
 	{
-		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
-		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+		_content_query_builder_append(&query, SELECT_FOLDER_LIST_WITH_COUNT);
+		ret = _media_filter_attribute_append_group_query(_content_get_alias_attirbute_handle(), filter, FOLDER_GROUP_BY, &query);
 	}
-
-	if(filter != NULL)
+	else
 	{
-		_filter = (filter_s*)filter;
-
-		if(_filter->condition)
-		{
-			ret = _media_filter_attribute_generate(_content_get_alias_attirbute_handle(), _filter->condition, _filter->condition_collate_type, &condition_query);
-			media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
-		}
-
-		ret = _media_filter_attribute_option_generate(_content_get_alias_attirbute_handle(), filter, &option_query);
-		media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
-
-		if(STRING_VALID(condition_query))
-		{
-			SAFE_STRLCAT(select_query, QUERY_KEYWORD_SPACE, sizeof(select_query));
-			SAFE_STRLCAT(select_query, QUERY_KEYWORD_AND, sizeof(select_query));
-		}
+		_content_query_builder_append(&query, SELECT_FOLDER_LIST);
+		ret = _media_filter_attribute_append_query(_content_get_alias_attirbute_handle(), filter, &query);
 	}
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = _content_query_builder_prepare(&query, &stmt);
 
-	ret = _content_query_prepare(&stmt, select_query, condition_query, option_query);
-	SAFE_FREE(condition_query);
-	SAFE_FREE(option_query);
+	_content_query_builder_release(&query);
 	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
 
-	while(sqlite3_step(stmt) == SQLITE_ROW)
+	while(_content_query_step(stmt) == SQLITE_ROW)
 	{
 		media_folder_s *_folder = (media_folder_s*)calloc(1, sizeof(media_folder_s));
 
@@ -461,13 +566,15 @@ int _media_db_get_folder(filter_h filter, media_folder_cb callback, void *user_d
 
 		_folder->modified_time = (int)sqlite3_column_int(stmt,4);
 
-		if(callback((media_folder_h)_folder, user_data) == false)
-		{
-			media_folder_destroy((media_folder_h) _folder);
-			break;
-		}
+		if(count_callback != NULL)
+			cont = count_callback((media_folder_h)_folder, (int)sqlite3_column_int(stmt, 5), user_data);
+		else
+			cont = callback((media_folder_h)_folder, user_data);
 
-		media_folder_destroy((media_folder_h) _folder);
+		media_folder_destroy((media_folder_h)_folder);
+
+		if(cont == false)
+			break;
 	}
 
 	SQLITE3_FINALIZE(stmt);
@@ -475,53 +582,41 @@ int _media_db_get_folder(filter_h filter, media_folder_cb callback, void *user_d
 	return ret;
 }
 
-int _media_db_get_playlist(filter_h filter, media_playlist_cb callback, void *user_data)
+int _media_db_get_folder(filter_h filter, media_folder_cb callback, void *user_data)
+{
+	return __media_db_get_folder(filter, callback, NULL, user_data);
+}
+
+int _media_db_get_folder_with_count(filter_h filter, media_folder_count_cb callback, void *user_data)
+{
+	return __media_db_get_folder(filter, NULL, callback, user_data);
+}
+
+static int __media_db_get_playlist(filter_h filter, media_playlist_cb callback, media_playlist_count_cb count_callback, void *user_data)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
-	char select_query[DEFAULT_QUERY_SIZE];
-	char *condition_query = NULL;
-	char *option_query = NULL;
+	query_builder_s query;
 	sqlite3_stmt *stmt = NULL;
-	filter_s *_filter = NULL;
-
-	memset(select_query, 0x00, sizeof(select_query));
+	bool cont = TRUE;
 
-	//snprintf(select_query, sizeof(select_query), SELECT_PLAYLIST_LIST);
-	if(!SAFE_STRLCPY(select_query, SELECT_PLAYLIST_LIST, sizeof(select_query)))
+	_content_query_builder_init(&query);
+	if(count_callback != NULL)
 	{
-		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
-		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+		_content_query_builder_append(&query, SELECT_PLAYLIST_LIST_WITH_COUNT);
+		ret = _media_filter_attribute_append_group_query(_content_get_attirbute_handle(), filter, PLAYLIST_GROUP_BY, &query);
 	}
-
-
-	if(filter != NULL)
+	else
 	{
-		_filter = (filter_s*)filter;
-
-		if(_filter->condition)
-		{
-			//ret = _media_filter_attribute_generate(_content_get_alias_attirbute_handle(), _filter->condition, _filter->condition_collate_type, &condition_query);
-			ret = _media_filter_attribute_generate(_content_get_attirbute_handle(), _filter->condition, _filter->condition_collate_type, &condition_query);
-			media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
-		}
-
-		//ret = _media_filter_attribute_option_generate(_content_get_alias_attirbute_handle(), filter, &option_query);
-		ret = _media_filter_attribute_option_generate(_content_get_attirbute_handle(), filter, &option_query);
-		media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
-
-		if(STRING_VALID(condition_query))
-		{
-			SAFE_STRLCAT(select_query, QUERY_KEYWORD_SPACE, sizeof(select_query));
-			SAFE_STRLCAT(select_query, QUERY_KEYWORD_AND, sizeof(select_query));
-		}
+		_content_query_builder_append(&query, SELECT_PLAYLIST_LIST);
+		ret = _media_filter_attribute_append_query(_content_get_attirbute_handle(), filter, &query);
 	}
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = _content_query_builder_prepare(&query, &stmt);
 
-	ret = _content_query_prepare(&stmt, select_query, condition_query, option_query);
-	SAFE_FREE(condition_query);
-	SAFE_FREE(option_query);
+	_content_query_builder_release(&query);
 	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
 
-	while(sqlite3_step(stmt) == SQLITE_ROW)
+	while(_content_query_step(stmt) == SQLITE_ROW)
 	{
 		media_playlist_s *_playlist = (media_playlist_s*)calloc(1, sizeof(media_playlist_s));
 
@@ -537,12 +632,15 @@ int _media_db_get_playlist(filter_h filter, media_playlist_cb callback, void *us
 		if(STRING_VALID((const char *)sqlite3_column_text(stmt, 1)))
 			_playlist->name = strdup((const char *)sqlite3_column_text(stmt, 1));
 
-		if(callback((media_playlist_h)_playlist, user_data) == false)
-		{
-			media_playlist_destroy((media_playlist_h)_playlist);
-			break;
-		}
+		if(count_callback != NULL)
+			cont = count_callback((media_playlist_h)_playlist, (int)sqlite3_column_int(stmt, 2), user_data);
+		else
+			cont = callback((media_playlist_h)_playlist, user_data);
+
 		media_playlist_destroy((media_playlist_h)_playlist);
+
+		if(cont == false)
+			break;
 	}
 
 	SQLITE3_FINALIZE(stmt);
@@ -550,131 +648,96 @@ int _media_db_get_playlist(filter_h filter, media_playlist_cb callback, void *us
 	return ret;
 }
 
+int _media_db_get_playlist(filter_h filter, media_playlist_cb callback, void *user_data)
+{
+	return __media_db_get_playlist(filter, callback, NULL, user_data);
+}
+
+int _media_db_get_playlist_with_count(filter_h filter, media_playlist_count_cb callback, void *user_data)
+{
+	return __media_db_get_playlist(filter, NULL, callback, user_data);
+}
+
 int _media_db_get_playlist_item(int playlist_id, filter_h filter, playlist_member_cb callback, void *user_data)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
-	char select_query[DEFAULT_QUERY_SIZE];
-	char *condition_query = NULL;
-	char *option_query = NULL;
+	query_builder_s query;
 	sqlite3_stmt *stmt = NULL;
-	filter_s *_filter = NULL;
-
-	memset(select_query, 0x00, sizeof(select_query));
+	int field_groups = (filter != NULL) ? ((filter_s*)filter)->field_groups : MEDIA_CONTENT_FIELD_ALL;
+	content_arena_s arena;
+	bool cont = TRUE;
 
-	snprintf(select_query, sizeof(select_query), SELECT_PLAYLIST_ITEM_ID_FROM_PLAYLIST_VIEW, playlist_id);
+	/* Members and their media come back from one join in play order,
+	 * instead of one media_info_get_media_from_db() per member */
+	_content_query_builder_init(&query);
+	_media_info_append_columns(&query, filter);
+	_content_query_builder_appendf(&query, FROM_PLAYLIST_MEMBER_MEDIA, playlist_id);
 
-	if(filter != NULL)
-	{
-		_filter = (filter_s*)filter;
+	ret = _media_filter_attribute_append_query_with_order(_content_get_attirbute_handle(), filter, PLAYLIST_MEMBER_DEFAULT_ORDER, &query);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = _content_query_builder_prepare(&query, &stmt);
 
-		if(_filter->condition)
-		{
-			//ret = _media_filter_attribute_generate(_content_get_alias_attirbute_handle(), _filter->condition, _filter->condition_collate_type, &condition_query);
-			ret = _media_filter_attribute_generate(_content_get_attirbute_handle(), _filter->condition, _filter->condition_collate_type, &condition_query);
-			media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
-		}
-
-		//ret = _media_filter_attribute_option_generate(_content_get_alias_attirbute_handle(), filter, &option_query);
-		ret = _media_filter_attribute_option_generate(_content_get_attirbute_handle(), filter, &option_query);
-		media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
-
-		if(STRING_VALID(condition_query))
-		{
-			SAFE_STRLCAT(select_query, QUERY_KEYWORD_SPACE, sizeof(select_query));
-			SAFE_STRLCAT(select_query, QUERY_KEYWORD_AND, sizeof(select_query));
-		}
-	}
-
-	ret = _content_query_prepare(&stmt, select_query, condition_query, option_query);
-	SAFE_FREE(condition_query);
-	SAFE_FREE(option_query);
+	_content_query_builder_release(&query);
 	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
 
-	while(sqlite3_step(stmt) == SQLITE_ROW)
+	_content_arena_init(&arena);
+
+	while(cont && _content_query_step(stmt) == SQLITE_ROW)
 	{
 		int playlist_member_id = 0;
-		char media_uuid[MEDIA_CONTENT_UUID_SIZE+1];
-		media_info_h media = NULL;
-		memset(media_uuid, 0x00, sizeof(media_uuid));
-
-		playlist_member_id = (int)sqlite3_column_int(stmt, 0);
-
-		if(STRING_VALID((const char *)sqlite3_column_text(stmt, 1)))
-			strncpy(media_uuid, (const char *)sqlite3_column_text(stmt, 1), sizeof(media_uuid));
-
-		ret = media_info_get_media_from_db(media_uuid, &media);
-
-		if(callback(playlist_member_id, media, user_data) == false)
+		media_info_s *item = (media_info_s*)_content_arena_alloc(&arena, sizeof(media_info_s));
+		if(item == NULL)
 		{
-			media_info_destroy(media);
+			ret = MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
 			break;
 		}
-		media_info_destroy(media);
+
+		playlist_member_id = (int)sqlite3_column_int(stmt, PLAYLIST_MEMBER_ID_COLUMN);
+		_media_info_item_get_detail(stmt, (media_info_h)item, field_groups, &arena);
+
+		cont = callback(playlist_member_id, (media_info_h)item, user_data);
+
+		_content_arena_reset(&arena);
 	}
 
+	_content_arena_release(&arena);
 	SQLITE3_FINALIZE(stmt);
 
 	return ret;
 }
 
-//same as _media_db_get_playlist
-int _media_db_get_tag(const char *media_id, filter_h filter, media_tag_cb callback, void *user_data)
+//same as _media_db_get_playlist, count_callback is only used for the whole tag list
+static int __media_db_get_tag(const char *media_id, filter_h filter, media_tag_cb callback, media_tag_count_cb count_callback, void *user_data)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
-	char select_query[DEFAULT_QUERY_SIZE];
-	char *condition_query = NULL;
-	char *option_query = NULL;
+	query_builder_s query;
 	sqlite3_stmt *stmt = NULL;
-	filter_s *_filter = NULL;
-	attribute_h attr;
+	bool cont = TRUE;
 
-	memset(select_query, 0x00, sizeof(select_query));
+	_content_query_builder_init(&query);
 
-	if(!STRING_VALID(media_id))
+	if(count_callback != NULL)
 	{
-		//attr = _content_get_alias_attirbute_handle();
-		attr = _content_get_attirbute_handle();
-		//snprintf(select_query, sizeof(select_query), SELECT_TAG_LIST);
-		if(!SAFE_STRLCPY(select_query, SELECT_TAG_LIST, sizeof(select_query)))
-		{
-			media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
-			return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
-		}
+		_content_query_builder_append(&query, SELECT_TAG_LIST_WITH_COUNT);
+		ret = _media_filter_attribute_append_group_query(_content_get_attirbute_handle(), filter, TAG_GROUP_BY, &query);
 	}
 	else
 	{
-		attr = _content_get_attirbute_handle();
-		snprintf(select_query, sizeof(select_query), SELECT_TAG_LIST_BY_MEDIA_ID, media_id);
-	}
-
-	if(filter != NULL)
-	{
-		_filter = (filter_s*)filter;
-
-		if(_filter->condition)
-		{
-			ret = _media_filter_attribute_generate(attr, _filter->condition, _filter->condition_collate_type, &condition_query);
-			media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
-		}
-
-		ret = _media_filter_attribute_option_generate(attr, filter, &option_query);
-		media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
-
-		if(STRING_VALID(condition_query))
-		{
-			SAFE_STRLCAT(select_query, QUERY_KEYWORD_SPACE, sizeof(select_query));
-			SAFE_STRLCAT(select_query, QUERY_KEYWORD_AND, sizeof(select_query));
-		}
+		if(!STRING_VALID(media_id))
+			_content_query_builder_append(&query, SELECT_TAG_LIST);
+		else
+			_content_query_builder_appendf(&query, SELECT_TAG_LIST_BY_MEDIA_ID, media_id);
+
+		ret = _media_filter_attribute_append_query(_content_get_attirbute_handle(), filter, &query);
 	}
 
-	SAFE_STRLCAT(select_query, QUERY_KEYWORD_SPACE, sizeof(select_query));
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = _content_query_builder_prepare(&query, &stmt);
 
-	ret = _content_query_prepare(&stmt, select_query, condition_query, option_query);
-	SAFE_FREE(condition_query);
-	SAFE_FREE(option_query);
+	_content_query_builder_release(&query);
 	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
 
-	while(sqlite3_step(stmt) == SQLITE_ROW)
+	while(_content_query_step(stmt) == SQLITE_ROW)
 	{
 		media_tag_s *_tag = (media_tag_s*)calloc(1, sizeof(media_tag_s));
 
@@ -690,12 +753,15 @@ int _media_db_get_tag(const char *media_id, filter_h filter, media_tag_cb callba
 		if(STRING_VALID((const char *)sqlite3_column_text(stmt, 1)))
 			_tag->name = strdup((const char *)sqlite3_column_text(stmt, 1));
 
-		if(callback((media_tag_h)_tag, user_data) == false)
-		{
-			media_tag_destroy((media_tag_h)_tag);
-			break;
-		}
+		if(count_callback != NULL)
+			cont = count_callback((media_tag_h)_tag, (int)sqlite3_column_int(stmt, 2), user_data);
+		else
+			cont = callback((media_tag_h)_tag, user_data);
+
 		media_tag_destroy((media_tag_h)_tag);
+
+		if(cont == false)
+			break;
 	}
 
 	SQLITE3_FINALIZE(stmt);
@@ -703,60 +769,44 @@ int _media_db_get_tag(const char *media_id, filter_h filter, media_tag_cb callba
 	return ret;
 }
 
+int _media_db_get_tag(const char *media_id, filter_h filter, media_tag_cb callback, void *user_data)
+{
+	return __media_db_get_tag(media_id, filter, callback, NULL, user_data);
+}
+
+int _media_db_get_tag_with_count(filter_h filter, media_tag_count_cb callback, void *user_data)
+{
+	return __media_db_get_tag(NULL, filter, NULL, callback, user_data);
+}
+
 int _media_db_get_bookmark(const char *media_id, filter_h filter, media_bookmark_cb callback, void *user_data)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
-	char select_query[DEFAULT_QUERY_SIZE];
-	char *condition_query = NULL;
-	char *option_query = NULL;
+	query_builder_s query;
 	sqlite3_stmt *stmt = NULL;
-	filter_s *_filter = NULL;
 	attribute_h attr;
 
-	memset(select_query, 0x00, sizeof(select_query));
+	_content_query_builder_init(&query);
 
 	if(!STRING_VALID(media_id))
 	{
 		attr = _content_get_alias_attirbute_handle();
-		//snprintf(select_query, sizeof(select_query), SELECT_BOOKMARK_LIST);
-		if(!SAFE_STRLCPY(select_query, SELECT_BOOKMARK_LIST, sizeof(select_query)))
-		{
-			media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
-			return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
-		}
+		_content_query_builder_append(&query, SELECT_BOOKMARK_LIST);
 	}
 	else
 	{
 		attr = _content_get_attirbute_handle();
-		snprintf(select_query, sizeof(select_query), SELECT_BOOKMARK_LIST_BY_MEDIA_ID_USUAL, media_id);
+		_content_query_builder_appendf(&query, SELECT_BOOKMARK_LIST_BY_MEDIA_ID_USUAL, media_id);
 	}
 
-	if(filter != NULL)
-	{
-		_filter = (filter_s*)filter;
-
-		if(_filter->condition)
-		{
-			ret = _media_filter_attribute_generate(attr, _filter->condition, _filter->condition_collate_type, &condition_query);
-			media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
-		}
-
-		ret = _media_filter_attribute_option_generate(attr, filter, &option_query);
-		media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
-
-		if(STRING_VALID(condition_query))
-		{
-			SAFE_STRLCAT(select_query, QUERY_KEYWORD_SPACE, sizeof(select_query));
-			SAFE_STRLCAT(select_query, QUERY_KEYWORD_AND, sizeof(select_query));
-		}
-	}
+	ret = _media_filter_attribute_append_query(attr, filter, &query);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = _content_query_builder_prepare(&query, &stmt);
 
-	ret = _content_query_prepare(&stmt, select_query, condition_query, option_query);
-	SAFE_FREE(condition_query);
-	SAFE_FREE(option_query);
+	_content_query_builder_release(&query);
 	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
 
-	while(sqlite3_step(stmt) == SQLITE_ROW)
+	while(_content_query_step(stmt) == SQLITE_ROW)
 	{
 		media_bookmark_s *bookmark = (media_bookmark_s*)calloc(1, sizeof(media_bookmark_s));
 
@@ -795,32 +845,30 @@ int _media_db_get_bookmark(const char *media_id, filter_h filter, media_bookmark
 int _media_db_get_group_item_count_by_id(int group_id, filter_h filter, group_list_e group_type, int *item_count)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
-	sqlite3_stmt *stmt = NULL;
-	filter_s *_filter = NULL;
-	char select_query[DEFAULT_QUERY_SIZE];
-	char *condition_query = NULL;
-	char *option_query = NULL;
-	attribute_h attr = NULL;
+	query_builder_s query;
+	const char *select_query = NULL;
+	char album_id[MIN_QUERY_SIZE] = {0, };
 
 	media_content_debug_func();
 
-	memset(select_query, 0x00, sizeof(select_query));
+	if(group_type == MEDIA_GROUP_ALBUM && _media_group_summary_is_usable(GROUP_SUMMARY_ALBUM, filter))
+	{
+		snprintf(album_id, sizeof(album_id), "%d", group_id);
+		if(_media_group_summary_get_media_count(GROUP_SUMMARY_ALBUM, album_id, item_count) == MEDIA_CONTENT_ERROR_NONE)
+			return MEDIA_CONTENT_ERROR_NONE;
+	}
 
 	if(group_type == MEDIA_GROUP_ALBUM)
 	{
-		attr = _content_get_attirbute_handle();
-		snprintf(select_query, sizeof(select_query), SELECT_MEDIA_COUNT_FROM_ALBUM, group_id);
+		select_query = SELECT_MEDIA_COUNT_FROM_ALBUM;
 	}
 	else if(group_type == MEDIA_GROUP_PLAYLIST)
 	{
-		//attr = _content_get_alias_attirbute_handle();
-		attr = _content_get_attirbute_handle();
-		snprintf(select_query, sizeof(select_query), SELECT_MEDIA_COUNT_FROM_PLAYLIST, group_id);
+		select_query = SELECT_MEDIA_COUNT_FROM_PLAYLIST;
 	}
 	else if(group_type == MEDIA_GROUP_TAG)
 	{
-		attr = _content_get_attirbute_handle();
-		snprintf(select_query, sizeof(select_query), SELECT_MEDIA_COUNT_FROM_TAG, group_id);
+		select_query = SELECT_MEDIA_COUNT_FROM_TAG;
 	}
 	else
 	{
@@ -828,53 +876,14 @@ int _media_db_get_group_item_count_by_id(int group_id, filter_h filter, group_li
 		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
 	}
 
-	if(filter != NULL)
-	{
-		_filter = (filter_s*)filter;
-
-		if(_filter->condition)
-		{
-			ret = _media_filter_attribute_generate(attr, _filter->condition, _filter->condition_collate_type, &condition_query);
-			media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
-		}
-
-		ret = _media_filter_attribute_option_generate(attr, filter, &option_query);
-		media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
-
-		if(STRING_VALID(condition_query))
-		{
-			SAFE_STRLCAT(select_query, QUERY_KEYWORD_SPACE, sizeof(select_query));
-			SAFE_STRLCAT(select_query, QUERY_KEYWORD_AND, sizeof(select_query));
-		}
-	}
-/*
-	if((group_type == MEDIA_GROUP_PLAYLIST) || (group_type == MEDIA_GROUP_TAG))
-	{
-		strncat(select_query, QUERY_KEYWORD_SPACE, strlen(QUERY_KEYWORD_SPACE));
-
-		if(STRING_VALID(condition_query))
-			strncat(select_query, condition_query, strlen(condition_query));
-		if(STRING_VALID(option_query))
-			strncat(select_query, option_query, strlen(option_query));
-
-		strncat(select_query, QUERY_KEYWORD_BRACKET, strlen(QUERY_KEYWORD_BRACKET));
-
-		SAFE_FREE(condition_query);
-		SAFE_FREE(option_query);
-	}
-*/
-	ret = _content_query_prepare(&stmt, select_query, condition_query, option_query);
-	SAFE_FREE(condition_query);
-	SAFE_FREE(option_query);
-	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
+	_content_query_builder_init(&query);
+	_content_query_builder_appendf(&query, select_query, group_id);
 
-	while(sqlite3_step(stmt) == SQLITE_ROW)
-	{
-		*item_count = (int)sqlite3_column_int(stmt, 0);
-		media_content_debug("group item count : [%d]", *item_count);
-	}
+	ret = _media_filter_attribute_append_query(_content_get_attirbute_handle(), filter, &query);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = __media_db_get_count(&query, item_count);
 
-	SQLITE3_FINALIZE(stmt);
+	_content_query_builder_release(&query);
 
 	return ret;
 }
@@ -882,97 +891,46 @@ int _media_db_get_group_item_count_by_id(int group_id, filter_h filter, group_li
 int _media_db_get_group_item_count(const char *group_name, filter_h filter, group_list_e group_type, int *item_count)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
-	sqlite3_stmt *stmt = NULL;
-	filter_s *_filter = NULL;
-	char complete_select_query[DEFAULT_QUERY_SIZE];
-	char *select_query = NULL;
-	char *condition_query = NULL;
-	char *option_query = NULL;
+	query_builder_s query;
 
 	media_content_debug_func();
 
+	_content_query_builder_init(&query);
+
 	if(group_type == MEDIA_GROUP_NONE)
 	{
-		select_query = sqlite3_mprintf(SELECT_MEDIA_COUNT_FROM_MEDIA);
+		_content_query_builder_append(&query, SELECT_MEDIA_COUNT_FROM_MEDIA);
 	}
 	else if(group_type == MEDIA_GROUP_FOLDER)
 	{
-		select_query = sqlite3_mprintf(SELECT_MEDIA_COUNT_FROM_FOLDER, group_name);
+		_content_query_builder_append(&query, SELECT_MEDIA_COUNT_FROM_FOLDER);
+		_content_query_builder_bind_text(&query, group_name);
 	}
 	else if(group_type == MEDIA_GROUP_TAG_BY_MEDIA_ID)
 	{
-		select_query = sqlite3_mprintf(SELECT_TAG_COUNT_BY_MEDIA_ID, group_name);
+		_content_query_builder_appendf(&query, SELECT_TAG_COUNT_BY_MEDIA_ID, group_name);
 	}
 	else if(group_type == MEDIA_GROUP_BOOKMARK_BY_MEDIA_ID)
 	{
-		select_query = sqlite3_mprintf(SELECT_BOOKMARK_COUNT_BY_MEDIA_ID, group_name);
+		_content_query_builder_appendf(&query, SELECT_BOOKMARK_COUNT_BY_MEDIA_ID, group_name);
 	}
 	else
 	{
+		_content_query_builder_release(&query);
 		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
 		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
 	}
 
-	if(filter != NULL)
-	{
-		_filter = (filter_s*)filter;
-
-		if(_filter->condition)
-		{
-			ret = _media_filter_attribute_generate(_content_get_attirbute_handle(), _filter->condition, _filter->condition_collate_type, &condition_query);
-			if(ret != MEDIA_CONTENT_ERROR_NONE)
-			{
-				sqlite3_free(select_query);
-				return ret;
-			}
-		}
-
-		ret = _media_filter_attribute_option_generate(_content_get_attirbute_handle(), filter, &option_query);
-		if(ret != MEDIA_CONTENT_ERROR_NONE)
-		{
-			sqlite3_free(select_query);
-			return ret;
-		}
-
-		if(STRING_VALID(condition_query))
-		{
-			snprintf(complete_select_query, sizeof(complete_select_query), "%s %s", select_query, QUERY_KEYWORD_AND);
-		}
-		else
-		{
-			snprintf(complete_select_query, sizeof(complete_select_query), "%s", select_query);
-		}
-	} else {
-		snprintf(complete_select_query, sizeof(complete_select_query), "%s", select_query);
-	}
+	ret = _media_filter_attribute_append_query(_content_get_attirbute_handle(), filter, &query);
 
+	/* SELECT_MEDIA_COUNT_FROM_MEDIA counts a sub query, so that LIMIT applies */
 	if(group_type == MEDIA_GROUP_NONE)
-	{
-		SAFE_STRLCAT(complete_select_query, QUERY_KEYWORD_SPACE, sizeof(complete_select_query));
-		if(STRING_VALID(condition_query))
-			SAFE_STRLCAT(complete_select_query, condition_query, sizeof(complete_select_query));
-		if(STRING_VALID(option_query))
-			SAFE_STRLCAT(complete_select_query, option_query, sizeof(complete_select_query));
+		_content_query_builder_append(&query, QUERY_KEYWORD_BRACKET);
 
-		SAFE_STRLCAT(complete_select_query, QUERY_KEYWORD_BRACKET, sizeof(complete_select_query));
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = __media_db_get_count(&query, item_count);
 
-		SAFE_FREE(condition_query);
-		SAFE_FREE(option_query);
-	}
-
-	ret = _content_query_prepare(&stmt, complete_select_query, condition_query, option_query);
-	sqlite3_free(select_query);
-	SAFE_FREE(condition_query);
-	SAFE_FREE(option_query);
-	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
-
-	while(sqlite3_step(stmt) == SQLITE_ROW)
-	{
-		*item_count = (int)sqlite3_column_int(stmt, 0);
-		media_content_debug("group item count : [%d]", *item_count);
-	}
-
-	SQLITE3_FINALIZE(stmt);
+	_content_query_builder_release(&query);
 
 	return ret;
 }
@@ -980,25 +938,20 @@ int _media_db_get_group_item_count(const char *group_name, filter_h filter, grou
 int _media_db_get_group_item_by_id(int group_id, filter_h filter, media_info_cb callback, void *user_data, group_list_e group_type)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
-	char select_query[DEFAULT_QUERY_SIZE];
-	char *condition_query = NULL;
-	char *option_query = NULL;
-	sqlite3_stmt *stmt = NULL;
-	filter_s *_filter = NULL;
-
-	memset(select_query, 0x00, sizeof(select_query));
+	query_builder_s query;
+	const char *from_query = NULL;
 
 	if(group_type == MEDIA_GROUP_ALBUM)
 	{
-		snprintf(select_query, sizeof(select_query), SELECT_MEDIA_FROM_ALBUM, group_id);
+		from_query = FROM_MEDIA_BY_ALBUM;
 	}
 	else if(group_type == MEDIA_GROUP_PLAYLIST)
 	{
-		snprintf(select_query, sizeof(select_query), SELECT_MEDIA_FROM_PLAYLIST, group_id);
+		from_query = FROM_MEDIA_BY_PLAYLIST;
 	}
 	else if(group_type == MEDIA_GROUP_TAG)
 	{
-		snprintf(select_query, sizeof(select_query), SELECT_MEDIA_FROM_TAG, group_id);
+		from_query = FROM_MEDIA_BY_TAG;
 	}
 	else
 	{
@@ -1006,221 +959,161 @@ int _media_db_get_group_item_by_id(int group_id, filter_h filter, media_info_cb
 		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
 	}
 
-	if(filter != NULL)
-	{
-		_filter = (filter_s*)filter;
-
-		if(_filter->condition)
-		{
-			ret = _media_filter_attribute_generate(_content_get_attirbute_handle(), _filter->condition, _filter->condition_collate_type, &condition_query);
-			media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
-		}
+	_content_query_builder_init(&query);
+	_media_info_append_columns(&query, filter);
+	_media_filter_append_seek_column(filter, &query);
+	_content_query_builder_appendf(&query, from_query, group_id);
 
-		ret = _media_filter_attribute_option_generate(_content_get_attirbute_handle(), filter, &option_query);
-		media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
-
-		if(STRING_VALID(condition_query))
-		{
-			SAFE_STRLCAT(select_query, QUERY_KEYWORD_SPACE, sizeof(select_query));
-			SAFE_STRLCAT(select_query, QUERY_KEYWORD_AND, sizeof(select_query));
-		}
-	}
+	ret = _media_filter_attribute_append_media_query(_content_get_attirbute_handle(), filter, &query);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = __media_db_get_media_item(&query, filter, 0, callback, NULL, user_data);
 
-	ret = _content_query_prepare(&stmt, select_query, condition_query, option_query);
-	SAFE_FREE(condition_query);
-	SAFE_FREE(option_query);
-	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
+	_content_query_builder_release(&query);
 
-	while(sqlite3_step(stmt) == SQLITE_ROW)
-	{
-		media_info_s *item = (media_info_s*)calloc(1, sizeof(media_info_s));
-		if(item == NULL)
-		{
-			media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
-			SQLITE3_FINALIZE(stmt);
-			return MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
-		}
+	return ret;
+}
 
-		_media_info_item_get_detail(stmt, (media_info_h)item);
+int _media_db_get_group_item(const char *group_name, filter_h filter, media_info_cb callback, void *user_data, group_list_e group_type)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	query_builder_s query;
 
-		if(callback((media_info_h)item, user_data) == false)
-		{
-			media_info_destroy((media_info_h)item);
-			break;
-		}
+	_content_query_builder_init(&query);
 
-		media_info_destroy((media_info_h)item);
-	}
+	ret = __media_db_make_group_item_query(group_name, filter, group_type, &query);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = __media_db_get_media_item(&query, filter, 0, callback, NULL, user_data);
 
-	SQLITE3_FINALIZE(stmt);
+	_content_query_builder_release(&query);
 
 	return ret;
 }
 
-int _media_db_get_group_item(const char *group_name, filter_h filter, media_info_cb callback, void *user_data, group_list_e group_type)
+int _media_db_get_group_item_batch(const char *group_name, filter_h filter, int batch_size, media_info_batch_cb callback, void *user_data, group_list_e group_type)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
-	char complete_select_query[DEFAULT_QUERY_SIZE];
-	char *select_query = NULL;
-	char *condition_query = NULL;
-	char *option_query = NULL;
-	sqlite3_stmt *stmt = NULL;
-	filter_s *_filter = NULL;
+	query_builder_s query;
 
-	if(group_type == MEDIA_GROUP_NONE)
-	{
-		select_query = sqlite3_mprintf(SELECT_MEDIA_ITEM);
-	}
-	else if(group_type == MEDIA_GROUP_FOLDER)
-	{
-		select_query = sqlite3_mprintf(SELECT_MEDIA_FROM_FOLDER, group_name);
-	}
-	else if(group_type == MEDIA_GROUP_BOOKMARK_BY_MEDIA_ID)
-	{
-		select_query = sqlite3_mprintf(SELECT_BOOKMARK_LIST_BY_MEDIA_ID, group_name);
-	}
-	else
-	{
-		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
-		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
-	}
+	_content_query_builder_init(&query);
 
-	if(filter != NULL)
-	{
-		_filter = (filter_s*)filter;
+	ret = __media_db_make_group_item_query(group_name, filter, group_type, &query);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = __media_db_get_media_item(&query, filter, batch_size, NULL, callback, user_data);
 
-		if(_filter->condition)
-		{
-			ret = _media_filter_attribute_generate(_content_get_attirbute_handle(), _filter->condition, _filter->condition_collate_type, &condition_query);
-			if(ret != MEDIA_CONTENT_ERROR_NONE)
-			{
-				sqlite3_free(select_query);
-				return ret;
-			}
-		}
+	_content_query_builder_release(&query);
 
-		ret = _media_filter_attribute_option_generate(_content_get_attirbute_handle(), filter, &option_query);
-		if(ret != MEDIA_CONTENT_ERROR_NONE)
-		{
-			sqlite3_free(select_query);
-			return ret;
-		}
+	return ret;
+}
 
-		if(STRING_VALID(condition_query))
-		{
-			snprintf(complete_select_query, sizeof(complete_select_query), "%s %s", select_query, QUERY_KEYWORD_AND);
-		}
-		else
-		{
-			snprintf(complete_select_query, sizeof(complete_select_query), "%s", select_query);
-		}
-	} else {
-		snprintf(complete_select_query, sizeof(complete_select_query), "%s", select_query);
-	}
+/* Rows of the media list, read straight into the arrays of the caller, which are handed over each time they are full */
+int _media_db_get_media_columns(filter_h filter, media_info_columns_s *columns, media_info_columns_cb callback, void *user_data)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	int err = SQLITE_OK;
+	query_builder_s query;
+	sqlite3_stmt *stmt = NULL;
+	bool cont = TRUE;
+
+	_content_query_builder_init(&query);
+	_content_query_builder_append(&query, "SELECT "MEDIA_INFO_COLUMNS FROM_MEDIA_ITEM);
 
-	ret = _content_query_prepare(&stmt, complete_select_query, condition_query, option_query);
-	sqlite3_free(select_query);
-	SAFE_FREE(condition_query);
-	SAFE_FREE(option_query);
+	ret = _media_filter_attribute_append_media_query(_content_get_attirbute_handle(), filter, &query);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = _content_query_builder_prepare(&query, &stmt);
+
+	_content_query_builder_release(&query);
 	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
 
-	while(sqlite3_step(stmt) == SQLITE_ROW)
+	columns->count = 0;
+	if(columns->path_offset != NULL)
+		columns->path_offset[0] = 0;
+
+	while(cont && (err = _content_query_step(stmt)) == SQLITE_ROW)
 	{
-		media_info_s *item = (media_info_s*)calloc(1, sizeof(media_info_s));
-		if(item == NULL)
+		if(columns->count < columns->capacity && __media_db_add_media_columns(stmt, columns))
+			continue;
+
+		/* Full, the row goes to the next chunk */
+		if(columns->count == 0)
 		{
-			media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
-			SQLITE3_FINALIZE(stmt);
-			return MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
+			media_content_error("INVALID_PARAMETER(0x%08x) path buffer of %d bytes is too small", MEDIA_CONTENT_ERROR_INVALID_PARAMETER, columns->path_capacity);
+			ret = MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+			break;
 		}
 
-		_media_info_item_get_detail(stmt, (media_info_h)item);
+		cont = callback(columns, user_data);
 
-		if(callback((media_info_h)item, user_data) == false)
+		columns->count = 0;
+		if(columns->path_offset != NULL)
+			columns->path_offset[0] = 0;
+
+		if(cont && !__media_db_add_media_columns(stmt, columns))
 		{
-			media_info_destroy((media_info_h)item);
+			media_content_error("INVALID_PARAMETER(0x%08x) path buffer of %d bytes is too small", MEDIA_CONTENT_ERROR_INVALID_PARAMETER, columns->path_capacity);
+			ret = MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
 			break;
 		}
+	}
 
-		media_info_destroy((media_info_h)item);
+	if(ret == MEDIA_CONTENT_ERROR_NONE && cont && err != SQLITE_ROW && err != SQLITE_DONE)
+	{
+		media_content_error("DB_FAILED(0x%08x) fail to sqlite3_step(), %s", MEDIA_CONTENT_ERROR_DB_FAILED, sqlite3_errmsg(sqlite3_db_handle(stmt)));
+		ret = MEDIA_CONTENT_ERROR_DB_FAILED;
 	}
 
+	if(ret == MEDIA_CONTENT_ERROR_NONE && cont && columns->count > 0)
+		callback(columns, user_data);
+
 	SQLITE3_FINALIZE(stmt);
 
 	return ret;
 }
 
-int _media_db_get_media_group_item_count(const char *group_name, media_group_e group, filter_h filter, int *item_count)
+/* The rows are selected in a sub query, so that the LIMIT of the filter applies before the aggregate */
+int _media_db_get_media_aggregate(filter_h filter, const char *field, media_content_aggregate_e op, double *result)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
+	unsigned int idx = 0;
+	const char *column = NULL;
+	query_builder_s query;
 	sqlite3_stmt *stmt = NULL;
-	filter_s *_filter = NULL;
-	char complete_select_query[DEFAULT_QUERY_SIZE];
-	char *select_query = NULL;
-	char *condition_query = NULL;
-	char *option_query = NULL;
-
-	media_content_debug_func();
-
-	if(group_name != NULL)
-		select_query = sqlite3_mprintf(SELECT_MEDIA_COUNT_FROM_GROUP, __media_db_get_group_name(group), group_name);
-	else
-		select_query = sqlite3_mprintf(SELECT_MEDIA_COUNT_FROM_GROUP_NULL, __media_db_get_group_name(group));
 
-	if(filter != NULL)
+	for(idx = 0; idx < sizeof(g_aggregate_fields) / sizeof(g_aggregate_fields[0]); idx++)
 	{
-		_filter = (filter_s*)filter;
-
-		if(_filter->condition)
-		{
-			ret = _media_filter_attribute_generate(_content_get_attirbute_handle(), _filter->condition, _filter->condition_collate_type, &condition_query);
-			if(ret != MEDIA_CONTENT_ERROR_NONE)
-			{
-				sqlite3_free(select_query);
-				return ret;
-			}
-		}
-
-		ret = _media_filter_attribute_option_generate(_content_get_attirbute_handle(), filter, &option_query);
-		if(ret != MEDIA_CONTENT_ERROR_NONE)
+		if(strcmp(field, g_aggregate_fields[idx]) == 0)
 		{
-			sqlite3_free(select_query);
-			return ret;
+			column = _media_filter_attribute_get_field(_content_get_attirbute_handle(), field);
+			break;
 		}
+	}
 
-		if(STRING_VALID(condition_query))
-		{
-			snprintf(complete_select_query, sizeof(complete_select_query), "%s %s", select_query, QUERY_KEYWORD_AND);
-		}
-		else
-		{
-			snprintf(complete_select_query, sizeof(complete_select_query), "%s", select_query);
-		}
-	} else {
-		snprintf(complete_select_query, sizeof(complete_select_query), "%s", select_query);
+	if(column == NULL || op < MEDIA_CONTENT_AGGREGATE_COUNT || op > MEDIA_CONTENT_AGGREGATE_AVG)
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x) field [%s] op [%d]", MEDIA_CONTENT_ERROR_INVALID_PARAMETER, field, op);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
 	}
 
-	SAFE_STRLCAT(complete_select_query, QUERY_KEYWORD_SPACE, sizeof(complete_select_query));
-	if(STRING_VALID(condition_query))
-		SAFE_STRLCAT(complete_select_query, condition_query, sizeof(complete_select_query));
-	if(STRING_VALID(option_query))
-		SAFE_STRLCAT(complete_select_query, option_query, sizeof(complete_select_query));
+	_content_query_builder_init(&query);
+	_content_query_builder_appendf(&query, "SELECT %s(value) FROM (SELECT %s AS value"FROM_MEDIA_ITEM, g_aggregate_functions[op], column);
 
-	SAFE_STRLCAT(complete_select_query, QUERY_KEYWORD_BRACKET, sizeof(complete_select_query));
+	ret = _media_filter_attribute_append_query(_content_get_attirbute_handle(), filter, &query);
+	_content_query_builder_append(&query, QUERY_KEYWORD_BRACKET);
 
-	SAFE_FREE(condition_query);
-	SAFE_FREE(option_query);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = _content_query_builder_prepare(&query, &stmt);
 
-	ret = _content_query_prepare(&stmt, complete_select_query, condition_query, option_query);
-	sqlite3_free(select_query);
-	SAFE_FREE(condition_query);
-	SAFE_FREE(option_query);
+	_content_query_builder_release(&query);
 	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
 
-	while(sqlite3_step(stmt) == SQLITE_ROW)
+	*result = 0;
+
+	/* SUM, MIN, MAX and AVG of no value are NULL, which reads as 0 */
+	if(_content_query_step(stmt) == SQLITE_ROW)
+		*result = sqlite3_column_double(stmt, 0);
+	else
 	{
-		*item_count = (int)sqlite3_column_int(stmt, 0);
-		media_content_debug("group item count : [%d]", *item_count);
+		media_content_error("DB_FAILED(0x%08x) fail to sqlite3_step(), %s", MEDIA_CONTENT_ERROR_DB_FAILED, sqlite3_errmsg(sqlite3_db_handle(stmt)));
+		ret = MEDIA_CONTENT_ERROR_DB_FAILED;
 	}
 
 	SQLITE3_FINALIZE(stmt);
@@ -1228,84 +1121,149 @@ int _media_db_get_media_group_item_count(const char *group_name, media_group_e g
 	return ret;
 }
 
-int _media_db_get_media_group_item(const char *group_name, media_group_e group, filter_h filter, media_info_cb callback, void *user_data)
+/* Same query as _media_db_get_group_item(), but the statement is handed to the caller (media cursor) */
+int _media_db_open_group_item(const char *group_name, filter_h filter, group_list_e group_type, sqlite3_stmt **stmt)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
-	char complete_select_query[DEFAULT_QUERY_SIZE];
-	char *select_query = NULL;
-	char *condition_query = NULL;
-	char *option_query = NULL;
-	sqlite3_stmt *stmt = NULL;
-	filter_s *_filter = NULL;
+	query_builder_s query;
 
-	media_content_debug_func();
+	if(group_type != MEDIA_GROUP_NONE && group_type != MEDIA_GROUP_FOLDER)
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
 
-	if(group_name != NULL)
-		select_query = sqlite3_mprintf(SELECT_MEDIA_FROM_GROUP, __media_db_get_group_name(group), group_name);
-	else
-		select_query = sqlite3_mprintf(SELECT_MEDIA_FROM_GROUP_NULL, __media_db_get_group_name(group));
+	_content_query_builder_init(&query);
+
+	ret = __media_db_make_group_item_query(group_name, filter, group_type, &query);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = _content_query_builder_prepare_uncached(&query, stmt);
+
+	_content_query_builder_release(&query);
+
+	return ret;
+}
+
+/* EXPLAIN QUERY PLAN of the query of _media_db_open_group_item(). The detail is the last column of each plan row */
+int _media_db_get_group_item_plan(const char *group_name, filter_h filter, group_list_e group_type, int *plan, char **detail)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	query_builder_s query;
+	sqlite3_stmt *stmt = NULL;
+	const char *line = NULL;
+	GString *lines = NULL;
 
-	if(filter != NULL)
+	if(group_type != MEDIA_GROUP_NONE && group_type != MEDIA_GROUP_FOLDER)
 	{
-		_filter = (filter_s*)filter;
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
 
-		if(_filter->condition)
-		{
-			ret = _media_filter_attribute_generate(_content_get_attirbute_handle(), _filter->condition, _filter->condition_collate_type, &condition_query);
-			if(ret != MEDIA_CONTENT_ERROR_NONE)
-			{
-				sqlite3_free(select_query);
-				return ret;
-			}
-		}
+	_content_query_builder_init(&query);
+	_content_query_builder_append(&query, QUERY_PLAN_PREFIX);
 
-		ret = _media_filter_attribute_option_generate(_content_get_attirbute_handle(), filter, &option_query);
-		if(ret != MEDIA_CONTENT_ERROR_NONE)
-		{
-			sqlite3_free(select_query);
-			return ret;
-		}
+	ret = __media_db_make_group_item_query(group_name, filter, group_type, &query);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = _content_query_builder_prepare_uncached(&query, &stmt);
 
-		if(STRING_VALID(condition_query))
-		{
-			snprintf(complete_select_query, sizeof(complete_select_query), "%s %s", select_query, QUERY_KEYWORD_AND);
-		}
-		else
+	_content_query_builder_release(&query);
+	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
+
+	*plan = MEDIA_CONTENT_QUERY_PLAN_INDEXED;
+	if(detail != NULL)
+		lines = g_string_new(NULL);
+
+	while(_content_query_step(stmt) == SQLITE_ROW)
+	{
+		line = (const char *)sqlite3_column_text(stmt, sqlite3_column_count(stmt) - 1);
+		if(!STRING_VALID(line))
+			continue;
+
+		/* "SCAN TABLE media" reads every row, "SCAN TABLE media USING INDEX ..." only walks an index in order */
+		if(strncmp(line, "SCAN ", 5) == 0 && strstr(line, "INDEX") == NULL && strstr(line, "CONSTANT ROW") == NULL)
+			*plan |= MEDIA_CONTENT_QUERY_PLAN_FULL_SCAN;
+		if(strstr(line, "TEMP B-TREE") != NULL)
+			*plan |= MEDIA_CONTENT_QUERY_PLAN_TEMP_SORT;
+
+		if(lines != NULL)
 		{
-			snprintf(complete_select_query, sizeof(complete_select_query), "%s", select_query);
+			if(lines->len > 0)
+				g_string_append_c(lines, '\n');
+			g_string_append(lines, line);
 		}
-	} else {
-		snprintf(complete_select_query, sizeof(complete_select_query), "%s", select_query);
 	}
 
-	ret = _content_query_prepare(&stmt, complete_select_query, condition_query, option_query);
-	sqlite3_free(select_query);
-	SAFE_FREE(condition_query);
-	SAFE_FREE(option_query);
-	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
+	SQLITE3_FINALIZE(stmt);
 
-	while(sqlite3_step(stmt) == SQLITE_ROW)
+	if(lines != NULL)
 	{
-		media_info_s *item = (media_info_s*)calloc(1, sizeof(media_info_s));
-		if(item == NULL)
+		/* Handed to the application, which releases it with free() */
+		*detail = strdup(lines->str);
+		g_string_free(lines, TRUE);
+
+		if(*detail == NULL)
 		{
 			media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
-			SQLITE3_FINALIZE(stmt);
 			return MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
 		}
+	}
+
+	return MEDIA_CONTENT_ERROR_NONE;
+}
 
-		_media_info_item_get_detail(stmt, (media_info_h)item);
+int _media_db_get_media_group_item_count(const char *group_name, media_group_e group, filter_h filter, int *item_count)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	query_builder_s query;
 
-		if(callback((media_info_h)item, user_data) == false)
-		{
-			media_info_destroy((media_info_h)item);
-			break;
-		}
+	media_content_debug_func();
 
-		media_info_destroy((media_info_h)item);
+	if(_media_group_summary_is_usable(group, filter))
+	{
+		if(_media_group_summary_get_media_count(group, group_name, item_count) == MEDIA_CONTENT_ERROR_NONE)
+			return MEDIA_CONTENT_ERROR_NONE;
 	}
 
-	SQLITE3_FINALIZE(stmt);
+	_content_query_builder_init(&query);
+
+	if(group_name != NULL)
+		_content_query_builder_appendf(&query, SELECT_MEDIA_COUNT_FROM_GROUP, __media_db_get_group_name(group), group_name);
+	else
+		_content_query_builder_appendf(&query, SELECT_MEDIA_COUNT_FROM_GROUP_NULL, __media_db_get_group_name(group));
+
+	ret = _media_filter_attribute_append_query(_content_get_attirbute_handle(), filter, &query);
+	_content_query_builder_append(&query, QUERY_KEYWORD_BRACKET);
+
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = __media_db_get_count(&query, item_count);
+
+	_content_query_builder_release(&query);
+
+	return ret;
+}
+
+int _media_db_get_media_group_item(const char *group_name, media_group_e group, filter_h filter, media_info_cb callback, void *user_data)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	query_builder_s query;
+
+	media_content_debug_func();
+
+	_content_query_builder_init(&query);
+
+	_media_info_append_columns(&query, filter);
+	_media_filter_append_seek_column(filter, &query);
+
+	if(group_name != NULL)
+		_content_query_builder_appendf(&query, FROM_MEDIA_BY_GROUP, __media_db_get_group_name(group), group_name);
+	else
+		_content_query_builder_appendf(&query, FROM_MEDIA_BY_GROUP_NULL, __media_db_get_group_name(group));
+
+	ret = _media_filter_attribute_append_media_query(_content_get_attirbute_handle(), filter, &query);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = __media_db_get_media_item(&query, filter, 0, callback, NULL, user_data);
+
+	_content_query_builder_release(&query);
 
 	return ret;
 }
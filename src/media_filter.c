@@ -15,10 +15,13 @@
 */
 
 
+#include <pthread.h>
 #include <media_content.h>
 #include <media_info_private.h>
 #include <media-svc.h>
 
+/* Operators split words in a condition. Two character operators must come
+ * before their one character prefix. */
 static char *media_token[] =
 {
 	" ",
@@ -27,32 +30,74 @@ static char *media_token[] =
 	"(",
 	")",
 	"=",
+	"!=",
+	"<>",
 	"<=",
 	"<",
 	">=",
 	">",
+	",",
 };
 
+#define MEDIA_TOKEN_OPERATOR_START 3
+#define MEDIA_TOKEN_COUNT (sizeof(media_token) / sizeof(media_token[0]))
+
 
 typedef struct _token_t
 {
 	int type;
-	char *str;
+	const char *str;	// points into the source string or into the attribute map, not NUL terminated
+	int len;
 }token_t;
 
+/* Tokens live in one array, the first TOKEN_LOCAL_SIZE of them on the stack */
+#define TOKEN_LOCAL_SIZE 64
+
+typedef struct
+{
+	token_t *tokens;
+	int count;
+	int size;
+	int str_len;		// sum of the token lengths
+	int attr_count;		// tokens replaced by a db field
+	token_t local[TOKEN_LOCAL_SIZE];
+}token_list_s;
+
 
 #define MAX_LEFT_VALUE 512
 #define SPACE_LEN 1
 #define SPACE " "
 #define UNKNOWN_TYPE 1000
 #define STRING_TYPE 100
+#define ATTR_TYPE 200
+
+/* Continuation token : "k1:<media_uuid>:v:<order key>", or "k1:<media_uuid>:n:" if the key is NULL */
+#define SEEK_TOKEN_PREFIX "k1:"
+#define SEEK_TOKEN_VALUE 'v'
+#define SEEK_TOKEN_NULL 'n'
+#define SEEK_KEY_SIZE 32
 
 static char *__get_order_str(media_content_order_e order_enum);
 static char *__get_collate_str(media_content_collation_e collate_type);
 static void __filter_attribute_free_value(gpointer key, gpointer value, gpointer user_data);
-static char *__media_filter_replace_attr(attribute_h attr, char *name);
-static int __tokenize_operator(token_t *token, const char *str, int op_type);
-static int __tokenize(GList **token_list, const char *str);
+static void __media_filter_replace_attr(attribute_s *_attr, token_t *token);
+static void __token_list_init(token_list_s *list);
+static void __token_list_release(token_list_s *list);
+static int __token_list_add(token_list_s *list, attribute_s *_attr, int type, const char *str, int len);
+static char *__token_list_join(token_list_s *list, const char *head, const char *attr_suffix, const char *tail);
+static int __tokenize_operator(const char *str, int *op_type);
+static int __tokenize_attribute(token_list_s *list, attribute_s *_attr, const char *str);
+static int __tokenize(token_list_s *list, attribute_s *_attr, const char *str);
+static int __media_filter_order_generate(attribute_h attr, filter_s *_filter, char **generated_order, char **seek_column);
+static void __media_filter_compiled_clear(filter_s *_filter);
+static filter_compiled_s *__media_filter_get_compiled(attribute_s *_attr, filter_s *_filter);
+static void __media_filter_seek_clear(filter_s *_filter);
+static void __media_filter_append_seek(filter_s *_filter, const char *column, query_builder_s *query);
+static int __media_filter_append_query(attribute_h attr, filter_h filter, const char *default_order, const char *group_by, bool use_seek, query_builder_s *query);
+
+/* Guards the compiled clauses kept on filter handles and the attribute id counter */
+static pthread_mutex_t g_filter_mutex = PTHREAD_MUTEX_INITIALIZER;
+static unsigned int g_attr_id = 0;
 
 static char *__get_order_str(media_content_order_e order_enum)
 {
@@ -83,514 +128,406 @@ static void __filter_attribute_free_value(gpointer key, gpointer value, gpointer
 	SAFE_FREE(value);
 }
 
-static char *__media_filter_replace_attr(attribute_h attr, char *name)
+/* Replaces a word by the db field it is mapped to. The map owns the value, so only the pointer is kept. */
+static void __media_filter_replace_attr(attribute_s *_attr, token_t *token)
 {
-	char *key_temp;
-	char *generated_value;
-	attribute_s *_attr = (attribute_s *)attr;
+	char name[MAX_LEFT_VALUE];
+	char *generated_value = NULL;
+
+	if(token->len >= MAX_LEFT_VALUE)
+		return;
 
-	if(!g_hash_table_lookup_extended(_attr->attr_map,
-										name,
-										(gpointer)&key_temp, (gpointer)&generated_value))
+	memcpy(name, token->str, token->len);
+	name[token->len] = '\0';
+
+	generated_value = (char*)g_hash_table_lookup(_attr->attr_map, name);
+	if(STRING_VALID(generated_value))
 	{
-		//can't find the value
-		//media_content_error("NOT_FOUND_VALUE(%s)", name);
-		return NULL;
+		token->type = ATTR_TYPE;
+		token->str = generated_value;
+		token->len = strlen(generated_value);
 	}
+}
 
-	if(STRING_VALID(generated_value))
+static void __token_list_init(token_list_s *list)
+{
+	list->tokens = list->local;
+	list->count = 0;
+	list->size = TOKEN_LOCAL_SIZE;
+	list->str_len = 0;
+	list->attr_count = 0;
+}
+
+static void __token_list_release(token_list_s *list)
+{
+	if(list->tokens != list->local)
+		SAFE_FREE(list->tokens);
+
+	__token_list_init(list);
+}
+
+static int __token_list_add(token_list_s *list, attribute_s *_attr, int type, const char *str, int len)
+{
+	int size = 0;
+	token_t *tokens = NULL;
+	token_t *token = NULL;
+
+	if(list->count == list->size)
 	{
-		return strdup(generated_value);
+		size = list->size * 2;
+
+		if(list->tokens == list->local)
+		{
+			tokens = (token_t*)malloc(size * sizeof(token_t));
+			if(tokens != NULL)
+				memcpy(tokens, list->local, list->count * sizeof(token_t));
+		}
+		else
+		{
+			tokens = (token_t*)realloc(list->tokens, size * sizeof(token_t));
+		}
+
+		if(tokens == NULL)
+		{
+			media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
+			return MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
+		}
+
+		list->tokens = tokens;
+		list->size = size;
 	}
 
-	media_content_error("__media_filter_replace_attr fail");
+	token = &list->tokens[list->count++];
+	token->type = type;
+	token->str = str;
+	token->len = len;
+
+	if(type == UNKNOWN_TYPE && _attr != NULL)
+		__media_filter_replace_attr(_attr, token);
+
+	if(token->type == ATTR_TYPE)
+		list->attr_count++;
 
-	return NULL;
+	list->str_len += token->len;
+
+	return MEDIA_CONTENT_ERROR_NONE;
 }
 
-static int __tokenize_operator(token_t *token, const char *str, int op_type)
+/* Builds "<head><token> <token> ... <tail>" in one allocation.
+ * attr_suffix, if any, follows every token which was replaced by a db field. */
+static char *__token_list_join(token_list_s *list, const char *head, const char *attr_suffix, const char *tail)
 {
-	int ret = 0;
-	const char *tmp = str;
+	int idx = 0;
+	int size = 0;
+	int head_len = STRING_VALID(head) ? strlen(head) : 0;
+	int suffix_len = STRING_VALID(attr_suffix) ? strlen(attr_suffix) : 0;
+	int tail_len = STRING_VALID(tail) ? strlen(tail) : 0;
+	char *result = NULL;
+	char *pos = NULL;
+	token_t *token = NULL;
 
-	if(token != NULL && STRING_VALID(tmp))
+	size = head_len + list->str_len + list->count * SPACE_LEN + list->attr_count * (suffix_len + SPACE_LEN) + tail_len + 1;
+
+	result = (char*)malloc(size);
+	if(result == NULL)
 	{
-		token->type = op_type;
-		int token_size = strlen(media_token[op_type]);
-		token->str = (char*)calloc(token_size+1, sizeof(char));
-		strncpy(token->str, tmp, token_size);
-		media_content_debug("type : [%d] str : [%s] \n", token->type, token->str);
-		ret = token_size;
+		media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
+		return NULL;
 	}
-	else
+
+	pos = result;
+	if(head_len > 0)
+		memcpy(pos, head, head_len);
+	pos += head_len;
+
+	for(idx = 0; idx < list->count; idx++)
 	{
-		ret = -1;
+		token = &list->tokens[idx];
+
+		memcpy(pos, token->str, token->len);
+		pos += token->len;
+		*pos++ = ' ';
+
+		if(token->type == ATTR_TYPE && suffix_len > 0)
+		{
+			memcpy(pos, attr_suffix, suffix_len);
+			pos += suffix_len;
+			*pos++ = ' ';
+		}
 	}
 
-	return ret;
+	if(tail_len > 0)
+		memcpy(pos, tail, tail_len);
+	pos += tail_len;
+	*pos = '\0';
+
+	return result;
 }
 
-static int __tokenize_string(token_t *token, const char *str, int size)
+/* Returns the length of the operator at str, 0 if there is none */
+static int __tokenize_operator(const char *str, int *op_type)
 {
-	int ret = size;
-	const char *tmp = str;
+	unsigned int idx = 0;
+	const char *op = NULL;
 
-	if(token != NULL && STRING_VALID(tmp) && size > 0)
+	for(idx = MEDIA_TOKEN_OPERATOR_START; idx < MEDIA_TOKEN_COUNT; idx++)
 	{
-		token->str	= (char*)calloc(size+1, sizeof(char));
-		token->type = UNKNOWN_TYPE;
-		strncpy(token->str, tmp, size);
-		media_content_debug("type : [%d] str : [%s] \n", token->type, token->str);
-	}
-	else
-	{
-		ret = -1;
+		op = media_token[idx];
+
+		if(op[0] == str[0] && (op[1] == '\0' || op[1] == str[1]))
+		{
+			*op_type = idx;
+			return (op[1] == '\0') ? 1 : 2;
+		}
 	}
 
-	return ret;
+	return 0;
 }
 
-static int __tokenize_attribute(GList **token_list, const char *str)
+/* Splits an order keyword like "MEDIA_TITLE, MEDIA_ARTIST" into fields and commas */
+static int __tokenize_attribute(token_list_s *list, attribute_s *_attr, const char *str)
 {
-	int ret = 0;
-	int idx = 0;
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	const char *pos = str;
+	const char *word = NULL;
 
 	if(!STRING_VALID(str)) {
 		media_content_error("Parameter string in invalid");
 		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
 	}
 
-	const char *tmp = str;
-	const char *dst_ptr = str + strlen(str);
-
-	for (idx = 0; (*(tmp+idx)) && (tmp < dst_ptr); idx++)
+	for(; ; pos++)
 	{
-		//media_content_debug("[%d] '%c'", idx, tmp[idx]);
-		if(tmp[idx] == ' ')		//" "
-		{
-			if(idx == 0)		// ignore the space.
-			{
-				tmp++;
-				idx = -1;
-				continue;
-			}
-
-			token_t *token = (token_t*)calloc(1, sizeof(token_t));
-			token->type = UNKNOWN_TYPE;
-			token->str = (char*)calloc(idx+1, sizeof(char));
-			strncpy(token->str, tmp, idx);
-			media_content_debug("type : [%d] str : [%s] \n", token->type, token->str);
-			*token_list = g_list_append(*token_list, token);
-			tmp = tmp +idx + strlen(media_token[0]);
-			idx = -1;
-		}
-		else if(tmp[idx] == ',')	// " , "
+		if(*pos == ' ' || *pos == ',' || *pos == '\0')
 		{
-			if(idx != 0)
+			if(word != NULL)
 			{
-				token_t *token = (token_t*)calloc(1, sizeof(token_t));
-				ret = __tokenize_string(token, tmp, idx);
-				if (ret < 0)
-				{
-					media_content_error("tokenize error occued");
-					return -1;
-				}
-				else
-				{
-					*token_list = g_list_append(*token_list, token);
-					tmp = tmp + idx;
-				}
+				ret = __token_list_add(list, _attr, UNKNOWN_TYPE, word, pos - word);
+				media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
+				word = NULL;
 			}
-			token_t *token = (token_t*)calloc(1, sizeof(token_t));
-			int size = __tokenize_operator(token, tmp,3);
 
-			if(token != NULL && STRING_VALID(token->str))
+			if(*pos == ',')
 			{
-				*token_list = g_list_append(*token_list, token);
-				tmp += size;
-				idx = -1;
+				ret = __token_list_add(list, NULL, MEDIA_TOKEN_COUNT - 1, pos, 1);
+				media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
 			}
-			else
-			{
-				media_content_error("tokenize error occued");
-				return -1;
-			}
-		}
-	}
 
-	if(*tmp)			//remained string
-	{
-		token_t *token = (token_t*)calloc(1, sizeof(token_t));
-		__tokenize_string(token, tmp, idx);
-		if(token != NULL && STRING_VALID(token->str))
-		{
-			*token_list = g_list_append(*token_list, token);
+			if(*pos == '\0')
+				break;
 		}
-		else
+		else if(word == NULL)
 		{
-			media_content_error("tokenize error occued");
-			return -1;
+			word = pos;
 		}
 	}
 
 	return MEDIA_CONTENT_ERROR_NONE;
 }
 
-static int __tokenize(GList **token_list, const char *str)
+/* Single pass over the condition. Words are split on spaces and operators, quoted literals
+ * (with '' or "" as an escaped quote) are kept whole and words are translated as they are found. */
+static int __tokenize(token_list_s *list, attribute_s *_attr, const char *str)
 {
-	int ret = 0;
-	int idx = 0;
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	int op_type = 0;
+	int op_len = 0;
+	char quote = '\0';
+	const char *pos = str;
+	const char *word = NULL;
 
 	if(!STRING_VALID(str)) {
 		media_content_error("Parameter string in invalid");
 		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
 	}
 
-	const char *tmp = str;
-	const char *dst_ptr = str + strlen(str);
-
-	for (idx = 0; (*(tmp+idx)) && (tmp < dst_ptr); idx++)
+	while(*pos != '\0')
 	{
-		//media_content_debug("[%d] '%c'", idx, tmp[idx]);
-		if(tmp[idx] == media_token[0][0])		//" "
+		if(*pos == media_token[1][0] || *pos == media_token[2][0])
 		{
-			if(idx == 0)		// ignore the space.
-			{
-				tmp++;
-				idx = -1;
-				continue;
-			}
+			/* A literal glued to a word, like x'0A', stays one token with it */
+			if(word == NULL)
+				word = pos;
 
-			token_t *token = (token_t*)calloc(1, sizeof(token_t));
-			token->type = UNKNOWN_TYPE;
-			token->str = (char*)calloc(idx+1, sizeof(char));
-			strncpy(token->str, tmp, idx);
-			media_content_debug("type : [%d] str : [%s] \n", token->type, token->str);
-			*token_list = g_list_append(*token_list, token);
-			tmp = tmp +idx + strlen(media_token[0]);
-			idx = -1;
-		}
-		else if(tmp[idx] == media_token[1][0])	// " \" "
-		{
-			int j;
-			for(j = idx+1; tmp[j]; j++)	//find next quotation
+			quote = *pos;
+			for(pos++; *pos != '\0'; pos++)
 			{
-				if(tmp[j] == media_token[1][0] && tmp[j+1] == media_token[1][0])
-				{
-					j += 2;
-					continue;
-				}
-				if(tmp[j] == media_token[1][0])
+				if(*pos == quote)
 				{
-					token_t *token = (token_t*)calloc(1, sizeof(token_t));
-					token->str = (char*) calloc(j+1+1, sizeof(char));
-					token->type = STRING_TYPE;
-					strncpy(token->str, tmp, j+1);
-					media_content_debug("type : [%d] str : [%s], j : %d \n", token->type, token->str, j);
-					*token_list = g_list_append(*token_list, token);
-					tmp = tmp + strlen(token->str);
-					idx = -1;
-					break;
+					if(pos[1] != quote)
+						break;
+					pos++;
 				}
 			}
 
-			if(*tmp != '\0' && tmp[j]=='\0')
+			if(*pos == '\0')
 			{
-				token_t *token = (token_t*)calloc(1, sizeof(token_t));
-				token->str = (char*) calloc(j+1,sizeof(char));
-				token->type = UNKNOWN_TYPE;
-				strncpy(token->str, tmp,j);
-				media_content_debug("type : [%d] str : [%s] \n", token->type, token->str);
-				*token_list = g_list_append(*token_list, token);
-				tmp = tmp +strlen(token->str);
-				idx = -1;
-			}
-		}
-		else if(tmp[idx] == media_token[2][0])	// " \' "
-		{
-			int j;
-			for(j = idx+1; tmp[j]; j++)
-			{
-				if(tmp[j] == media_token[2][0] && tmp[j+1] == media_token[2][0])
-				{
-					j += 2;
-					continue;
-				}
-				if(tmp[j] == media_token[2][0])
-				{
-					token_t *token = (token_t*)calloc(1, sizeof(token_t));
-					token->str = (char*) calloc(j+1+1, sizeof(char));
-					token->type = STRING_TYPE;
-					strncpy(token->str, tmp, j+1);
-					media_content_debug("type : [%d] str : [%s] \n", token->type, token->str);
-					*token_list = g_list_append(*token_list, token);
-					tmp = tmp + strlen(token->str);
-					idx = -1;
-					break;
-				}
+				/* Unterminated, keep the rest as it is and let sqlite report it */
+				media_content_error("unterminated literal in [%s]", str);
+				return __token_list_add(list, NULL, STRING_TYPE, word, pos - word);
 			}
 
-			if(*tmp != '\0' && tmp[j]=='\0')
-			{
-				token_t *token = (token_t*)calloc(1, sizeof(token_t));
-				token->str = (char*) calloc(j+1,sizeof(char));
-				token->type = UNKNOWN_TYPE;
-				strncpy(token->str, tmp,j);
-				media_content_debug("type : [%d] str : [%s] \n", token->type, token->str);
-				*token_list = g_list_append(*token_list, token);
-				tmp = tmp + strlen(token->str);
-				idx = -1;
-			}
+			pos++;
+			ret = __token_list_add(list, NULL, STRING_TYPE, word, pos - word);
+			media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
+			word = NULL;
+			continue;
 		}
-		else if(tmp[idx] == media_token[3][0])	//"("
-		{
-			if(idx != 0)
-			{
-				token_t *token = (token_t*)calloc(1, sizeof(token_t));
-				ret = __tokenize_string(token, tmp, idx);
-				if (ret < 0)
-				{
-					media_content_error("tokenize error occued");
-					return -1;
-				}
-				else
-				{
-					*token_list = g_list_append(*token_list, token);
-					tmp = tmp + idx;
-				}
-			}
-			token_t *token = (token_t*)calloc(1, sizeof(token_t));
-			int size = __tokenize_operator(token, tmp,3);
-
-			if(token != NULL && STRING_VALID(token->str))
-			{
-				*token_list = g_list_append(*token_list, token);
-				tmp += size;
-				idx = -1;
-			}
-			else
-			{
-				media_content_error("tokenize error occued");
-				return -1;
-			}
 
-		}
-		else if(tmp[idx] == media_token[4][0])	//")"
+		if(*pos == media_token[0][0])
+			op_len = 0;
+		else if((op_len = __tokenize_operator(pos, &op_type)) == 0)
 		{
-			if(idx != 0)
-			{
-				token_t *token = (token_t*)calloc(1, sizeof(token_t));
-				ret = __tokenize_string(token, tmp, idx);
-				if (ret < 0)
-				{
-					media_content_error("tokenize error occued");
-					return -1;
-				}
-				else
-				{
-					*token_list = g_list_append(*token_list, token);
-					tmp = tmp + idx;
-				}
-			}
-			token_t *token = (token_t*)calloc(1, sizeof(token_t));
-			int size = __tokenize_operator(token, tmp,4);
+			if(word == NULL)
+				word = pos;
+			pos++;
+			continue;
+		}
 
-			if(token != NULL && STRING_VALID(token->str))
-			{
-				*token_list = g_list_append(*token_list, token);
-				tmp += size;
-				idx = -1;
-			}
-			else
-			{
-				media_content_error("tokenize error occued");
-				return -1;
-			}
+		if(word != NULL)
+		{
+			ret = __token_list_add(list, _attr, UNKNOWN_TYPE, word, pos - word);
+			media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
+			word = NULL;
+		}
 
+		if(op_len > 0)
+		{
+			ret = __token_list_add(list, NULL, op_type, pos, op_len);
+			media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
+			pos += op_len;
 		}
-		else if(tmp[idx] == media_token[5][0])	//"="
+		else
 		{
-			if(idx != 0)
-			{
-				token_t *token = (token_t*)calloc(1, sizeof(token_t));
-				ret = __tokenize_string(token, tmp, idx);
-				if (ret < 0)
-				{
-					media_content_error("tokenize error occued");
-					return -1;
-				}
-				else
-				{
-					*token_list = g_list_append(*token_list, token);
-					tmp = tmp + idx;
-				}
-			}
-			token_t *token = (token_t*)calloc(1, sizeof(token_t));
-			int size = __tokenize_operator(token, tmp,5);
+			pos++;
+		}
+	}
 
-			if(token != NULL && STRING_VALID(token->str))
-			{
-				*token_list = g_list_append(*token_list, token);
-				tmp += size;
-				idx = -1;
-			}
-			else
-			{
-				media_content_error("tokenize error occued");
-				return -1;
-			}
+	if(word != NULL)			//remained string
+	{
+		ret = __token_list_add(list, _attr, UNKNOWN_TYPE, word, pos - word);
+		media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
+	}
 
-		}
-		else if(tmp[idx] == media_token[6][0] && tmp[idx+1] == media_token[6][1])	//"<=",
-		{
-			if(idx != 0)
-			{
-				token_t *token = (token_t*)calloc(1, sizeof(token_t));
-				ret = __tokenize_string(token, tmp, idx);
-				if (ret < 0)
-				{
-					media_content_error("tokenize error occued");
-					return -1;
-				}
-				else
-				{
-					*token_list = g_list_append(*token_list, token);
-					tmp = tmp + idx;
-				}
-			}
-			token_t *token = (token_t*)calloc(1, sizeof(token_t));
-			int size = __tokenize_operator(token, tmp,6);
+	return MEDIA_CONTENT_ERROR_NONE;
+}
 
-			if(token != NULL && STRING_VALID(token->str))
-			{
-				*token_list = g_list_append(*token_list, token);
-				tmp += size;
-				idx = -1;
-			}
-			else
-			{
-				media_content_error("tokenize error occued");
-				return -1;
-			}
+static int __media_filter_order_generate(attribute_h attr, filter_s *_filter, char **generated_order, char **seek_column)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	int idx = 0;
+	token_list_s token_list;
+	char suffix[COLLATE_STR_SIZE] = {0, };
 
-		}
-		else if(tmp[idx] == media_token[7][0])	//"<",
-		{
-			if(idx != 0)
-			{
-				token_t *token = (token_t*)calloc(1, sizeof(token_t));
-				ret = __tokenize_string(token, tmp, idx);
-				if (ret < 0)
-				{
-					media_content_error("tokenize error occued");
-					return -1;
-				}
-				else
-				{
-					*token_list = g_list_append(*token_list, token);
-					tmp = tmp + idx;
-				}
-			}
-			token_t *token = (token_t*)calloc(1, sizeof(token_t));
-			int size = __tokenize_operator(token, tmp,7);
+	*generated_order = NULL;
+	*seek_column = NULL;
 
-			if(token != NULL && STRING_VALID(token->str))
-			{
-				*token_list = g_list_append(*token_list, token);
-				tmp += size;
-				idx = -1;
-			}
-			else
-			{
-				media_content_error("tokenize error occued");
-				return -1;
-			}
+	if(!STRING_VALID(_filter->order_keyword) || ((_filter->order_type != MEDIA_CONTENT_ORDER_ASC) && (_filter->order_type != MEDIA_CONTENT_ORDER_DESC)))
+		return MEDIA_CONTENT_ERROR_NONE;
 
-		}
-		else if(tmp[idx] == media_token[8][0] && tmp[idx+1] == media_token[8][1])	//">=",
-		{
-			if(idx != 0)
-			{
-				token_t *token = (token_t*)calloc(1, sizeof(token_t));
-				ret = __tokenize_string(token, tmp, idx);
-				if (ret < 0)
-				{
-					media_content_error("tokenize error occued");
-					return -1;
-				}
-				else
-				{
-					*token_list = g_list_append(*token_list, token);
-					tmp = tmp + idx;
-				}
-			}
-			token_t *token = (token_t*)calloc(1, sizeof(token_t));
-			int size = __tokenize_operator(token, tmp,8);
+	media_content_verbose("Tokenize for [%s]", _filter->order_keyword);
 
-			if(token != NULL && STRING_VALID(token->str))
-			{
-				*token_list = g_list_append(*token_list, token);
-				tmp += size;
-				idx = -1;
-			}
-			else
-			{
-				media_content_error("tokenize error occued");
-				return -1;
-			}
+	__token_list_init(&token_list);
 
-		}
-		else if(tmp[idx] == media_token[9][0])	//">",
-		{
-			if(idx != 0)
-			{
-				token_t *token = (token_t*)calloc(1, sizeof(token_t));
-				ret = __tokenize_string(token, tmp, idx);
-				if (ret < 0)
-				{
-					media_content_error("tokenize error occued");
-					return -1;
-				}
-				else
-				{
-					*token_list = g_list_append(*token_list, token);
-					tmp = tmp + idx;
-				}
-			}
-			token_t *token = (token_t*)calloc(1, sizeof(token_t));
-			int size = __tokenize_operator(token, tmp,9);
+	ret = __tokenize_attribute(&token_list, (attribute_s*)attr, _filter->order_keyword);
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+	{
+		__token_list_release(&token_list);
+		media_content_error("INVALID_PARAMETER(0x%08x):Invalid the condition", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
 
-			if(token != NULL && STRING_VALID(token->str))
-			{
-				*token_list = g_list_append(*token_list, token);
-				tmp += size;
-				idx = -1;
-			}
-			else
-			{
-				media_content_error("tokenize error occued");
-				return -1;
-			}
+	for(idx = 0; idx < token_list.count; idx++)
+	{
+		if(token_list.tokens[idx].type == UNKNOWN_TYPE)
+			media_content_error("There is no matched db field for %.*s", token_list.tokens[idx].len, token_list.tokens[idx].str);
+	}
 
-		}
+	if(_filter->order_collate_type == MEDIA_CONTENT_COLLATE_NOCASE || _filter->order_collate_type == MEDIA_CONTENT_COLLATE_RTRIM) {
+		snprintf(suffix, sizeof(suffix), "COLLATE %s %s", __get_collate_str(_filter->order_collate_type), __get_order_str(_filter->order_type));
+	} else {
+		snprintf(suffix, sizeof(suffix), "%s", __get_order_str(_filter->order_type));
 	}
 
-	if(*tmp)			//remained string
+	*generated_order = __token_list_join(&token_list, QUERY_KEYWORD_ORDER_BY SPACE, suffix, NULL);
+	if(*generated_order == NULL)
+		ret = MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
+
+	/* Only an order on one db field can be resumed from a continuation token */
+	if(ret == MEDIA_CONTENT_ERROR_NONE && token_list.count == 1 && token_list.tokens[0].type == ATTR_TYPE)
 	{
-		token_t *token = (token_t*)calloc(1, sizeof(token_t));
-		__tokenize_string(token, tmp, idx);
-		if(token != NULL && STRING_VALID(token->str))
+		*seek_column = strndup(token_list.tokens[0].str, token_list.tokens[0].len);
+		if(*seek_column == NULL)
 		{
-			*token_list = g_list_append(*token_list, token);
-		}
-		else
-		{
-			media_content_error("tokenize error occued");
-			return -1;
+			SAFE_FREE(*generated_order);
+			media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
+			ret = MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
 		}
 	}
 
-	return MEDIA_CONTENT_ERROR_NONE;
+	__token_list_release(&token_list);
+
+	return ret;
+}
+
+static void __media_filter_compiled_clear(filter_s *_filter)
+{
+	int idx = 0;
+
+	for(idx = 0; idx < MEDIA_FILTER_COMPILED_SLOT; idx++)
+	{
+		SAFE_FREE(_filter->compiled[idx].condition);
+		SAFE_FREE(_filter->compiled[idx].order);
+		SAFE_FREE(_filter->compiled[idx].seek_column);
+		_filter->compiled[idx].attr_id = 0;
+	}
+
+	/* The key in it was read for the order which is replaced */
+	SAFE_FREE(_filter->seek_last_token);
+}
+
+/* Called with g_filter_mutex held. Translation only depends on the attribute map and on the
+ * condition/order set on the filter, so it is done once per map and reused until they change. */
+static filter_compiled_s *__media_filter_get_compiled(attribute_s *_attr, filter_s *_filter)
+{
+	int idx = 0;
+	filter_compiled_s *compiled = NULL;
+
+	for(idx = 0; idx < MEDIA_FILTER_COMPILED_SLOT; idx++)
+	{
+		if(_filter->compiled[idx].attr_id == _attr->attr_id)
+			return &_filter->compiled[idx];
+
+		if(compiled == NULL && _filter->compiled[idx].attr_id == 0)
+			compiled = &_filter->compiled[idx];
+	}
+
+	if(compiled == NULL)
+	{
+		/* Every slot is taken by another map, drop the oldest one */
+		SAFE_FREE(_filter->compiled[0].condition);
+		SAFE_FREE(_filter->compiled[0].order);
+		SAFE_FREE(_filter->compiled[0].seek_column);
+		memmove(&_filter->compiled[0], &_filter->compiled[1], sizeof(filter_compiled_s) * (MEDIA_FILTER_COMPILED_SLOT - 1));
+		compiled = &_filter->compiled[MEDIA_FILTER_COMPILED_SLOT - 1];
+		memset(compiled, 0x00, sizeof(filter_compiled_s));
+	}
+
+	if(STRING_VALID(_filter->condition))
+	{
+		if(_media_filter_attribute_generate((attribute_h)_attr, _filter->condition, _filter->condition_collate_type, &compiled->condition) != MEDIA_CONTENT_ERROR_NONE)
+			return NULL;
+	}
+
+	if(__media_filter_order_generate((attribute_h)_attr, _filter, &compiled->order, &compiled->seek_column) != MEDIA_CONTENT_ERROR_NONE)
+	{
+		SAFE_FREE(compiled->condition);
+		return NULL;
+	}
+
+	compiled->attr_id = _attr->attr_id;
+
+	return compiled;
 }
 
 int _media_filter_attribute_create(attribute_h *attr)
@@ -613,6 +550,11 @@ int _media_filter_attribute_create(attribute_h *attr)
 	else
 	{
 		_attr->attr_map = g_hash_table_new (g_str_hash, g_str_equal);
+
+		pthread_mutex_lock(&g_filter_mutex);
+		_attr->attr_id = ++g_attr_id;
+		pthread_mutex_unlock(&g_filter_mutex);
+
 		*attr = (attribute_h)_attr;
 	}
 
@@ -662,6 +604,17 @@ int _media_filter_attribute_add(attribute_h attr, char *user_attr, char *platfor
 	return ret;
 }
 
+/* Column of a user attribute, NULL if the attribute is not in the map */
+const char *_media_filter_attribute_get_field(attribute_h attr, const char *user_attr)
+{
+	attribute_s *_attr = (attribute_s*)attr;
+
+	if(_attr == NULL || !STRING_VALID(user_attr))
+		return NULL;
+
+	return (const char *)g_hash_table_lookup(_attr->attr_map, user_attr);
+}
+
 int _media_filter_attribute_destory(attribute_h attr)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
@@ -688,12 +641,9 @@ int _media_filter_attribute_destory(attribute_h attr)
 
 int _media_filter_attribute_generate(attribute_h attr, char *condition, media_content_collation_e collate_type, char **generated_condition)
 {
-	int idx = 0;
-	GList *token_list = NULL;
-	int size = 0;
 	int ret = MEDIA_CONTENT_ERROR_NONE;
-	int total_str_size = 0;
-	token_t *token;
+	token_list_s token_list;
+	char tail[COLLATE_STR_SIZE] = {0, };
 
 	if((condition == NULL) || (generated_condition == NULL))
 	{
@@ -701,193 +651,292 @@ int _media_filter_attribute_generate(attribute_h attr, char *condition, media_co
 		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
 	}
 
-	if(attr != NULL)
+	if(attr == NULL)
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+
+	__token_list_init(&token_list);
+
+	ret = __tokenize(&token_list, (attribute_s*)attr, condition);
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
 	{
-		if(__tokenize(&token_list, condition) < 0)
-		{
-			media_content_error("INVALID_PARAMETER(0x%08x):Invalid the condition", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
-			return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
-		}
+		__token_list_release(&token_list);
+		media_content_error("INVALID_PARAMETER(0x%08x):Invalid the condition", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return (ret == MEDIA_CONTENT_ERROR_OUT_OF_MEMORY) ? ret : MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
 
-		for(idx = 0; idx < g_list_length(token_list); idx++)
-		{
-			token = (token_t*)g_list_nth_data(token_list, idx);
+	if(collate_type == MEDIA_CONTENT_COLLATE_NOCASE || collate_type == MEDIA_CONTENT_COLLATE_RTRIM) {
+		snprintf(tail, sizeof(tail), "COLLATE %s ", __get_collate_str(collate_type));
+	}
 
-			if(token->type == UNKNOWN_TYPE)
-			{
-				char *replace_str = __media_filter_replace_attr(attr, token->str);
-				if(STRING_VALID(replace_str))
-				{
-					SAFE_FREE(token->str);
-					token->str = replace_str;
-				}
-			}
+	*generated_condition = __token_list_join(&token_list, NULL, NULL, tail);
+	if(*generated_condition == NULL)
+		ret = MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
+	else
+		media_content_verbose("Condition : %s (%d tokens)", *generated_condition, token_list.count);
 
-			total_str_size += strlen(token->str)+1;
-			media_content_debug("[%d][type:%d]:%s\n", idx, token->type, token->str);
-		}
+	__token_list_release(&token_list);
 
-		//make the statment
-		size = total_str_size + COLLATE_STR_SIZE + 1;
-		* generated_condition = (char*)calloc(size, sizeof(char));
+	return ret;
+}
 
-		for(idx = 0; idx < g_list_length(token_list); idx++)
-		{
-			token = (token_t*)g_list_nth_data(token_list, idx);
+int _media_filter_attribute_append_query(attribute_h attr, filter_h filter, query_builder_s *query)
+{
+	return __media_filter_append_query(attr, filter, NULL, NULL, FALSE, query);
+}
 
-			if((token != NULL) && STRING_VALID(token->str))
-			{
-				SAFE_STRLCAT(*generated_condition, token->str, size);
-				SAFE_STRLCAT(*generated_condition, SPACE, size);
+int _media_filter_attribute_append_query_with_order(attribute_h attr, filter_h filter, const char *default_order, query_builder_s *query)
+{
+	return __media_filter_append_query(attr, filter, default_order, NULL, FALSE, query);
+}
 
-				SAFE_FREE(token->str);
-				SAFE_FREE(token);
-			}
-		}
+int _media_filter_attribute_append_media_query(attribute_h attr, filter_h filter, query_builder_s *query)
+{
+	return __media_filter_append_query(attr, filter, NULL, NULL, TRUE, query);
+}
 
-		if(collate_type == MEDIA_CONTENT_COLLATE_NOCASE || collate_type == MEDIA_CONTENT_COLLATE_RTRIM) {
-			SAFE_STRLCAT(*generated_condition, "COLLATE ", size);
-			SAFE_STRLCAT(*generated_condition, __get_collate_str(collate_type), size);
-			SAFE_STRLCAT(*generated_condition, SPACE, size);
-		}
+int _media_filter_attribute_append_group_query(attribute_h attr, filter_h filter, const char *group_by, query_builder_s *query)
+{
+	return __media_filter_append_query(attr, filter, group_by, group_by, FALSE, query);
+}
+
+void _media_filter_append_seek_column(filter_h filter, query_builder_s *query)
+{
+	filter_s *_filter = (filter_s*)filter;
+	filter_compiled_s *compiled = NULL;
+
+	if(_filter == NULL || !_filter->seek)
+		return;
 
-		media_content_debug("statement : %s(%d) (total:%d) \n", *generated_condition, strlen(*generated_condition), total_str_size);
-		media_content_debug("Condition : %s", *generated_condition);
+	pthread_mutex_lock(&g_filter_mutex);
 
-		//if(*generated_condition != NULL)
-		//	res = 1;
+	/* Without a single field order the query fails in _media_filter_attribute_append_media_query() */
+	compiled = __media_filter_get_compiled((attribute_s*)_content_get_attirbute_handle(), _filter);
+	if(compiled != NULL && compiled->seek_column != NULL)
+		_content_query_builder_appendf(query, ", %s", compiled->seek_column);
 
-		if(token_list != NULL)
-			g_list_free(token_list);
+	pthread_mutex_unlock(&g_filter_mutex);
+}
+
+int _media_filter_make_seek_token(sqlite3_stmt *stmt, int column, const char *media_id, char **token, int *token_size)
+{
+	char key[SEEK_KEY_SIZE] = {0, };
+	const char *key_str = NULL;
+	char *buf = NULL;
+	int size = 0;
+
+	/* Keep every digit of a real key so that the seek compares equal to the row it came from */
+	switch(sqlite3_column_type(stmt, column)) {
+		case SQLITE_NULL:
+			key_str = NULL;
+			break;
+		case SQLITE_FLOAT:
+			snprintf(key, sizeof(key), "%.17g", sqlite3_column_double(stmt, column));
+			key_str = key;
+			break;
+		default:
+			key_str = (const char *)sqlite3_column_text(stmt, column);
+			if(key_str == NULL)
+				key_str = "";
+			break;
 	}
-	else
+
+	size = strlen(SEEK_TOKEN_PREFIX) + strlen(media_id) + 3 + ((key_str != NULL) ? strlen(key_str) : 0) + 1;
+
+	if(size > *token_size)
 	{
-		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
-		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+		buf = (char*)realloc(*token, size);
+		if(buf == NULL)
+		{
+			media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
+			return MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
+		}
+
+		*token = buf;
+		*token_size = size;
 	}
 
-	return ret;
+	if(key_str != NULL)
+		snprintf(*token, size, SEEK_TOKEN_PREFIX"%s:%c:%s", media_id, SEEK_TOKEN_VALUE, key_str);
+	else
+		snprintf(*token, size, SEEK_TOKEN_PREFIX"%s:%c:", media_id, SEEK_TOKEN_NULL);
+
+	return MEDIA_CONTENT_ERROR_NONE;
 }
 
-int _media_filter_attribute_option_generate(attribute_h attr, filter_h filter, char **generated_option)
+void _media_filter_set_last_seek_token(filter_h filter, char *token)
 {
-	int ret = MEDIA_CONTENT_ERROR_NONE;
-	filter_s *_filter = NULL;
-	char option_query[DEFAULT_QUERY_SIZE] = {0, };
-	char condition[DEFAULT_QUERY_SIZE] = {0, };
-	int size = 0;
-	//bool order_by = true;
+	filter_s *_filter = (filter_s*)filter;
 
-	media_content_debug_func();
+	pthread_mutex_lock(&g_filter_mutex);
+	SAFE_FREE(_filter->seek_last_token);
+	_filter->seek_last_token = token;
+	pthread_mutex_unlock(&g_filter_mutex);
+}
 
-	if(filter == NULL)
+/* Compiled clauses are not copied, the copy compiles its own on first use */
+int _media_filter_clone(filter_h filter, filter_h *clone)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	filter_s *_filter = (filter_s*)filter;
+	filter_s *_clone = NULL;
+
+	ret = media_filter_create((filter_h*)&_clone);
+	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
+
+	_clone->order_type = _filter->order_type;
+	_clone->condition_collate_type = _filter->condition_collate_type;
+	_clone->order_collate_type = _filter->order_collate_type;
+	_clone->offset = _filter->offset;
+	_clone->count = _filter->count;
+	_clone->field_groups = _filter->field_groups;
+	_clone->seek = _filter->seek;
+
+	if(_filter->condition != NULL)
+		_clone->condition = strdup(_filter->condition);
+	if(_filter->order_keyword != NULL)
+		_clone->order_keyword = strdup(_filter->order_keyword);
+	if(_filter->seek_media_id != NULL)
+		_clone->seek_media_id = strdup(_filter->seek_media_id);
+	if(_filter->seek_key != NULL)
+		_clone->seek_key = strdup(_filter->seek_key);
+
+	if((_filter->condition != NULL && _clone->condition == NULL) || (_filter->order_keyword != NULL && _clone->order_keyword == NULL) ||
+		(_filter->seek_media_id != NULL && _clone->seek_media_id == NULL) || (_filter->seek_key != NULL && _clone->seek_key == NULL))
 	{
-		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
-		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+		media_filter_destroy((filter_h)_clone);
+		media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
+		return MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
 	}
 
-	if(attr == NULL)
+	*clone = (filter_h)_clone;
+
+	return MEDIA_CONTENT_ERROR_NONE;
+}
+
+static void __media_filter_seek_clear(filter_s *_filter)
+{
+	_filter->seek = FALSE;
+	SAFE_FREE(_filter->seek_media_id);
+	SAFE_FREE(_filter->seek_key);
+	SAFE_FREE(_filter->seek_last_token);
+}
+
+/* Rows after (key, media_uuid) in the order of the filter. Row values are not supported by the
+ * sqlite we ship with, so the comparison is spelled out. NULL keys come first in ascending order. */
+static void __media_filter_append_seek(filter_s *_filter, const char *column, query_builder_s *query)
+{
+	char collate[COLLATE_STR_SIZE] = {0, };
+	bool asc = (_filter->order_type == MEDIA_CONTENT_ORDER_ASC);
+
+	if(_filter->order_collate_type == MEDIA_CONTENT_COLLATE_NOCASE || _filter->order_collate_type == MEDIA_CONTENT_COLLATE_RTRIM)
+		snprintf(collate, sizeof(collate), " COLLATE %s", __get_collate_str(_filter->order_collate_type));
+
+	if(_filter->seek_key != NULL)
 	{
-		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
-		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+		if(asc)
+			_content_query_builder_appendf(query, " AND (%s%s > ? OR (%s%s = ? AND media_uuid > ?))", column, collate, column, collate);
+		else
+			_content_query_builder_appendf(query, " AND (%s%s < ? OR (%s%s = ? AND media_uuid < ?) OR %s IS NULL)", column, collate, column, collate, column);
+
+		_content_query_builder_bind_text(query, _filter->seek_key);
+		_content_query_builder_bind_text(query, _filter->seek_key);
+	}
+	else
+	{
+		if(asc)
+			_content_query_builder_appendf(query, " AND (%s IS NOT NULL OR media_uuid > ?)", column);
+		else
+			_content_query_builder_appendf(query, " AND (%s IS NULL AND media_uuid < ?)", column);
 	}
 
-	_filter = (filter_s*)filter;
+	_content_query_builder_bind_text(query, _filter->seek_media_id);
+}
 
-	memset(option_query, 0x00, sizeof(option_query));
+static int __media_filter_append_query(attribute_h attr, filter_h filter, const char *default_order, const char *group_by, bool use_seek, query_builder_s *query)
+{
+	attribute_s *_attr = (attribute_s*)attr;
+	filter_s *_filter = (filter_s*)filter;
+	filter_compiled_s *compiled = NULL;
 
-	/* Order by*/
-	if(STRING_VALID(_filter->order_keyword) && ((_filter->order_type == MEDIA_CONTENT_ORDER_ASC) ||(_filter->order_type == MEDIA_CONTENT_ORDER_DESC)))
+	if(_filter == NULL)
 	{
-		int idx = 0;
-		int total_str_size = 0;
-		GList *token_list = NULL;
-		token_t *token;
-		char *attr_str;
+		if(STRING_VALID(group_by) && query != NULL)
+			_content_query_builder_appendf(query, " GROUP BY %s", group_by);
 
-		media_content_debug("Tokenize for [%s]", _filter->order_keyword);
-		if(__tokenize_attribute(&token_list, _filter->order_keyword) < 0)
-		{
-			media_content_error("INVALID_PARAMETER(0x%08x):Invalid the condition", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
-			return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
-		}
+		if(STRING_VALID(default_order) && query != NULL)
+			_content_query_builder_appendf(query, " "QUERY_KEYWORD_ORDER_BY" %s", default_order);
 
-		for(idx = 0; idx < g_list_length(token_list); idx++)
-		{
-			token = (token_t*)g_list_nth_data(token_list, idx);
+		return (query != NULL) ? query->error : MEDIA_CONTENT_ERROR_NONE;
+	}
 
-			if(token->type == UNKNOWN_TYPE)
-			{
-				char *replace_str = __media_filter_replace_attr(attr, token->str);
-				if(STRING_VALID(replace_str))
-				{
-					attr_str = (char*)calloc(strlen(replace_str) + COLLATE_STR_SIZE + 1, sizeof(char));
+	if(_attr == NULL || query == NULL)
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
 
-					if(_filter->order_collate_type == MEDIA_CONTENT_COLLATE_NOCASE || _filter->order_collate_type == MEDIA_CONTENT_COLLATE_RTRIM) {
-						snprintf(attr_str, strlen(replace_str) + COLLATE_STR_SIZE + 1, "%s COLLATE %s %s", replace_str, __get_collate_str(_filter->order_collate_type), __get_order_str(_filter->order_type));
-					} else {
-						snprintf(attr_str, strlen(replace_str) + COLLATE_STR_SIZE + 1, "%s %s", replace_str, __get_order_str(_filter->order_type));
-					}
+	use_seek = use_seek && _filter->seek;
 
-					SAFE_FREE(token->str);
-					token->str = attr_str;
-					SAFE_FREE(replace_str);
-				}
-				else
-				{
-					media_content_error("There is no matched db field for %s", token->str);
-				}
-			}
+	pthread_mutex_lock(&g_filter_mutex);
 
-			total_str_size += strlen(token->str) + 1;
-			media_content_debug("[%d][type:%d]:%s\n", idx, token->type, token->str);
-		}
+	compiled = __media_filter_get_compiled(_attr, _filter);
+	if(compiled == NULL)
+	{
+		pthread_mutex_unlock(&g_filter_mutex);
+		media_content_error("INVALID_PARAMETER(0x%08x):Invalid the condition", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
 
-		//make the statment
-		char *generated_condition = NULL;
-		size = total_str_size + COLLATE_STR_SIZE + 1;
-		generated_condition = (char*)calloc(size, sizeof(char));
+	if(use_seek && compiled->seek_column == NULL)
+	{
+		pthread_mutex_unlock(&g_filter_mutex);
+		media_content_error("INVALID_OPERATION(0x%08x):Continuation token needs an order on one field", MEDIA_CONTENT_ERROR_INVALID_OPERATION);
+		return MEDIA_CONTENT_ERROR_INVALID_OPERATION;
+	}
 
-		for(idx = 0; idx < g_list_length(token_list); idx++)
-		{
-			token = (token_t*)g_list_nth_data(token_list, idx);
+	if(STRING_VALID(compiled->condition))
+	{
+		_content_query_builder_append(query, QUERY_KEYWORD_SPACE);
+		_content_query_builder_append(query, QUERY_KEYWORD_AND);
+		_content_query_builder_append(query, QUERY_KEYWORD_SPACE);
+		_content_query_builder_append(query, compiled->condition);
+	}
 
-			if((token != NULL) && STRING_VALID(token->str))
-			{
-				media_content_debug("[%d] %s", idx, token->str);
-				SAFE_STRLCAT(generated_condition, token->str, size);
-				SAFE_STRLCAT(generated_condition, SPACE, size);
+	if(use_seek && _filter->seek_media_id != NULL)
+		__media_filter_append_seek(_filter, compiled->seek_column, query);
 
-				SAFE_FREE(token->str);
-				SAFE_FREE(token);
-			}
-		}
+	if(STRING_VALID(group_by))
+		_content_query_builder_appendf(query, " GROUP BY %s", group_by);
 
-		snprintf(condition, sizeof(condition), "ORDER BY %s", generated_condition);
-		SAFE_STRLCAT(option_query, condition, sizeof(option_query));
+	if(STRING_VALID(compiled->order))
+	{
+		_content_query_builder_append(query, QUERY_KEYWORD_SPACE);
+		_content_query_builder_append(query, compiled->order);
 
-		if(token_list != NULL)
-			g_list_free(token_list);
+		if(use_seek)
+			_content_query_builder_appendf(query, ", media_uuid %s", __get_order_str(_filter->order_type));
 	}
-
-	/* offset */
-	if((_filter->offset >= 0) && (_filter->count >= 0))
+	else if(STRING_VALID(default_order))
 	{
-		SAFE_STRLCAT(option_query, SPACE, sizeof(option_query));
-		snprintf(condition, sizeof(condition), "LIMIT %d, %d", _filter->offset, _filter->count);
-		SAFE_STRLCAT(option_query, condition, sizeof(option_query));
+		_content_query_builder_appendf(query, " "QUERY_KEYWORD_ORDER_BY" %s", default_order);
 	}
 
-	if(STRING_VALID(option_query))
+	pthread_mutex_unlock(&g_filter_mutex);
+
+	if(use_seek)
 	{
-		*generated_option = strdup(option_query);
+		if(_filter->count >= 0)
+			_content_query_builder_appendf(query, " LIMIT %d", _filter->count);
 	}
-	else
+	else if((_filter->offset >= 0) && (_filter->count >= 0))
 	{
-		*generated_option = NULL;
+		_content_query_builder_appendf(query, " LIMIT %d, %d", _filter->offset, _filter->count);
 	}
 
-	return ret;
+	return query->error;
 }
 
 int media_filter_create(filter_h *filter)
@@ -916,6 +965,7 @@ int media_filter_create(filter_h *filter)
 		_filter->order_collate_type = MEDIA_CONTENT_COLLATE_DEFAULT;
 		_filter->offset = -1;
 		_filter->count = -1;
+		_filter->field_groups = MEDIA_CONTENT_FIELD_ALL;
 
 		*filter = (filter_h)_filter;
 	}
@@ -930,6 +980,11 @@ int media_filter_destroy(filter_h filter)
 
 	if(_filter)
 	{
+		pthread_mutex_lock(&g_filter_mutex);
+		__media_filter_compiled_clear(_filter);
+		pthread_mutex_unlock(&g_filter_mutex);
+
+		__media_filter_seek_clear(_filter);
 		SAFE_FREE(_filter->condition);
 		SAFE_FREE(_filter->order_keyword);
 		SAFE_FREE(_filter);
@@ -972,6 +1027,10 @@ int media_filter_set_condition(filter_h filter, const char *condition, media_con
 	if((_filter != NULL) && STRING_VALID(condition)
 		&& ((collate_type >= MEDIA_CONTENT_COLLATE_DEFAULT) && (collate_type <= MEDIA_CONTENT_COLLATE_RTRIM)))
 	{
+		pthread_mutex_lock(&g_filter_mutex);
+		__media_filter_compiled_clear(_filter);
+		pthread_mutex_unlock(&g_filter_mutex);
+
 		if(STRING_VALID(_filter->condition))
 		{
 			SAFE_FREE(_filter->condition);
@@ -984,7 +1043,7 @@ int media_filter_set_condition(filter_h filter, const char *condition, media_con
 			return MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
 		}
 
-		media_content_debug("Condition string : %s", _filter->condition);
+		media_content_verbose("Condition string : %s", _filter->condition);
 
 		_filter->condition_collate_type = collate_type;
 	}
@@ -1006,6 +1065,10 @@ int media_filter_set_order(filter_h filter, media_content_order_e order_type, co
 		&& ((order_type == MEDIA_CONTENT_ORDER_ASC) ||(order_type == MEDIA_CONTENT_ORDER_DESC))
 		&& ((collate_type >= MEDIA_CONTENT_COLLATE_DEFAULT) && (collate_type <= MEDIA_CONTENT_COLLATE_RTRIM)))
 	{
+		pthread_mutex_lock(&g_filter_mutex);
+		__media_filter_compiled_clear(_filter);
+		pthread_mutex_unlock(&g_filter_mutex);
+
 		SAFE_FREE(_filter->order_keyword);
 
 		if(STRING_VALID(order_keyword))
@@ -1035,6 +1098,162 @@ int media_filter_set_order(filter_h filter, media_content_order_e order_type, co
 	return ret;
 }
 
+int media_filter_set_projection(filter_h filter, int field_groups)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	filter_s *_filter = (filter_s*)filter;
+
+	if((_filter != NULL) && ((field_groups & ~MEDIA_CONTENT_FIELD_ALL) == 0))
+	{
+		_filter->field_groups = field_groups | MEDIA_CONTENT_FIELD_CORE;
+	}
+	else
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		ret = MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+
+	return ret;
+}
+
+int media_filter_set_continuation_token(filter_h filter, const char *token)
+{
+	filter_s *_filter = (filter_s*)filter;
+	const char *media_id = NULL;
+	const char *sep = NULL;
+	char *seek_media_id = NULL;
+	char *seek_key = NULL;
+
+	if(_filter == NULL)
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+
+	if(token == NULL)
+	{
+		__media_filter_seek_clear(_filter);
+		return MEDIA_CONTENT_ERROR_NONE;
+	}
+
+	if(STRING_VALID(token))
+	{
+		if(strncmp(token, SEEK_TOKEN_PREFIX, strlen(SEEK_TOKEN_PREFIX)) != 0)
+		{
+			media_content_error("INVALID_PARAMETER(0x%08x):Invalid token [%s]", MEDIA_CONTENT_ERROR_INVALID_PARAMETER, token);
+			return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+		}
+
+		media_id = token + strlen(SEEK_TOKEN_PREFIX);
+		sep = strchr(media_id, ':');
+		if(sep == NULL || sep == media_id || (sep[1] != SEEK_TOKEN_VALUE && sep[1] != SEEK_TOKEN_NULL) || sep[2] != ':')
+		{
+			media_content_error("INVALID_PARAMETER(0x%08x):Invalid token [%s]", MEDIA_CONTENT_ERROR_INVALID_PARAMETER, token);
+			return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+		}
+
+		seek_media_id = (char*)calloc(sep - media_id + 1, sizeof(char));
+		if(seek_media_id == NULL)
+		{
+			media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
+			return MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
+		}
+		memcpy(seek_media_id, media_id, sep - media_id);
+
+		if(sep[1] == SEEK_TOKEN_VALUE)
+		{
+			seek_key = strdup(sep + 3);
+			if(seek_key == NULL)
+			{
+				SAFE_FREE(seek_media_id);
+				media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
+				return MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
+			}
+		}
+	}
+
+	__media_filter_seek_clear(_filter);
+
+	_filter->seek = TRUE;
+	_filter->seek_media_id = seek_media_id;
+	_filter->seek_key = seek_key;
+
+	return MEDIA_CONTENT_ERROR_NONE;
+}
+
+int media_filter_get_continuation_token(filter_h filter, media_info_h media, char **token)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	filter_s *_filter = (filter_s*)filter;
+	media_info_s *_media = (media_info_s*)media;
+	attribute_s *_attr = (attribute_s*)_content_get_attirbute_handle();
+	filter_compiled_s *compiled = NULL;
+	query_builder_s query;
+	sqlite3_stmt *stmt = NULL;
+	const char *last = NULL;
+	int len = 0;
+	int size = 0;
+
+	if(_filter == NULL || _media == NULL || !STRING_VALID(_media->media_id) || token == NULL)
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+
+	*token = NULL;
+
+	pthread_mutex_lock(&g_filter_mutex);
+
+	compiled = __media_filter_get_compiled(_attr, _filter);
+	if(compiled == NULL || compiled->seek_column == NULL)
+	{
+		pthread_mutex_unlock(&g_filter_mutex);
+		media_content_error("INVALID_OPERATION(0x%08x):Continuation token needs an order on one field", MEDIA_CONTENT_ERROR_INVALID_OPERATION);
+		return MEDIA_CONTENT_ERROR_INVALID_OPERATION;
+	}
+
+	/* The usual case, the media is the last row the foreach of the previous page listed */
+	last = _filter->seek_last_token;
+	len = strlen(_media->media_id);
+	if(last != NULL && strncmp(last + strlen(SEEK_TOKEN_PREFIX), _media->media_id, len) == 0 && last[strlen(SEEK_TOKEN_PREFIX) + len] == ':')
+	{
+		*token = strdup(last);
+		pthread_mutex_unlock(&g_filter_mutex);
+
+		if(*token == NULL)
+		{
+			media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
+			return MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
+		}
+
+		return MEDIA_CONTENT_ERROR_NONE;
+	}
+
+	_content_query_builder_init(&query);
+	_content_query_builder_appendf(&query, SELECT_MEDIA_SEEK_KEY, compiled->seek_column);
+
+	pthread_mutex_unlock(&g_filter_mutex);
+
+	_content_query_builder_bind_text(&query, _media->media_id);
+
+	ret = _content_query_builder_prepare(&query, &stmt);
+	_content_query_builder_release(&query);
+	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
+
+	if(_content_query_step(stmt) != SQLITE_ROW)
+	{
+		SQLITE3_FINALIZE(stmt);
+		media_content_error("INVALID_PARAMETER(0x%08x):No media [%s]", MEDIA_CONTENT_ERROR_INVALID_PARAMETER, _media->media_id);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+
+	ret = _media_filter_make_seek_token(stmt, 0, _media->media_id, token, &size);
+
+	SQLITE3_FINALIZE(stmt);
+
+	return ret;
+}
+
 int media_filter_get_offset(filter_h filter, int *offset, int *count)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
@@ -1118,3 +1337,34 @@ int media_filter_get_order(filter_h filter, media_content_order_e* order_type, c
 
 	return ret;
 }
+
+int media_filter_get_projection(filter_h filter, int *field_groups)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	filter_s *_filter = (filter_s*)filter;
+
+	if((_filter != NULL) && (field_groups != NULL))
+	{
+		*field_groups = _filter->field_groups;
+	}
+	else
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		ret = MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+
+	return ret;
+}
+
+int media_filter_get_query_plan(filter_h filter, int *plan, char **detail)
+{
+	media_content_debug_func();
+
+	if(filter == NULL || plan == NULL)
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+
+	return _media_db_get_group_item_plan(NULL, filter, MEDIA_GROUP_NONE, plan, detail);
+}
@@ -91,6 +91,23 @@ int media_folder_foreach_folder_from_db(filter_h filter, media_folder_cb callbac
 	return ret;
 }
 
+int media_folder_foreach_folder_with_count_from_db(filter_h filter, media_folder_count_cb callback, void *user_data)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+
+	media_content_debug_func();
+
+	if(callback == NULL)
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+
+	ret = _media_db_get_folder_with_count(filter, callback, user_data);
+
+	return ret;
+}
+
 int media_folder_get_media_count_from_db(const char *folder_id, filter_h filter, int *media_count)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
@@ -359,7 +376,7 @@ int media_folder_get_folder_from_db(const char *folder_id, media_folder_h *folde
 	ret = _content_query_prepare(&stmt, select_query, NULL, NULL);
 	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
 
-	while(sqlite3_step(stmt) == SQLITE_ROW)
+	while(_content_query_step(stmt) == SQLITE_ROW)
 	{
 		media_folder_s *_folder = (media_folder_s*)calloc(1, sizeof(media_folder_s));
 
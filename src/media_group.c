@@ -56,6 +56,23 @@ int media_album_foreach_album_from_db(filter_h filter, media_album_cb callback,
 	return ret;
 }
 
+int media_album_foreach_album_with_count_from_db(filter_h filter, media_album_count_cb callback, void *user_data)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+
+	media_content_debug_func();
+
+	if(callback == NULL)
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+
+	ret = _media_db_get_album_with_count(filter, callback, user_data);
+
+	return ret;
+}
+
 int media_album_get_media_count_from_db(int album_id, filter_h filter, int *media_count)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
@@ -115,7 +132,7 @@ int media_album_get_album_from_db(int album_id, media_album_h *album)
 	ret = _content_query_prepare(&stmt, select_query, NULL, NULL);
 	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
 
-	while(sqlite3_step(stmt) == SQLITE_ROW)
+	while(_content_query_step(stmt) == SQLITE_ROW)
 	{
 		media_album_s *_album = (media_album_s*)calloc(1, sizeof(media_album_s));
 
@@ -130,10 +147,7 @@ int media_album_get_album_from_db(int album_id, media_album_h *album)
 		*album = (media_album_h)_album;
 	}
 
-	if(stmt != NULL)
-	{
-		sqlite3_finalize(stmt);
-	}
+	SQLITE3_FINALIZE(stmt);
 
 	return ret;
 }
@@ -143,7 +157,7 @@ int media_album_destroy(media_album_h album)
 	int ret = MEDIA_CONTENT_ERROR_NONE;
 	media_album_s *_album = (media_album_s*)album;
 
-	media_content_debug_func();
+	media_content_verbose_func();
 
 	if(_album)
 	{
@@ -379,6 +393,25 @@ int media_group_foreach_group_from_db(filter_h filter, media_group_e group, medi
 	return ret;
 }
 
+int media_group_foreach_group_with_count_from_db(filter_h filter, media_group_e group, media_group_count_cb callback, void *user_data)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+
+	media_content_debug_func();
+
+	if((callback == NULL) || (group < MEDIA_CONTENT_GROUP_DISPLAY_NAME) || (group > MEDIA_CONTENT_GROUP_KEYWORD))
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		ret = MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+	else
+	{
+		ret = _media_db_get_media_group_with_count(group, filter, callback, user_data);
+	}
+
+	return ret;
+}
+
 int media_group_get_media_count_from_db(const char *group_name, media_group_e group, filter_h filter, int *media_count)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
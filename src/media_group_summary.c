@@ -0,0 +1,294 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include <media_content.h>
+#include <media_info_private.h>
+
+
+typedef struct
+{
+	int group_type;			// media_content_group_e, or GROUP_SUMMARY_ALBUM
+	const char *column;		// field of the media table the group is made of
+}group_summary_column_s;
+
+/* Groups of the overview screens. Other groups are always counted from the media table. */
+static const group_summary_column_s g_summary_columns[] =
+{
+	{MEDIA_CONTENT_GROUP_ARTIST, DB_FIELD_MEDIA_ARTIST},
+	{MEDIA_CONTENT_GROUP_GENRE, DB_FIELD_MEDIA_GENRE},
+	{MEDIA_CONTENT_GROUP_COMPOSER, DB_FIELD_MEDIA_COMPOSER},
+	{MEDIA_CONTENT_GROUP_YEAR, DB_FIELD_MEDIA_YEAR},
+	{GROUP_SUMMARY_ALBUM, DB_FIELD_ALBUM_ID},
+};
+
+#define GROUP_SUMMARY_COLUMN_COUNT (sizeof(g_summary_columns) / sizeof(g_summary_columns[0]))
+
+/* Set on connect and by enable/disable. Another process may drop the summary meanwhile,
+ * so a failed summary query falls back to the media table and clears it.
+ * Read by every query from any thread, so it is only accessed atomically. */
+static gint g_summary_enabled = 0;
+
+static void __media_group_summary_append_add(query_builder_s *query);
+static void __media_group_summary_append_remove(query_builder_s *query);
+static int __media_group_summary_create(void);
+static int __media_group_summary_get_int(query_builder_s *query, int *value);
+
+/* NEW is counted in its groups if it is valid. Rows are created on the first media of a group.
+ * A duration of -1 means unknown and does not count. */
+static void __media_group_summary_append_add(query_builder_s *query)
+{
+	unsigned int idx = 0;
+	const group_summary_column_s *col = NULL;
+
+	for(idx = 0; idx < GROUP_SUMMARY_COLUMN_COUNT; idx++)
+	{
+		col = &g_summary_columns[idx];
+
+		_content_query_builder_appendf(query, "INSERT INTO "DB_TABLE_GROUP_SUMMARY" (group_type, value) SELECT %d, NEW.%s WHERE NEW.validity=1 AND NOT EXISTS \
+			(SELECT 1 FROM "DB_TABLE_GROUP_SUMMARY" WHERE group_type=%d AND value IS NEW.%s); ", col->group_type, col->column, col->group_type, col->column);
+		_content_query_builder_appendf(query, "UPDATE "DB_TABLE_GROUP_SUMMARY" SET media_count=media_count+1, total_size=total_size+IFNULL(NEW.size, 0), \
+			total_duration=total_duration+MAX(IFNULL(NEW.duration, 0), 0) WHERE NEW.validity=1 AND group_type=%d AND value IS NEW.%s; ", col->group_type, col->column);
+	}
+}
+
+/* OLD is taken out of its groups if it was valid. Rows of groups left empty are removed. */
+static void __media_group_summary_append_remove(query_builder_s *query)
+{
+	unsigned int idx = 0;
+	const group_summary_column_s *col = NULL;
+
+	for(idx = 0; idx < GROUP_SUMMARY_COLUMN_COUNT; idx++)
+	{
+		col = &g_summary_columns[idx];
+
+		_content_query_builder_appendf(query, "UPDATE "DB_TABLE_GROUP_SUMMARY" SET media_count=media_count-1, total_size=total_size-IFNULL(OLD.size, 0), \
+			total_duration=total_duration-MAX(IFNULL(OLD.duration, 0), 0) WHERE OLD.validity=1 AND group_type=%d AND value IS OLD.%s; ", col->group_type, col->column);
+		_content_query_builder_appendf(query, "DELETE FROM "DB_TABLE_GROUP_SUMMARY" WHERE group_type=%d AND value IS OLD.%s AND media_count<=0; ",
+			col->group_type, col->column);
+	}
+}
+
+/* Called in a transaction. Triggers are recreated so that a summary made by an older version is brought up to date. */
+static int __media_group_summary_create(void)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	unsigned int idx = 0;
+	query_builder_s query;
+
+	_content_query_builder_init(&query);
+
+	_content_query_builder_append(&query, DROP_GROUP_SUMMARY);
+	_content_query_builder_append(&query, CREATE_GROUP_SUMMARY_TABLE);
+
+	_content_query_builder_append(&query, " CREATE TRIGGER "GROUP_SUMMARY_INSERT_TRIGGER" AFTER INSERT ON "DB_TABLE_MEDIA" BEGIN ");
+	__media_group_summary_append_add(&query);
+	_content_query_builder_append(&query, "END;");
+
+	/* New groups are counted before old ones are emptied, so a group the media stays in is not removed and created again */
+	_content_query_builder_append(&query, " CREATE TRIGGER "GROUP_SUMMARY_UPDATE_TRIGGER" AFTER UPDATE OF validity, size, duration");
+	for(idx = 0; idx < GROUP_SUMMARY_COLUMN_COUNT; idx++)
+		_content_query_builder_appendf(&query, ", %s", g_summary_columns[idx].column);
+	_content_query_builder_append(&query, " ON "DB_TABLE_MEDIA" BEGIN ");
+	__media_group_summary_append_add(&query);
+	__media_group_summary_append_remove(&query);
+	_content_query_builder_append(&query, "END;");
+
+	_content_query_builder_append(&query, " CREATE TRIGGER "GROUP_SUMMARY_DELETE_TRIGGER" AFTER DELETE ON "DB_TABLE_MEDIA" BEGIN ");
+	__media_group_summary_append_remove(&query);
+	_content_query_builder_append(&query, "END;");
+
+	/* Fill the summary from the media which are already in the library */
+	for(idx = 0; idx < GROUP_SUMMARY_COLUMN_COUNT; idx++)
+	{
+		_content_query_builder_appendf(&query, " INSERT INTO "DB_TABLE_GROUP_SUMMARY" (group_type, value, media_count, total_size, total_duration) \
+			SELECT %d, %s, COUNT(*), IFNULL(SUM(size), 0), IFNULL(SUM(MAX(IFNULL(duration, 0), 0)), 0) FROM "DB_TABLE_MEDIA" WHERE validity=1 GROUP BY %s;",
+			g_summary_columns[idx].group_type, g_summary_columns[idx].column, g_summary_columns[idx].column);
+	}
+
+	ret = query.error;
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = _content_query_sql(query.str);
+
+	_content_query_builder_release(&query);
+
+	return ret;
+}
+
+static int __media_group_summary_get_int(query_builder_s *query, int *value)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	sqlite3_stmt *stmt = NULL;
+
+	ret = _content_query_builder_prepare(query, &stmt);
+	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
+
+	*value = 0;
+
+	if(_content_query_step(stmt) == SQLITE_ROW)
+		*value = (int)sqlite3_column_int(stmt, 0);
+
+	SQLITE3_FINALIZE(stmt);
+
+	return MEDIA_CONTENT_ERROR_NONE;
+}
+
+void _media_group_summary_load(void)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	int count = 0;
+	query_builder_s query;
+
+	_content_query_builder_init(&query);
+	_content_query_builder_append(&query, SELECT_GROUP_SUMMARY_OBJECT_COUNT);
+
+	ret = __media_group_summary_get_int(&query, &count);
+	g_atomic_int_set(&g_summary_enabled, (ret == MEDIA_CONTENT_ERROR_NONE && count == GROUP_SUMMARY_OBJECT_COUNT) ? 1 : 0);
+
+	_content_query_builder_release(&query);
+
+	media_content_debug("group summary : %s", g_atomic_int_get(&g_summary_enabled) ? "enabled" : "disabled");
+}
+
+/* The summary holds whole groups, so it only answers when nothing narrows or pages the media */
+bool _media_group_summary_is_usable(int group_type, filter_h filter)
+{
+	unsigned int idx = 0;
+	filter_s *_filter = (filter_s*)filter;
+
+	if(!g_atomic_int_get(&g_summary_enabled))
+		return FALSE;
+
+	if(_filter != NULL && (STRING_VALID(_filter->condition) || STRING_VALID(_filter->order_keyword) || _filter->count >= 0))
+		return FALSE;
+
+	for(idx = 0; idx < GROUP_SUMMARY_COLUMN_COUNT; idx++)
+	{
+		if(g_summary_columns[idx].group_type == group_type)
+			return TRUE;
+	}
+
+	return FALSE;
+}
+
+int _media_group_summary_get_group_count(int group_type, int *group_count)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	query_builder_s query;
+
+	_content_query_builder_init(&query);
+
+	/* Albums are only listed if they are in the album table */
+	if(group_type == GROUP_SUMMARY_ALBUM)
+		_content_query_builder_append(&query, SELECT_GROUP_SUMMARY_ALBUM_COUNT);
+	else
+		_content_query_builder_append(&query, SELECT_GROUP_SUMMARY_COUNT);
+	_content_query_builder_bind_int(&query, group_type);
+
+	ret = __media_group_summary_get_int(&query, group_count);
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+		g_atomic_int_set(&g_summary_enabled, 0);
+
+	_content_query_builder_release(&query);
+
+	return ret;
+}
+
+int _media_group_summary_get_media_count(int group_type, const char *value, int *media_count)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	query_builder_s query;
+
+	_content_query_builder_init(&query);
+	_content_query_builder_append(&query, SELECT_GROUP_SUMMARY_MEDIA_COUNT);
+	_content_query_builder_bind_int(&query, group_type);
+	_content_query_builder_bind_text(&query, value);
+
+	ret = __media_group_summary_get_int(&query, media_count);
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+		g_atomic_int_set(&g_summary_enabled, 0);
+
+	_content_query_builder_release(&query);
+
+	return ret;
+}
+
+int _media_group_summary_foreach(int group_type, media_group_count_cb callback, void *user_data)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	query_builder_s query;
+	sqlite3_stmt *stmt = NULL;
+
+	_content_query_builder_init(&query);
+	_content_query_builder_append(&query, SELECT_GROUP_SUMMARY_LIST);
+	_content_query_builder_bind_int(&query, group_type);
+
+	ret = _content_query_builder_prepare(&query, &stmt);
+	_content_query_builder_release(&query);
+
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+	{
+		/* The summary was dropped by another process */
+		g_atomic_int_set(&g_summary_enabled, 0);
+		return ret;
+	}
+
+	while(_content_query_step(stmt) == SQLITE_ROW)
+	{
+		if(callback((const char *)sqlite3_column_text(stmt, 0), (int)sqlite3_column_int(stmt, 1), user_data) == false)
+			break;
+	}
+
+	SQLITE3_FINALIZE(stmt);
+
+	return ret;
+}
+
+int media_content_enable_group_summary(void)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+
+	media_content_debug_func();
+
+	ret = _content_transaction_begin();
+	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
+
+	ret = __media_group_summary_create();
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+	{
+		_content_transaction_rollback();
+		return ret;
+	}
+
+	ret = _content_transaction_commit();
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		g_atomic_int_set(&g_summary_enabled, 1);
+
+	return ret;
+}
+
+int media_content_disable_group_summary(void)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+
+	media_content_debug_func();
+
+	g_atomic_int_set(&g_summary_enabled, 0);
+
+	ret = _content_query_sql(DROP_GROUP_SUMMARY);
+
+	return ret;
+}
@@ -26,6 +26,11 @@
 
 static int __media_info_get_media_info_from_db(char *path, media_info_h media);
 static void __media_info_thumbnail_completed_cb(int error, const char *path, void *user_data);
+static void *__media_info_alloc(content_arena_s *arena, size_t size);
+static char *__media_info_column_dup(content_arena_s *arena, sqlite3_stmt *stmt, int idx);
+static char *__media_info_strdup(media_info_s *media, const char *str);
+static void __media_info_free_str(media_info_s *media, char **str);
+static int __media_info_insert_batch_chunk(const char **path_array, int count, content_arena_s *arena, media_insert_batch_cb callback, void *user_data, bool *cont);
 
 static int __media_info_get_media_info_from_db(char *path, media_info_h media)
 {
@@ -46,17 +51,17 @@ static int __media_info_get_media_info_from_db(char *path, media_info_h media)
 	sqlite3_free(select_query);
 	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
 
-	if(sqlite3_step(stmt) == SQLITE_ROW)
+	if(_content_query_step(stmt) == SQLITE_ROW)
 	{
-		_media_info_item_get_detail(stmt, (media_info_h)_media);
+		_media_info_item_get_detail(stmt, (media_info_h)_media, MEDIA_CONTENT_FIELD_ALL, NULL);
 		media_content_debug("New Media ID: %s", _media->media_id);
 	} else {
 		media_content_debug("There's no media!!");
 	}
 /*
-	while(sqlite3_step(stmt) == SQLITE_ROW)
+	while(_content_query_step(stmt) == SQLITE_ROW)
 	{
-		_media_info_item_get_detail(stmt, (media_info_h)_media);
+		_media_info_item_get_detail(stmt, (media_info_h)_media, MEDIA_CONTENT_FIELD_ALL, NULL);
 		media_content_debug("New Media ID: %s", _media->media_id);
 	}
 */
@@ -65,6 +70,51 @@ static int __media_info_get_media_info_from_db(char *path, media_info_h media)
 	return ret;
 }
 
+static void *__media_info_alloc(content_arena_s *arena, size_t size)
+{
+	if(arena != NULL)
+		return _content_arena_alloc(arena, size);
+
+	return calloc(1, size);
+}
+
+static char *__media_info_column_dup(content_arena_s *arena, sqlite3_stmt *stmt, int idx)
+{
+	const char *value = (const char *)sqlite3_column_text(stmt, idx);
+
+	if(!STRING_VALID(value))
+		return NULL;
+
+	if(arena != NULL)
+		return _content_arena_strdup(arena, value);
+
+	return strdup(value);
+}
+
+/* Strings of a borrowed handle live in the arena of the foreach, so setters carve from it too */
+static char *__media_info_strdup(media_info_s *media, const char *str)
+{
+	if(str == NULL)
+		return NULL;
+
+	if(media->arena != NULL)
+		return _content_arena_strdup(media->arena, str);
+
+	return strdup(str);
+}
+
+static void __media_info_free_str(media_info_s *media, char **str)
+{
+	if(media->arena == NULL)
+	{
+		SAFE_FREE(*str);
+	}
+	else
+	{
+		*str = NULL;
+	}
+}
+
 static void __media_info_thumbnail_completed_cb(int error, const char *path, void *user_data)
 {
 	int error_value = MEDIA_CONTENT_ERROR_NONE;
@@ -77,8 +127,8 @@ static void __media_info_thumbnail_completed_cb(int error, const char *path, voi
 		media = _thumb_cb->handle;
 		if((media != NULL) && STRING_VALID(path))
 		{
-			SAFE_FREE(media->thumbnail_path);
-			media->thumbnail_path = strdup(path);
+			__media_info_free_str(media, &media->thumbnail_path);
+			media->thumbnail_path = __media_info_strdup(media, path);
 		}
 
 		media_content_debug("error [%d], thumbnail_path [%s]", error, path);
@@ -91,26 +141,136 @@ static void __media_info_thumbnail_completed_cb(int error, const char *path, voi
 	return;
 }
 
-void _media_info_item_get_detail(sqlite3_stmt* stmt, media_info_h media)
+/* Registers one chunk of files, reads all of them back with a single "path IN (...)" query
+ * and reports every path in the order of path_array. */
+static int __media_info_insert_batch_chunk(const char **path_array, int count, content_arena_s *arena, media_insert_batch_cb callback, void *user_data, bool *cont)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	int result[MEDIA_INFO_INSERT_BATCH_SIZE];
+	int registered = 0;
+	int idx = 0;
+	query_builder_s query;
+	sqlite3_stmt *stmt = NULL;
+	GHashTable *item_map = NULL;
+	media_info_s *item = NULL;
+
+	for(idx = 0; idx < count; idx++)
+	{
+		if(!STRING_VALID(path_array[idx]))
+		{
+			result[idx] = MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+			continue;
+		}
+
+		ret = media_file_register(path_array[idx]);
+		if(ret != MS_MEDIA_ERR_NONE)
+		{
+			media_content_error("media_file_register failed [%s]", path_array[idx]);
+			result[idx] = _content_error_capi(MEDIA_REGISTER_TYPE, ret);
+			continue;
+		}
+
+		result[idx] = MEDIA_CONTENT_ERROR_NONE;
+		registered++;
+	}
+
+	ret = MEDIA_CONTENT_ERROR_NONE;
+	item_map = g_hash_table_new(g_str_hash, g_str_equal);
+
+	if(registered > 0)
+	{
+		_content_query_builder_init(&query);
+		_content_query_builder_append(&query, SELECT_MEDIA_BY_PATH_LIST);
+
+		for(idx = 0; idx < count; idx++)
+		{
+			if(result[idx] != MEDIA_CONTENT_ERROR_NONE)
+				continue;
+
+			_content_query_builder_append(&query, (--registered > 0) ? "?, " : "?)");
+			_content_query_builder_bind_text(&query, path_array[idx]);
+		}
+
+		ret = _content_query_builder_prepare(&query, &stmt);
+		_content_query_builder_release(&query);
+
+		while(ret == MEDIA_CONTENT_ERROR_NONE && _content_query_step(stmt) == SQLITE_ROW)
+		{
+			item = (media_info_s*)_content_arena_alloc(arena, sizeof(media_info_s));
+			if(item == NULL)
+			{
+				ret = MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
+				break;
+			}
+
+			_media_info_item_get_detail(stmt, (media_info_h)item, MEDIA_CONTENT_FIELD_ALL, arena);
+			if(item->file_path != NULL)
+				g_hash_table_insert(item_map, item->file_path, item);
+		}
+
+		SQLITE3_FINALIZE(stmt);
+	}
+
+	for(idx = 0; ret == MEDIA_CONTENT_ERROR_NONE && *cont && idx < count; idx++)
+	{
+		item = NULL;
+
+		if(result[idx] == MEDIA_CONTENT_ERROR_NONE)
+		{
+			item = (media_info_s*)g_hash_table_lookup(item_map, path_array[idx]);
+			if(item == NULL)
+			{
+				media_content_error("registered, but not found in DB [%s]", path_array[idx]);
+				result[idx] = MEDIA_CONTENT_ERROR_DB_FAILED;
+			}
+		}
+
+		*cont = callback(path_array[idx], result[idx], (media_info_h)item, user_data);
+	}
+
+	g_hash_table_destroy(item_map);
+	_content_arena_reset(arena);
+
+	return ret;
+}
+
+void _media_info_append_columns(query_builder_s *query, filter_h filter)
+{
+	int field_groups = (filter != NULL) ? ((filter_s*)filter)->field_groups : MEDIA_CONTENT_FIELD_ALL;
+
+	if((field_groups & MEDIA_CONTENT_FIELD_ALL) == MEDIA_CONTENT_FIELD_ALL)
+	{
+		_content_query_builder_append(query, "SELECT "MEDIA_INFO_ITEM);
+		return;
+	}
+
+	_content_query_builder_append(query, "SELECT "MEDIA_INFO_ITEM_CORE", ");
+	_content_query_builder_append(query, (field_groups & MEDIA_CONTENT_FIELD_LOCATION) ? MEDIA_INFO_ITEM_LOCATION", " : MEDIA_INFO_ITEM_LOCATION_NONE", ");
+	_content_query_builder_append(query, (field_groups & (MEDIA_CONTENT_FIELD_IMAGE_META | MEDIA_CONTENT_FIELD_AV_META)) ? MEDIA_INFO_ITEM_DIMENSION", " : MEDIA_INFO_ITEM_DIMENSION_NONE", ");
+	_content_query_builder_append(query, (field_groups & MEDIA_CONTENT_FIELD_IMAGE_META) ? MEDIA_INFO_ITEM_IMAGE", " : MEDIA_INFO_ITEM_IMAGE_NONE", ");
+	_content_query_builder_append(query, (field_groups & MEDIA_CONTENT_FIELD_AV_META) ? MEDIA_INFO_ITEM_AV : MEDIA_INFO_ITEM_AV_NONE);
+}
+
+void _media_info_item_get_detail(sqlite3_stmt* stmt, media_info_h media, int field_groups, content_arena_s *arena)
 {
 //#define MEDIA_INFO_ITEM "media_uuid, path, file_name, media_type, mime_type, size, added_time, modified_time, thumbnail_path, description,
 //							rating, favourite, author, provider, content_name, category, location_tag, age_rating, keyword, is_drm, storage_type, longitude, latitude, altitude, width, height, datetaken, orientation, title, album, artist, genre, composer, year, recorded_date, copyright, track_num, bitrate, duration, played_count, last_played_time, last_played_position, samplerate, channel"
 
 	media_info_s *_media = (media_info_s*)media;
 
-	if(STRING_VALID((const char *)sqlite3_column_text(stmt, 0)))
-		_media->media_id = strdup((const char *)sqlite3_column_text(stmt, 0));
+	_media_query_stats_materialized(stmt);
 
-	if(STRING_VALID((const char *)sqlite3_column_text(stmt, 1)))
-		_media->file_path = strdup((const char *)sqlite3_column_text(stmt, 1));
+	_media->arena = arena;
 
-	if(STRING_VALID((const char *)sqlite3_column_text(stmt, 2)))
-		_media->display_name = strdup((const char *)sqlite3_column_text(stmt, 2));
+	_media->media_id = __media_info_column_dup(arena, stmt, 0);
+
+	_media->file_path = __media_info_column_dup(arena, stmt, 1);
+
+	_media->display_name = __media_info_column_dup(arena, stmt, 2);
 
 	_media->media_type = (int)sqlite3_column_int(stmt, 3);
 
-	if(STRING_VALID((const char *)sqlite3_column_text(stmt, 4)))
-		_media->mime_type = strdup((const char *)sqlite3_column_text(stmt, 4));
+	_media->mime_type = __media_info_column_dup(arena, stmt, 4);
 
 	_media->size = (unsigned long long)sqlite3_column_int64(stmt, 5);
 
@@ -118,92 +278,75 @@ void _media_info_item_get_detail(sqlite3_stmt* stmt, media_info_h media)
 
 	_media->modified_time = (int)sqlite3_column_int(stmt, 7);
 
-	if(STRING_VALID((const char *)sqlite3_column_text(stmt, 8)))
-		_media->thumbnail_path= strdup((const char *)sqlite3_column_text(stmt, 8));
+	_media->thumbnail_path = __media_info_column_dup(arena, stmt, 8);
 
-	if(STRING_VALID((const char *)sqlite3_column_text(stmt, 9)))
-		_media->description = strdup((const char *)sqlite3_column_text(stmt, 9));
+	_media->description = __media_info_column_dup(arena, stmt, 9);
 
 	_media->rating = (int)sqlite3_column_int(stmt,10);
 
 	_media->favourite = (int)sqlite3_column_int(stmt, 11);
 
-	if(STRING_VALID((const char *)sqlite3_column_text(stmt, 12)))
-		_media->author = strdup((const char *)sqlite3_column_text(stmt, 12));
+	_media->author = __media_info_column_dup(arena, stmt, 12);
 
-	if(STRING_VALID((const char *)sqlite3_column_text(stmt, 13)))
-		_media->provider = strdup((const char *)sqlite3_column_text(stmt, 13));
+	_media->provider = __media_info_column_dup(arena, stmt, 13);
 
-	if(STRING_VALID((const char *)sqlite3_column_text(stmt, 14)))
-		_media->content_name = strdup((const char *)sqlite3_column_text(stmt, 14));
+	_media->content_name = __media_info_column_dup(arena, stmt, 14);
 
-	if(STRING_VALID((const char *)sqlite3_column_text(stmt, 15)))
-		_media->category = strdup((const char *)sqlite3_column_text(stmt, 15));
+	_media->category = __media_info_column_dup(arena, stmt, 15);
 
-	if(STRING_VALID((const char *)sqlite3_column_text(stmt, 16)))
-		_media->location_tag = strdup((const char *)sqlite3_column_text(stmt, 16));
+	_media->location_tag = __media_info_column_dup(arena, stmt, 16);
 
-	if(STRING_VALID((const char *)sqlite3_column_text(stmt, 17)))
-		_media->age_rating = strdup((const char *)sqlite3_column_text(stmt, 17));
+	_media->age_rating = __media_info_column_dup(arena, stmt, 17);
 
-	if(STRING_VALID((const char *)sqlite3_column_text(stmt, 18)))
-		_media->keyword = strdup((const char *)sqlite3_column_text(stmt, 18));
+	_media->keyword = __media_info_column_dup(arena, stmt, 18);
 
 	_media->is_drm = (int)sqlite3_column_int(stmt, 19);
 
 	_media->storage_type = (int)sqlite3_column_int(stmt, 20);
 
-	_media->longitude = (double)sqlite3_column_double(stmt, 21);
-	_media->latitude = (double)sqlite3_column_double(stmt, 22);
-	_media->altitude = (double)sqlite3_column_double(stmt, 23);
+	_media->loaded_fields = field_groups | MEDIA_CONTENT_FIELD_CORE;
+
+	if(field_groups & MEDIA_CONTENT_FIELD_LOCATION) {
+		_media->longitude = (double)sqlite3_column_double(stmt, 21);
+		_media->latitude = (double)sqlite3_column_double(stmt, 22);
+		_media->altitude = (double)sqlite3_column_double(stmt, 23);
+	}
 
-	if(_media->media_type == MEDIA_CONTENT_TYPE_IMAGE) {
-		_media->image_meta = (image_meta_s *)calloc(1, sizeof(image_meta_s));
+	if((_media->media_type == MEDIA_CONTENT_TYPE_IMAGE) && (field_groups & MEDIA_CONTENT_FIELD_IMAGE_META)) {
+		_media->image_meta = (image_meta_s *)__media_info_alloc(arena, sizeof(image_meta_s));
 		if(_media->image_meta) {
-			if(STRING_VALID(_media->media_id))
-				_media->image_meta->media_id = strdup(_media->media_id);
+			_media->image_meta->media_id = __media_info_strdup(_media, _media->media_id);
 
 			_media->image_meta->width = sqlite3_column_int(stmt, 24);
 			_media->image_meta->height = sqlite3_column_int(stmt, 25);
 
-			if(STRING_VALID((const char *)sqlite3_column_text(stmt, 26)))
-				_media->image_meta->date_taken = strdup((const char *)sqlite3_column_text(stmt, 26));
+			_media->image_meta->date_taken = __media_info_column_dup(arena, stmt, 26);
 		
 			_media->image_meta->orientation = sqlite3_column_int(stmt, 27);
 		}
 
-	} else if(_media->media_type == MEDIA_CONTENT_TYPE_VIDEO) {
-		_media->video_meta = (video_meta_s *)calloc(1, sizeof(video_meta_s));
+	} else if((_media->media_type == MEDIA_CONTENT_TYPE_VIDEO) && (field_groups & MEDIA_CONTENT_FIELD_AV_META)) {
+		_media->video_meta = (video_meta_s *)__media_info_alloc(arena, sizeof(video_meta_s));
 		if(_media->video_meta) {
-			if(STRING_VALID(_media->media_id))
-				_media->video_meta->media_id = strdup(_media->media_id);
+			_media->video_meta->media_id = __media_info_strdup(_media, _media->media_id);
 
-			if(STRING_VALID((const char *)sqlite3_column_text(stmt, 28)))
-				_media->video_meta->title = strdup((const char *)sqlite3_column_text(stmt, 28));
+			_media->video_meta->title = __media_info_column_dup(arena, stmt, 28);
 
-			if(STRING_VALID((const char *)sqlite3_column_text(stmt, 29)))
-				_media->video_meta->album = strdup((const char *)sqlite3_column_text(stmt, 29));
+			_media->video_meta->album = __media_info_column_dup(arena, stmt, 29);
 
-			if(STRING_VALID((const char *)sqlite3_column_text(stmt, 30)))
-				_media->video_meta->artist = strdup((const char *)sqlite3_column_text(stmt, 30));
+			_media->video_meta->artist = __media_info_column_dup(arena, stmt, 30);
 
-			if(STRING_VALID((const char *)sqlite3_column_text(stmt, 31)))
-				_media->video_meta->genre = strdup((const char *)sqlite3_column_text(stmt, 31));
+			_media->video_meta->genre = __media_info_column_dup(arena, stmt, 31);
 
-			if(STRING_VALID((const char *)sqlite3_column_text(stmt, 32)))
-				_media->video_meta->composer = strdup((const char *)sqlite3_column_text(stmt, 32));
+			_media->video_meta->composer = __media_info_column_dup(arena, stmt, 32);
 
-			if(STRING_VALID((const char *)sqlite3_column_text(stmt, 33)))
-				_media->video_meta->year = strdup((const char *)sqlite3_column_text(stmt, 33));
+			_media->video_meta->year = __media_info_column_dup(arena, stmt, 33);
 
-			if(STRING_VALID((const char *)sqlite3_column_text(stmt, 34)))
-				_media->video_meta->recorded_date = strdup((const char *)sqlite3_column_text(stmt, 34));
+			_media->video_meta->recorded_date = __media_info_column_dup(arena, stmt, 34);
 
-			if(STRING_VALID((const char *)sqlite3_column_text(stmt, 35)))
-				_media->video_meta->copyright = strdup((const char *)sqlite3_column_text(stmt, 35));
+			_media->video_meta->copyright = __media_info_column_dup(arena, stmt, 35);
 
-			if(STRING_VALID((const char *)sqlite3_column_text(stmt, 36)))
-				_media->video_meta->track_num = strdup((const char *)sqlite3_column_text(stmt, 36));
+			_media->video_meta->track_num = __media_info_column_dup(arena, stmt, 36);
 
 			_media->video_meta->bitrate = sqlite3_column_int(stmt, 37);
 			_media->video_meta->duration = sqlite3_column_int(stmt, 38);
@@ -215,38 +358,28 @@ void _media_info_item_get_detail(sqlite3_stmt* stmt, media_info_h media)
 		}
 
 	}
-	else if((_media->media_type == MEDIA_CONTENT_TYPE_MUSIC) || (_media->media_type == MEDIA_CONTENT_TYPE_SOUND)) {
-		_media->audio_meta = (audio_meta_s *)calloc(1, sizeof(audio_meta_s));
+	else if(((_media->media_type == MEDIA_CONTENT_TYPE_MUSIC) || (_media->media_type == MEDIA_CONTENT_TYPE_SOUND)) && (field_groups & MEDIA_CONTENT_FIELD_AV_META)) {
+		_media->audio_meta = (audio_meta_s *)__media_info_alloc(arena, sizeof(audio_meta_s));
 		if(_media->audio_meta) {
-			if(STRING_VALID(_media->media_id))
-				_media->audio_meta->media_id = strdup(_media->media_id);
+			_media->audio_meta->media_id = __media_info_strdup(_media, _media->media_id);
 
-			if(STRING_VALID((const char *)sqlite3_column_text(stmt, 28)))
-				_media->audio_meta->title = strdup((const char *)sqlite3_column_text(stmt, 28));
+			_media->audio_meta->title = __media_info_column_dup(arena, stmt, 28);
 
-			if(STRING_VALID((const char *)sqlite3_column_text(stmt, 29)))
-				_media->audio_meta->album = strdup((const char *)sqlite3_column_text(stmt, 29));
+			_media->audio_meta->album = __media_info_column_dup(arena, stmt, 29);
 
-			if(STRING_VALID((const char *)sqlite3_column_text(stmt, 30)))
-				_media->audio_meta->artist = strdup((const char *)sqlite3_column_text(stmt, 30));
+			_media->audio_meta->artist = __media_info_column_dup(arena, stmt, 30);
 
-			if(STRING_VALID((const char *)sqlite3_column_text(stmt, 31)))
-				_media->audio_meta->genre = strdup((const char *)sqlite3_column_text(stmt, 31));
+			_media->audio_meta->genre = __media_info_column_dup(arena, stmt, 31);
 
-			if(STRING_VALID((const char *)sqlite3_column_text(stmt, 32)))
-				_media->audio_meta->composer = strdup((const char *)sqlite3_column_text(stmt, 32));
+			_media->audio_meta->composer = __media_info_column_dup(arena, stmt, 32);
 
-			if(STRING_VALID((const char *)sqlite3_column_text(stmt, 33)))
-				_media->audio_meta->year = strdup((const char *)sqlite3_column_text(stmt, 33));
+			_media->audio_meta->year = __media_info_column_dup(arena, stmt, 33);
 
-			if(STRING_VALID((const char *)sqlite3_column_text(stmt, 34)))
-				_media->audio_meta->recorded_date = strdup((const char *)sqlite3_column_text(stmt, 34));
+			_media->audio_meta->recorded_date = __media_info_column_dup(arena, stmt, 34);
 
-			if(STRING_VALID((const char *)sqlite3_column_text(stmt, 35)))
-				_media->audio_meta->copyright = strdup((const char *)sqlite3_column_text(stmt, 35));
+			_media->audio_meta->copyright = __media_info_column_dup(arena, stmt, 35);
 
-			if(STRING_VALID((const char *)sqlite3_column_text(stmt, 36)))
-				_media->audio_meta->track_num = strdup((const char *)sqlite3_column_text(stmt, 36));
+			_media->audio_meta->track_num = __media_info_column_dup(arena, stmt, 36);
 
 			_media->audio_meta->bitrate = sqlite3_column_int(stmt, 37);
 			_media->audio_meta->duration = sqlite3_column_int(stmt, 38);
@@ -306,6 +439,36 @@ int media_info_insert_to_db (const char *path, media_info_h *info)
 	return ret;
 }
 
+int media_info_insert_batch_to_db(const char **path_array, unsigned int array_length, media_insert_batch_cb callback, void *user_data)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	unsigned int offset = 0;
+	int count = 0;
+	content_arena_s arena;
+	bool cont = TRUE;
+
+	if(path_array == NULL || array_length == 0 || callback == NULL)
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+
+	_content_arena_init(&arena);
+
+	for(offset = 0; cont && offset < array_length; offset += count)
+	{
+		count = ((array_length - offset) > MEDIA_INFO_INSERT_BATCH_SIZE) ? MEDIA_INFO_INSERT_BATCH_SIZE : (int)(array_length - offset);
+
+		ret = __media_info_insert_batch_chunk(path_array + offset, count, &arena, callback, user_data, &cont);
+		if(ret != MEDIA_CONTENT_ERROR_NONE)
+			break;
+	}
+
+	_content_arena_release(&arena);
+
+	return ret;
+}
+
 int media_info_delete_from_db(const char *media_id)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
@@ -332,6 +495,12 @@ int media_info_destroy(media_info_h media)
 	int ret = MEDIA_CONTENT_ERROR_NONE;
 	media_info_s *_media = (media_info_s*)media;
 
+	if(_media && _media->arena != NULL)
+	{
+		media_content_error("INVALID_OPERATION(0x%08x) handle is owned by the foreach, use media_info_clone()", MEDIA_CONTENT_ERROR_INVALID_OPERATION);
+		return MEDIA_CONTENT_ERROR_INVALID_OPERATION;
+	}
+
 	if(_media)
 	{
 		SAFE_FREE(_media->media_id);
@@ -548,6 +717,7 @@ int media_info_clone(media_info_h *dst, media_info_h src)
 		_dst->longitude = _src->longitude;
 		_dst->latitude = _src->latitude;
 		_dst->altitude = _src->altitude;
+		_dst->loaded_fields = _src->loaded_fields;
 		_dst->rating = _src->rating;
 		_dst->favourite = _src->favourite;
 		_dst->is_drm = _src->is_drm;
@@ -855,6 +1025,23 @@ int media_info_get_media_count_from_db(filter_h filter, int *media_count)
 	return ret;
 }
 
+int media_info_get_aggregate_from_db(filter_h filter, const char *field, media_content_aggregate_e op, double *result)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+
+	media_content_debug_func();
+
+	if(!STRING_VALID(field) || result == NULL)
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+
+	ret = _media_db_get_media_aggregate(filter, field, op, result);
+
+	return ret;
+}
+
 int media_info_foreach_media_from_db(filter_h filter, media_info_cb callback, void *user_data)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
@@ -872,6 +1059,41 @@ int media_info_foreach_media_from_db(filter_h filter, media_info_cb callback, vo
 	return ret;
 }
 
+int media_info_foreach_media_batch_from_db(filter_h filter, int batch_size, media_info_batch_cb callback, void *user_data)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+
+	media_content_debug_func();
+
+	if(callback == NULL || batch_size < 0)
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+
+	ret = _media_db_get_group_item_batch(NULL, filter, (batch_size > 0) ? batch_size : MEDIA_INFO_DEFAULT_BATCH_SIZE, callback, user_data, MEDIA_GROUP_NONE);
+
+	return ret;
+}
+
+int media_info_foreach_columns_from_db(filter_h filter, media_info_columns_s *columns, media_info_columns_cb callback, void *user_data)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+
+	media_content_debug_func();
+
+	if(columns == NULL || callback == NULL || columns->capacity <= 0 ||
+		(columns->path_offset != NULL && (columns->path == NULL || columns->path_capacity <= 0)))
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+
+	ret = _media_db_get_media_columns(filter, columns, callback, user_data);
+
+	return ret;
+}
+
 int media_info_get_tag_count_from_db(const char *media_id, filter_h filter, int *tag_count)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
@@ -953,7 +1175,7 @@ int media_info_get_image(media_info_h media, image_meta_h *image)
 	int ret = MEDIA_CONTENT_ERROR_NONE;
 
 	media_info_s *_media = (media_info_s*)media;
-	media_content_debug_func();
+	media_content_verbose_func();
 
 	if(_media == NULL)
 	{
@@ -967,6 +1189,12 @@ int media_info_get_image(media_info_h media, image_meta_h *image)
 		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
 	}
 
+	if(!(_media->loaded_fields & MEDIA_CONTENT_FIELD_IMAGE_META))
+	{
+		media_content_error("NOT_LOADED(0x%08x)", MEDIA_CONTENT_ERROR_NOT_LOADED);
+		return MEDIA_CONTENT_ERROR_NOT_LOADED;
+	}
+
 	if(_media->image_meta == NULL)
 	{
 		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
@@ -1003,7 +1231,7 @@ int media_info_get_video(media_info_h media, video_meta_h *video)
 	int ret = MEDIA_CONTENT_ERROR_NONE;
 
 	media_info_s *_media = (media_info_s*)media;
-	media_content_debug_func();
+	media_content_verbose_func();
 
 	if(_media == NULL)
 	{
@@ -1017,6 +1245,12 @@ int media_info_get_video(media_info_h media, video_meta_h *video)
 		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
 	}
 
+	if(!(_media->loaded_fields & MEDIA_CONTENT_FIELD_AV_META))
+	{
+		media_content_error("NOT_LOADED(0x%08x)", MEDIA_CONTENT_ERROR_NOT_LOADED);
+		return MEDIA_CONTENT_ERROR_NOT_LOADED;
+	}
+
 	if(_media->video_meta == NULL)
 	{
 		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
@@ -1081,7 +1315,7 @@ int media_info_get_audio(media_info_h media, audio_meta_h *audio)
 	int ret = MEDIA_CONTENT_ERROR_NONE;
 
 	media_info_s *_media = (media_info_s*)media;
-	media_content_debug_func();
+	media_content_verbose_func();
 
 	if(_media == NULL)
 	{
@@ -1095,6 +1329,12 @@ int media_info_get_audio(media_info_h media, audio_meta_h *audio)
 		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
 	}
 
+	if(!(_media->loaded_fields & MEDIA_CONTENT_FIELD_AV_META))
+	{
+		media_content_error("NOT_LOADED(0x%08x)", MEDIA_CONTENT_ERROR_NOT_LOADED);
+		return MEDIA_CONTENT_ERROR_NOT_LOADED;
+	}
+
 	if(_media->audio_meta == NULL)
 	{
 		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
@@ -1421,6 +1661,12 @@ int media_info_get_longitude(media_info_h media, double* longitude)
 
 	if(_media && longitude)
 	{
+		if(!(_media->loaded_fields & MEDIA_CONTENT_FIELD_LOCATION))
+		{
+			media_content_error("NOT_LOADED(0x%08x)", MEDIA_CONTENT_ERROR_NOT_LOADED);
+			return MEDIA_CONTENT_ERROR_NOT_LOADED;
+		}
+
 		*longitude = _media->longitude;
 		ret = MEDIA_CONTENT_ERROR_NONE;
 	}
@@ -1439,6 +1685,12 @@ int media_info_get_latitude(media_info_h media, double* latitude)
 
 	if(_media && latitude)
 	{
+		if(!(_media->loaded_fields & MEDIA_CONTENT_FIELD_LOCATION))
+		{
+			media_content_error("NOT_LOADED(0x%08x)", MEDIA_CONTENT_ERROR_NOT_LOADED);
+			return MEDIA_CONTENT_ERROR_NOT_LOADED;
+		}
+
 		*latitude = _media->latitude;
 		ret = MEDIA_CONTENT_ERROR_NONE;
 	}
@@ -1458,6 +1710,12 @@ int media_info_get_altitude(media_info_h media, double *altitude)
 
 	if(_media && altitude)
 	{
+		if(!(_media->loaded_fields & MEDIA_CONTENT_FIELD_LOCATION))
+		{
+			media_content_error("NOT_LOADED(0x%08x)", MEDIA_CONTENT_ERROR_NOT_LOADED);
+			return MEDIA_CONTENT_ERROR_NOT_LOADED;
+		}
+
 		*altitude = _media->altitude;
 		ret = MEDIA_CONTENT_ERROR_NONE;
 	}
@@ -1767,7 +2025,6 @@ int media_info_get_storage_type(media_info_h media, media_content_storage_e *sto
 int media_info_get_media_from_db(const char *media_id, media_info_h *media)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
-	char select_query[DEFAULT_QUERY_SIZE];
 	sqlite3_stmt *stmt = NULL;
 
 	if(!STRING_VALID(media_id) || (media == NULL))
@@ -1776,13 +2033,17 @@ int media_info_get_media_from_db(const char *media_id, media_info_h *media)
 		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
 	}
 
-	memset(select_query, 0x00, sizeof(select_query));
-
-	snprintf(select_query, sizeof(select_query), SELECT_MEDIA_FROM_MEDIA, media_id);
-	ret = _content_query_prepare(&stmt, select_query, NULL, NULL);
+	ret = _content_query_prepare(&stmt, SELECT_MEDIA_FROM_MEDIA, NULL, NULL);
 	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
 
-	while(sqlite3_step(stmt) == SQLITE_ROW)
+	ret = _content_query_bind_text(stmt, 1, media_id);
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+	{
+		SQLITE3_FINALIZE(stmt);
+		return ret;
+	}
+
+	while(_content_query_step(stmt) == SQLITE_ROW)
 	{
 		media_info_s *_media = (media_info_s*)calloc(1, sizeof(media_info_s));
 
@@ -1793,7 +2054,7 @@ int media_info_get_media_from_db(const char *media_id, media_info_h *media)
 			return MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
 		}
 
-		_media_info_item_get_detail(stmt, (media_info_h)_media);
+		_media_info_item_get_detail(stmt, (media_info_h)_media, MEDIA_CONTENT_FIELD_ALL, NULL);
 
 		*media = (media_info_h)_media;
 	}
@@ -1810,9 +2071,9 @@ int media_info_set_display_name(media_info_h media, const char *display_name)
 
 	if(_media != NULL && STRING_VALID(display_name))
 	{
-		SAFE_FREE(_media->display_name);
+		__media_info_free_str(_media, &_media->display_name);
 
-		_media->display_name = strdup(display_name);
+		_media->display_name = __media_info_strdup(_media, display_name);
 		if(_media->display_name == NULL)
 		{
 			media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
@@ -1835,11 +2096,11 @@ int media_info_set_description(media_info_h media, const char *description)
 
 	if(_media != NULL)
 	{
-		SAFE_FREE(_media->description);
+		__media_info_free_str(_media, &_media->description);
 
 		if(STRING_VALID(description))
 		{
-			_media->description = strdup(description);
+			_media->description = __media_info_strdup(_media, description);
 
 			if(_media->description == NULL)
 			{
@@ -1868,6 +2129,12 @@ int media_info_set_longitude(media_info_h media, double longitude)
 
 	if(_media != NULL)
 	{
+		if(!(_media->loaded_fields & MEDIA_CONTENT_FIELD_LOCATION))
+		{
+			media_content_error("NOT_LOADED(0x%08x)", MEDIA_CONTENT_ERROR_NOT_LOADED);
+			return MEDIA_CONTENT_ERROR_NOT_LOADED;
+		}
+
 		_media->longitude = longitude;
 	}
 	else
@@ -1886,6 +2153,12 @@ int media_info_set_latitude(media_info_h media, double latitude)
 
 	if(_media != NULL)
 	{
+		if(!(_media->loaded_fields & MEDIA_CONTENT_FIELD_LOCATION))
+		{
+			media_content_error("NOT_LOADED(0x%08x)", MEDIA_CONTENT_ERROR_NOT_LOADED);
+			return MEDIA_CONTENT_ERROR_NOT_LOADED;
+		}
+
 		_media->latitude = latitude;
 	}
 	else
@@ -1904,6 +2177,12 @@ int media_info_set_altitude(media_info_h media, double altitude)
 
 	if(_media != NULL)
 	{
+		if(!(_media->loaded_fields & MEDIA_CONTENT_FIELD_LOCATION))
+		{
+			media_content_error("NOT_LOADED(0x%08x)", MEDIA_CONTENT_ERROR_NOT_LOADED);
+			return MEDIA_CONTENT_ERROR_NOT_LOADED;
+		}
+
 		_media->altitude = altitude;
 	}
 	else
@@ -1977,9 +2256,11 @@ int media_info_set_author(media_info_h media, const char *author)
 
 	if(_media != NULL)
 	{
+		__media_info_free_str(_media, &_media->author);
+
 		if(STRING_VALID(author))
 		{
-			_media->author = strdup(author);
+			_media->author = __media_info_strdup(_media, author);
 			if(_media->author == NULL)
 			{
 				media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
@@ -2007,11 +2288,11 @@ int media_info_set_provider(media_info_h media, const char *provider)
 
 	if(_media != NULL)
 	{
-		SAFE_FREE(_media->provider);
+		__media_info_free_str(_media, &_media->provider);
 
 		if(STRING_VALID(provider))
 		{
-			_media->provider = strdup(provider);
+			_media->provider = __media_info_strdup(_media, provider);
 			if(_media->provider == NULL)
 			{
 				media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
@@ -2039,11 +2320,11 @@ int media_info_set_content_name(media_info_h media, const char *content_name)
 
 	if(_media != NULL)
 	{
-		SAFE_FREE(_media->content_name);
+		__media_info_free_str(_media, &_media->content_name);
 
 		if(STRING_VALID(content_name))
 		{
-			_media->content_name = strdup(content_name);
+			_media->content_name = __media_info_strdup(_media, content_name);
 			if(_media->content_name == NULL)
 			{
 				media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
@@ -2071,11 +2352,11 @@ int media_info_set_category(media_info_h media, const char *category)
 
 	if(_media != NULL)
 	{
-		SAFE_FREE(_media->category);
+		__media_info_free_str(_media, &_media->category);
 
 		if(STRING_VALID(category))
 		{
-			_media->category = strdup(category);
+			_media->category = __media_info_strdup(_media, category);
 			if(_media->category == NULL)
 			{
 				media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
@@ -2103,11 +2384,11 @@ int media_info_set_location_tag(media_info_h media, const char *location_tag)
 
 	if(_media != NULL)
 	{
-		SAFE_FREE(_media->location_tag);
+		__media_info_free_str(_media, &_media->location_tag);
 
 		if(STRING_VALID(location_tag))
 		{
-			_media->location_tag = strdup(location_tag);
+			_media->location_tag = __media_info_strdup(_media, location_tag);
 			if(_media->location_tag == NULL)
 			{
 				media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
@@ -2135,11 +2416,11 @@ int media_info_set_age_rating(media_info_h media, const char *age_rating)
 
 	if(_media != NULL)
 	{
-		SAFE_FREE(_media->age_rating);
+		__media_info_free_str(_media, &_media->age_rating);
 
 		if(STRING_VALID(age_rating))
 		{
-			_media->age_rating = strdup(age_rating);
+			_media->age_rating = __media_info_strdup(_media, age_rating);
 			if(_media->age_rating == NULL)
 			{
 				media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
@@ -2167,11 +2448,11 @@ int media_info_set_keyword(media_info_h media, const char *keyword)
 
 	if(_media != NULL)
 	{
-		SAFE_FREE(_media->keyword);
+		__media_info_free_str(_media, &_media->keyword);
 
 		if(STRING_VALID(keyword))
 		{
-			_media->keyword = strdup(keyword);
+			_media->keyword = __media_info_strdup(_media, keyword);
 			if(_media->keyword == NULL)
 			{
 				media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
@@ -2203,10 +2484,21 @@ int media_info_update_to_db(media_info_h media)
 
 	if(_media != NULL && STRING_VALID(_media->media_id))
 	{
-		set_sql = sqlite3_mprintf("file_name=%Q, added_time=%d, description=%Q, longitude=%f, latitude=%f, altitude=%f, \
-			rating=%d, favourite=%d, author=%Q, provider=%Q, content_name=%Q, category=%Q, location_tag=%Q, age_rating=%Q, keyword=%Q",
-			_media->display_name, _media->added_time, _media->description, _media->longitude, _media->latitude, _media->altitude, _media->rating, _media->favourite,
-			_media->author, _media->provider, _media->content_name, _media->category, _media->location_tag, _media->age_rating, _media->keyword);
+		if(_media->loaded_fields & MEDIA_CONTENT_FIELD_LOCATION)
+		{
+			set_sql = sqlite3_mprintf("file_name=%Q, added_time=%d, description=%Q, longitude=%f, latitude=%f, altitude=%f, \
+				rating=%d, favourite=%d, author=%Q, provider=%Q, content_name=%Q, category=%Q, location_tag=%Q, age_rating=%Q, keyword=%Q",
+				_media->display_name, _media->added_time, _media->description, _media->longitude, _media->latitude, _media->altitude, _media->rating, _media->favourite,
+				_media->author, _media->provider, _media->content_name, _media->category, _media->location_tag, _media->age_rating, _media->keyword);
+		}
+		else
+		{
+			/* Location was not loaded, keep what is in db */
+			set_sql = sqlite3_mprintf("file_name=%Q, added_time=%d, description=%Q, \
+				rating=%d, favourite=%d, author=%Q, provider=%Q, content_name=%Q, category=%Q, location_tag=%Q, age_rating=%Q, keyword=%Q",
+				_media->display_name, _media->added_time, _media->description, _media->rating, _media->favourite,
+				_media->author, _media->provider, _media->content_name, _media->category, _media->location_tag, _media->age_rating, _media->keyword);
+		}
 
 		len = snprintf(sql, sizeof(sql), "UPDATE %s SET %s WHERE media_uuid='%s'", DB_TABLE_MEDIA, set_sql, _media->media_id);
 		sqlite3_free(set_sql);
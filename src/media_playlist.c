@@ -21,45 +21,79 @@
 #include <media_playlist.h>
 
 
-static __thread GList *g_playlist_item_list = NULL;
-
-static void __media_playlist_item_add(media_playlist_item_s *item_s);
-static void __media_playlist_item_release(void);
+static int __media_playlist_item_add(media_playlist_s *playlist, int function, const char *media_id, const char *playlist_name, int playlist_member_id, int play_order);
+static void __media_playlist_item_release(media_playlist_s *playlist);
 static int __media_playlist_insert_playlist_record(const char *playlist_name, int *playlist_id);
-static int __media_playlist_insert_item_to_playlist(int playlist_id, const char *media_id);
-static int __media_playlist_remove_item_from_playlist(int playlist_id, int playlist_member_id);
-static int __media_playlist_update_playlist_name(int playlist_id, const char *playlist_name);
-static int __media_playlist_update_play_order(int playlist_id, int playlist_member_id, int play_order);
-
-static void __media_playlist_item_add(media_playlist_item_s *item_s)
+static int __media_playlist_get_max_play_order(int playlist_id, int *play_order);
+static int __media_playlist_apply_item(int playlist_id, media_playlist_item_s *item, sqlite3_stmt **stmts, int *max_play_order);
+
+/* Indexed by playlist_function_e */
+static const char *g_playlist_item_query[MEDIA_PLAYLIST_FUNCTION_MAX] = {
+	INSERT_PLAYLIST_ITEM_TO_PLAYLIST_MAP,
+	REMOVE_PLAYLIST_ITEM_FROM_PLAYLIST_MAP,
+	UPDATE_PLAYLIST_NAME_FROM_PLAYLIST,
+	UPDATE_PLAYLIST_ORDER_FROM_PLAYLIST_MAP,
+};
+
+static int __media_playlist_item_add(media_playlist_s *playlist, int function, const char *media_id, const char *playlist_name, int playlist_member_id, int play_order)
 {
-	g_playlist_item_list = g_list_append(g_playlist_item_list, item_s);
+	int size = 0;
+	media_playlist_item_s *items = NULL;
+	media_playlist_item_s *item = NULL;
+
+	if(playlist->item_count == playlist->item_size)
+	{
+		size = (playlist->item_size > 0) ? playlist->item_size * 2 : MEDIA_CONTENT_PENDING_ITEM_SIZE;
+		items = (media_playlist_item_s*)realloc(playlist->items, size * sizeof(media_playlist_item_s));
+		if(items == NULL)
+		{
+			media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
+			return MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
+		}
+
+		playlist->items = items;
+		playlist->item_size = size;
+	}
+
+	item = &playlist->items[playlist->item_count];
+	memset(item, 0x00, sizeof(media_playlist_item_s));
+	item->function = function;
+	item->playlist_member_id = playlist_member_id;
+	item->play_order = play_order;
+
+	if(STRING_VALID(media_id))
+		item->media_id = strdup(media_id);
+	if(STRING_VALID(playlist_name))
+		item->playlist_name = strdup(playlist_name);
+
+	if((STRING_VALID(media_id) && item->media_id == NULL) || (STRING_VALID(playlist_name) && item->playlist_name == NULL))
+	{
+		SAFE_FREE(item->media_id);
+		SAFE_FREE(item->playlist_name);
+		media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
+		return MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
+	}
+
+	playlist->item_count++;
+
+	return MEDIA_CONTENT_ERROR_NONE;
 }
 
-static void __media_playlist_item_release(void)
+static void __media_playlist_item_release(media_playlist_s *playlist)
 {
 	int idx = 0;
-	int list_cnt = 0;
-	media_playlist_item_s *item = NULL;
-
-	list_cnt = g_list_length(g_playlist_item_list);
 
-	media_content_debug("list_cnt : [%d]", list_cnt);
+	media_content_debug("list_cnt : [%d]", playlist->item_count);
 
-	for(idx = 0; idx < list_cnt; idx++)
+	for(idx = 0; idx < playlist->item_count; idx++)
 	{
-		item = (media_playlist_item_s*)g_list_nth_data(g_playlist_item_list, idx);
-		if(item != NULL)
-		{
-			SAFE_FREE(item->media_id);
-			SAFE_FREE(item->playlist_name);
-			SAFE_FREE(item);
-		}
+		SAFE_FREE(playlist->items[idx].media_id);
+		SAFE_FREE(playlist->items[idx].playlist_name);
 	}
 
-	g_list_free(g_playlist_item_list);
-	g_playlist_item_list = NULL;
-
+	SAFE_FREE(playlist->items);
+	playlist->item_count = 0;
+	playlist->item_size = 0;
 }
 
 static int __media_playlist_insert_playlist_record(const char *playlist_name, int *playlist_id)
@@ -81,7 +115,7 @@ static int __media_playlist_insert_playlist_record(const char *playlist_name, in
 	sqlite3_free(select_query);
 	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
 
-	while(sqlite3_step(stmt) == SQLITE_ROW)
+	while(_content_query_step(stmt) == SQLITE_ROW)
 	{
 		*playlist_id = (int)sqlite3_column_int(stmt,0);
 	}
@@ -91,76 +125,110 @@ static int __media_playlist_insert_playlist_record(const char *playlist_name, in
 	return MEDIA_CONTENT_ERROR_NONE;
 }
 
-static int __media_playlist_insert_item_to_playlist(int playlist_id, const char *media_id)
+/* Read on the writer connection, as it runs inside the update transaction */
+static int __media_playlist_get_max_play_order(int playlist_id, int *play_order)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
 	sqlite3_stmt *stmt = NULL;
 	char select_query[DEFAULT_QUERY_SIZE];
-	char *query_str = NULL;
-	int play_order = 0;
 
 	memset(select_query, 0x00, sizeof(select_query));
 
 	snprintf(select_query, sizeof(select_query), SELECT_MAX_PLAY_ORDER_FROM_PLAYLIST_VIEW, playlist_id);
 
-	/* get the max play_order */
-	ret = _content_query_prepare(&stmt, select_query, NULL, NULL);
+	ret = _content_query_prepare_writer_str(&stmt, select_query);
 	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
 
-	while(sqlite3_step(stmt) == SQLITE_ROW)
+	*play_order = 0;
+
+	while(_content_query_step(stmt) == SQLITE_ROW)
 	{
-		play_order = (int)sqlite3_column_int(stmt, 0);
+		*play_order = (int)sqlite3_column_int(stmt, 0);
 	}
 
 	SQLITE3_FINALIZE(stmt);
 
-	++play_order;
-
-	query_str = sqlite3_mprintf("INSERT INTO %q (playlist_id, media_uuid, play_order) values (%d, '%q', %d)",
-			DB_TABLE_PLAYLIST_MAP, playlist_id, media_id, play_order);
-	ret = _content_query_sql(query_str);
-	sqlite3_free(query_str);
-
-	return ret;
+	return MEDIA_CONTENT_ERROR_NONE;
 }
 
-static int __media_playlist_remove_item_from_playlist(int playlist_id, int playlist_member_id)
+/* Statements are prepared on first use and kept in stmts for the rest of the batch.
+ * max_play_order is read once on the first add and then tracked here, -1 until then. */
+static int __media_playlist_apply_item(int playlist_id, media_playlist_item_s *item, sqlite3_stmt **stmts, int *max_play_order)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
-	char *query_str = NULL;
+	sqlite3_stmt *stmt = NULL;
 
-	query_str = sqlite3_mprintf(REMOVE_PLAYLIST_ITEM_FROM_PLAYLIST_MAP, playlist_id, playlist_member_id);
+	if(item->function < 0 || item->function >= MEDIA_PLAYLIST_FUNCTION_MAX)
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
 
-	ret = _content_query_sql(query_str);
-	sqlite3_free(query_str);
+	if(item->function == MEDIA_PLAYLIST_ADD && *max_play_order < 0)
+	{
+		ret = __media_playlist_get_max_play_order(playlist_id, max_play_order);
+		media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
+	}
 
-	return ret;
-}
+	if(stmts[item->function] == NULL)
+	{
+		ret = _content_query_prepare_str(&stmts[item->function], g_playlist_item_query[item->function]);
+		media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
+	}
 
-static int __media_playlist_update_playlist_name(int playlist_id, const char *playlist_name)
-{
-	int ret = MEDIA_CONTENT_ERROR_NONE;
-	char *query_str = NULL;
+	stmt = stmts[item->function];
+	sqlite3_reset(stmt);
 
-	query_str = sqlite3_mprintf(UPDATE_PLAYLIST_NAME_FROM_PLAYLIST, playlist_name, playlist_id);
+	switch(item->function) {
+		case MEDIA_PLAYLIST_ADD:
+		{
+			ret = _content_query_bind_int(stmt, 1, playlist_id);
+			if(ret == MEDIA_CONTENT_ERROR_NONE)
+				ret = _content_query_bind_text(stmt, 2, item->media_id);
+			if(ret == MEDIA_CONTENT_ERROR_NONE)
+				ret = _content_query_bind_int(stmt, 3, *max_play_order + 1);
+		}
+		break;
 
-	ret = _content_query_sql(query_str);
-	sqlite3_free(query_str);
+		case MEDIA_PLAYLIST_REMOVE:
+		{
+			ret = _content_query_bind_int(stmt, 1, playlist_id);
+			if(ret == MEDIA_CONTENT_ERROR_NONE)
+				ret = _content_query_bind_int(stmt, 2, item->playlist_member_id);
+		}
+		break;
 
-	return ret;
-}
+		case MEDIA_PLAYLIST_UPDATE_PLAYLIST_NAME:
+		{
+			ret = _content_query_bind_text(stmt, 1, item->playlist_name);
+			if(ret == MEDIA_CONTENT_ERROR_NONE)
+				ret = _content_query_bind_int(stmt, 2, playlist_id);
+		}
+		break;
 
-static int __media_playlist_update_play_order(int playlist_id, int playlist_member_id, int play_order)
-{
-	int ret = MEDIA_CONTENT_ERROR_NONE;
-	char *query_str = NULL;
+		case MEDIA_PLAYLIST_UPDATE_PLAY_ORDER:
+		{
+			ret = _content_query_bind_int(stmt, 1, item->play_order);
+			if(ret == MEDIA_CONTENT_ERROR_NONE)
+				ret = _content_query_bind_int(stmt, 2, playlist_id);
+			if(ret == MEDIA_CONTENT_ERROR_NONE)
+				ret = _content_query_bind_int(stmt, 3, item->playlist_member_id);
+		}
+		break;
+	}
 
-	query_str = sqlite3_mprintf(UPDATE_PLAYLIST_ORDER_FROM_PLAYLIST_MAP, play_order, playlist_id, playlist_member_id);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = _content_query_step_done(stmt);
 
-	ret = _content_query_sql(query_str);
-	sqlite3_free(query_str);
+	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
 
-	return ret;
+	/* Later adds are appended after the new member or the moved one */
+	if(item->function == MEDIA_PLAYLIST_ADD)
+		(*max_play_order)++;
+	else if(item->function == MEDIA_PLAYLIST_UPDATE_PLAY_ORDER && *max_play_order >= 0 && item->play_order > *max_play_order)
+		*max_play_order = item->play_order;
+
+	return MEDIA_CONTENT_ERROR_NONE;
 }
 
 int media_playlist_insert_to_db(const char *name, media_playlist_h *playlist)
@@ -261,6 +329,23 @@ int media_playlist_foreach_playlist_from_db(filter_h filter, media_playlist_cb c
 	return ret;
 }
 
+int media_playlist_foreach_playlist_with_count_from_db(filter_h filter, media_playlist_count_cb callback, void *user_data)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+
+	media_content_debug_func();
+
+	if(callback == NULL)
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+
+	ret = _media_db_get_playlist_with_count(filter, callback, user_data);
+
+	return ret;
+}
+
 int media_playlist_get_media_count_from_db(int playlist_id, filter_h filter, int *media_count)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
@@ -305,10 +390,11 @@ int media_playlist_destroy(media_playlist_h playlist)
 	int ret = MEDIA_CONTENT_ERROR_NONE;
 	media_playlist_s *_playlist = (media_playlist_s*)playlist;
 
-	media_content_debug_func();
+	media_content_verbose_func();
 
 	if(_playlist)
 	{
+		__media_playlist_item_release(_playlist);
 		SAFE_FREE(_playlist->name);
 		SAFE_FREE(_playlist);
 
@@ -328,7 +414,7 @@ int media_playlist_clone(media_playlist_h *dst, media_playlist_h src)
 	int ret = MEDIA_CONTENT_ERROR_NONE;
 	media_playlist_s *_src = (media_playlist_s*)src;
 
-	media_content_debug_func();
+	media_content_verbose_func();
 
 	if(_src != NULL)
 	{
@@ -380,7 +466,7 @@ int media_playlist_get_playlist_from_db(int playlist_id, filter_h filter, media_
 		ret = _content_query_prepare(&stmt, select_query, NULL, NULL);
 		media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
 
-		while(sqlite3_step(stmt) == SQLITE_ROW)
+		while(_content_query_step(stmt) == SQLITE_ROW)
 		{
 			media_playlist_s *_playlist = (media_playlist_s*)calloc(1, sizeof(media_playlist_s));
 
@@ -475,7 +561,7 @@ int media_playlist_get_play_order(media_playlist_h playlist, int playlist_member
 	ret = _content_query_prepare(&stmt, select_query, NULL, NULL);
 	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
 
-	while(sqlite3_step(stmt) == SQLITE_ROW)
+	while(_content_query_step(stmt) == SQLITE_ROW)
 	{
 		*play_order = (int)sqlite3_column_int(stmt, 0);
 	}
@@ -492,26 +578,16 @@ int media_playlist_set_name(media_playlist_h playlist, const char *playlist_name
 
 	if(_playlist != NULL && STRING_VALID(playlist_name))
 	{
-		SAFE_FREE(_playlist->name);
-
-		media_playlist_item_s *item = (media_playlist_item_s*)calloc(1, sizeof(media_playlist_item_s));
-
-		item->playlist_name = strdup(playlist_name);
-		item->function = MEDIA_PLAYLIST_UPDATE_PLAYLIST_NAME;
-		if(item->playlist_name == NULL)
-		{
-			media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
-			return MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
-		}
+		ret = __media_playlist_item_add(_playlist, MEDIA_PLAYLIST_UPDATE_PLAYLIST_NAME, NULL, playlist_name, 0, 0);
+		media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
 
+		SAFE_FREE(_playlist->name);
 		_playlist->name = strdup(playlist_name);
 		if(_playlist->name == NULL)
 		{
 			media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
 			return MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
 		}
-
-		__media_playlist_item_add(item);
 	}
 	else
 	{
@@ -529,13 +605,7 @@ int media_playlist_set_play_order(media_playlist_h playlist, int playlist_member
 
 	if((_playlist != NULL) && (playlist_member_id > 0) && (play_order >= 0))
 	{
-		media_playlist_item_s *item = (media_playlist_item_s*)calloc(1, sizeof(media_playlist_item_s));
-
-		item->playlist_member_id = playlist_member_id;
-		item->function = MEDIA_PLAYLIST_UPDATE_PLAY_ORDER;
-		item->play_order = play_order;
-
-		__media_playlist_item_add(item);
+		ret = __media_playlist_item_add(_playlist, MEDIA_PLAYLIST_UPDATE_PLAY_ORDER, NULL, NULL, playlist_member_id, play_order);
 	}
 	else
 	{
@@ -553,18 +623,7 @@ int media_playlist_add_media(media_playlist_h playlist, const char *media_id)
 
 	if(_playlist != NULL && STRING_VALID(media_id))
 	{
-		media_playlist_item_s *item = (media_playlist_item_s*)calloc(1, sizeof(media_playlist_item_s));
-
-		item->media_id = strdup(media_id);
-		item->function = MEDIA_PLAYLIST_ADD;
-
-		if(item->media_id == NULL)
-		{
-			media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
-			return MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
-		}
-
-		__media_playlist_item_add(item);
+		ret = __media_playlist_item_add(_playlist, MEDIA_PLAYLIST_ADD, media_id, NULL, 0, 0);
 	}
 	else
 	{
@@ -583,12 +642,7 @@ int media_playlist_remove_media(media_playlist_h playlist, int playlist_member_i
 
 	if((_playlist != NULL) && (playlist_member_id > 0))
 	{
-		media_playlist_item_s *item = (media_playlist_item_s*)calloc(1, sizeof(media_playlist_item_s));
-
-		item->playlist_member_id = playlist_member_id;
-		item->function = MEDIA_PLAYLIST_REMOVE;
-
-		__media_playlist_item_add(item);
+		ret = __media_playlist_item_add(_playlist, MEDIA_PLAYLIST_REMOVE, NULL, NULL, playlist_member_id, 0);
 	}
 	else
 	{
@@ -600,12 +654,18 @@ int media_playlist_remove_media(media_playlist_h playlist, int playlist_member_i
 }
 
 int media_playlist_update_to_db(media_playlist_h playlist)
+{
+	return media_playlist_update_to_db_with_count(playlist, NULL);
+}
+
+int media_playlist_update_to_db_with_count(media_playlist_h playlist, int *applied_count)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
 	media_playlist_s *_playlist = (media_playlist_s*)playlist;
+	sqlite3_stmt *stmts[MEDIA_PLAYLIST_FUNCTION_MAX];
 	int idx = 0;
-	int length = 0;
-	media_playlist_item_s *_playlist_item = NULL;
+	int count = 0;
+	int max_play_order = -1;
 
 	if(_playlist == NULL)
 	{
@@ -613,40 +673,42 @@ int media_playlist_update_to_db(media_playlist_h playlist)
 		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
 	}
 
-	length = g_list_length(g_playlist_item_list);
-
-	for (idx = 0; idx < length; idx++) {
-		_playlist_item = (media_playlist_item_s*)g_list_nth_data(g_playlist_item_list, idx);
-		if(_playlist_item != NULL) {
-			switch(_playlist_item->function) {
-				case MEDIA_PLAYLIST_ADD:
-				{
-					ret = __media_playlist_insert_item_to_playlist(_playlist->playlist_id, _playlist_item->media_id);
-				}
-				break;
-
-				case MEDIA_PLAYLIST_REMOVE:
-				{
-					ret = __media_playlist_remove_item_from_playlist(_playlist->playlist_id, _playlist_item->playlist_member_id);
-				}
-				break;
-
-				case MEDIA_PLAYLIST_UPDATE_PLAYLIST_NAME:
-				{
-					ret = __media_playlist_update_playlist_name(_playlist->playlist_id, _playlist_item->playlist_name);
-				}
-				break;
-
-				case MEDIA_PLAYLIST_UPDATE_PLAY_ORDER:
-				{
-					ret = __media_playlist_update_play_order(_playlist->playlist_id, _playlist_item->playlist_member_id, _playlist_item->play_order);
-				}
-				break;
-			}
-		}
+	if(applied_count != NULL)
+		*applied_count = 0;
+
+	if(_playlist->item_count == 0)
+		return MEDIA_CONTENT_ERROR_NONE;
+
+	memset(stmts, 0x00, sizeof(stmts));
+
+	ret = _content_transaction_begin();
+	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
+
+	for(count = 0; count < _playlist->item_count; count++)
+	{
+		ret = __media_playlist_apply_item(_playlist->playlist_id, &_playlist->items[count], stmts, &max_play_order);
+		if(ret != MEDIA_CONTENT_ERROR_NONE)
+			break;
 	}
 
-	__media_playlist_item_release();
+	for(idx = 0; idx < MEDIA_PLAYLIST_FUNCTION_MAX; idx++)
+	{
+		SQLITE3_FINALIZE(stmts[idx]);
+	}
+
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = _content_transaction_commit();
+	else
+		_content_transaction_rollback();
+
+	/* A rolled back batch stays pending, so it can be fixed up and applied again */
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+	{
+		if(applied_count != NULL)
+			*applied_count = count;
+
+		__media_playlist_item_release(_playlist);
+	}
 
 	return ret;
 }
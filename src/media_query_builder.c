@@ -0,0 +1,284 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include <stdarg.h>
+#include <pthread.h>
+#include <media_info_private.h>
+
+
+#define QUERY_BUILDER_KEEP_SIZE	(16 * 1024)	/* larger per-thread buffers are not kept */
+
+/* One buffer per thread, lent to the first builder that asks for it */
+typedef struct
+{
+	char *str;
+	int size;
+	bool in_use;
+}query_buffer_s;
+
+static pthread_once_t g_query_buffer_once = PTHREAD_ONCE_INIT;
+static pthread_key_t g_query_buffer_key;
+
+static void __media_query_builder_buffer_free(void *data);
+static void __media_query_builder_key_create(void);
+static query_buffer_s *__media_query_builder_get_buffer(void);
+static int __media_query_builder_grow(query_builder_s *query, int needed);
+static int __media_query_builder_add_bind(query_builder_s *query, int type, int int_value, const char *text_value);
+static int __media_query_builder_prepare(query_builder_s *query, sqlite3_stmt **stmt, bool use_cache);
+
+static void __media_query_builder_buffer_free(void *data)
+{
+	query_buffer_s *buffer = (query_buffer_s*)data;
+
+	if(buffer != NULL)
+	{
+		SAFE_FREE(buffer->str);
+		SAFE_FREE(buffer);
+	}
+}
+
+static void __media_query_builder_key_create(void)
+{
+	pthread_key_create(&g_query_buffer_key, __media_query_builder_buffer_free);
+}
+
+static query_buffer_s *__media_query_builder_get_buffer(void)
+{
+	query_buffer_s *buffer = NULL;
+
+	pthread_once(&g_query_buffer_once, __media_query_builder_key_create);
+
+	buffer = (query_buffer_s*)pthread_getspecific(g_query_buffer_key);
+	if(buffer == NULL)
+	{
+		buffer = (query_buffer_s*)calloc(1, sizeof(query_buffer_s));
+		if(buffer != NULL)
+			pthread_setspecific(g_query_buffer_key, buffer);
+	}
+
+	return buffer;
+}
+
+static int __media_query_builder_grow(query_builder_s *query, int needed)
+{
+	int size = 0;
+	char *str = NULL;
+
+	if(query->error != MEDIA_CONTENT_ERROR_NONE)
+		return query->error;
+
+	if(query->len + needed < query->size)
+		return MEDIA_CONTENT_ERROR_NONE;
+
+	size = (query->size > 0) ? query->size : DEFAULT_QUERY_SIZE;
+	while(size <= query->len + needed)
+		size *= 2;
+
+	str = (char*)realloc(query->str, size);
+	if(str == NULL)
+	{
+		media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
+		query->error = MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
+		return query->error;
+	}
+
+	query->str = str;
+	query->size = size;
+	query->str[query->len] = '\0';
+
+	return MEDIA_CONTENT_ERROR_NONE;
+}
+
+static int __media_query_builder_add_bind(query_builder_s *query, int type, int int_value, const char *text_value)
+{
+	int size = 0;
+	query_bind_s *binds = NULL;
+
+	if(query->error != MEDIA_CONTENT_ERROR_NONE)
+		return query->error;
+
+	if(query->bind_count == query->bind_size)
+	{
+		size = (query->bind_size > 0) ? query->bind_size * 2 : 4;
+		binds = (query_bind_s*)realloc(query->binds, size * sizeof(query_bind_s));
+		if(binds == NULL)
+		{
+			media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
+			query->error = MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
+			return query->error;
+		}
+
+		query->binds = binds;
+		query->bind_size = size;
+	}
+
+	query->binds[query->bind_count].type = type;
+	query->binds[query->bind_count].int_value = int_value;
+	query->binds[query->bind_count].text_value = text_value;
+	query->bind_count++;
+
+	return MEDIA_CONTENT_ERROR_NONE;
+}
+
+static int __media_query_builder_prepare(query_builder_s *query, sqlite3_stmt **stmt, bool use_cache)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	int idx = 0;
+
+	if(query->error != MEDIA_CONTENT_ERROR_NONE)
+		return query->error;
+
+	if(use_cache)
+		ret = _content_query_prepare_str(stmt, query->str);
+	else
+		ret = _content_query_prepare_uncached_str(stmt, query->str);
+	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
+
+	for(idx = 0; idx < query->bind_count; idx++)
+	{
+		if(query->binds[idx].type == SQLITE_TEXT)
+			ret = _content_query_bind_text(*stmt, idx + 1, query->binds[idx].text_value);
+		else
+			ret = _content_query_bind_int(*stmt, idx + 1, query->binds[idx].int_value);
+
+		if(ret != MEDIA_CONTENT_ERROR_NONE)
+		{
+			SQLITE3_FINALIZE(*stmt);
+			return ret;
+		}
+	}
+
+	return MEDIA_CONTENT_ERROR_NONE;
+}
+
+void _content_query_builder_init(query_builder_s *query)
+{
+	query_buffer_s *buffer = NULL;
+
+	memset(query, 0x00, sizeof(query_builder_s));
+
+	buffer = __media_query_builder_get_buffer();
+	if(buffer != NULL && !buffer->in_use)
+	{
+		buffer->in_use = TRUE;
+		query->str = buffer->str;
+		query->size = buffer->size;
+		query->borrowed = TRUE;
+		buffer->str = NULL;
+		buffer->size = 0;
+	}
+
+	if(query->str != NULL)
+		query->str[0] = '\0';
+}
+
+int _content_query_builder_append(query_builder_s *query, const char *str)
+{
+	int len = 0;
+
+	if(str == NULL)
+		return query->error;
+
+	len = strlen(str);
+	if(__media_query_builder_grow(query, len) != MEDIA_CONTENT_ERROR_NONE)
+		return query->error;
+
+	memcpy(query->str + query->len, str, len + 1);
+	query->len += len;
+
+	return MEDIA_CONTENT_ERROR_NONE;
+}
+
+/* Same format as sqlite3_mprintf(), so templates with %q/%Q can be used directly */
+int _content_query_builder_appendf(query_builder_s *query, const char *format, ...)
+{
+	int avail = 0;
+	int written = 0;
+	va_list args;
+
+	if(__media_query_builder_grow(query, strlen(format)) != MEDIA_CONTENT_ERROR_NONE)
+		return query->error;
+
+	while(1)
+	{
+		avail = query->size - query->len;
+
+		va_start(args, format);
+		sqlite3_vsnprintf(avail, query->str + query->len, format, args);
+		va_end(args);
+
+		/* sqlite3_vsnprintf() truncates silently, so a full buffer means "retry bigger" */
+		written = strlen(query->str + query->len);
+		if(written < avail - 1)
+			break;
+
+		if(__media_query_builder_grow(query, query->size) != MEDIA_CONTENT_ERROR_NONE)
+		{
+			query->str[query->len] = '\0';
+			return query->error;
+		}
+	}
+
+	query->len += written;
+
+	return MEDIA_CONTENT_ERROR_NONE;
+}
+
+int _content_query_builder_bind_text(query_builder_s *query, const char *value)
+{
+	return __media_query_builder_add_bind(query, SQLITE_TEXT, 0, value);
+}
+
+int _content_query_builder_bind_int(query_builder_s *query, int value)
+{
+	return __media_query_builder_add_bind(query, SQLITE_INTEGER, value, NULL);
+}
+
+int _content_query_builder_prepare(query_builder_s *query, sqlite3_stmt **stmt)
+{
+	return __media_query_builder_prepare(query, stmt, TRUE);
+}
+
+int _content_query_builder_prepare_uncached(query_builder_s *query, sqlite3_stmt **stmt)
+{
+	return __media_query_builder_prepare(query, stmt, FALSE);
+}
+
+void _content_query_builder_release(query_builder_s *query)
+{
+	query_buffer_s *buffer = NULL;
+
+	if(query->borrowed)
+	{
+		buffer = __media_query_builder_get_buffer();
+		if(buffer != NULL)
+		{
+			buffer->in_use = FALSE;
+
+			if(query->size <= QUERY_BUILDER_KEEP_SIZE)
+			{
+				buffer->str = query->str;
+				buffer->size = query->size;
+				query->str = NULL;
+			}
+		}
+	}
+
+	SAFE_FREE(query->str);
+	SAFE_FREE(query->binds);
+	memset(query, 0x00, sizeof(query_builder_s));
+}
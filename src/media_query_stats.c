@@ -0,0 +1,367 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include <media_content.h>
+#include <media_info_private.h>
+#include <pthread.h>
+#include <time.h>
+
+
+#define QUERY_STATS_SAMPLE_COUNT	128		// latest runs of a query kept for its p99
+#define QUERY_STATS_MAX_QUERIES		256
+#define MEDIA_CONTENT_STATS_ENV		"MEDIA_CONTENT_STATS"	// set to enable the stats from media_content_connect()
+
+typedef struct
+{
+	unsigned long long prepare_ns;		// time spent in prepare
+	unsigned long long step_ns;		// time spent in sqlite3_step() so far
+	unsigned long long rows;			// rows returned so far
+	unsigned long long materialized;	// rows made into media info so far
+}query_stats_run_s;
+
+typedef struct
+{
+	int count;											// finished runs
+	unsigned long long prepare_ns;
+	unsigned long long step_ns;
+	unsigned long long rows;
+	unsigned long long materialized;
+	unsigned long long prepare_samples[QUERY_STATS_SAMPLE_COUNT];	// ring of the latest runs, for the p99
+	unsigned long long step_samples[QUERY_STATS_SAMPLE_COUNT];
+}query_stats_shape_s;
+
+typedef struct
+{
+	char *query;
+	media_content_stats_s stats;
+}query_stats_copy_s;
+
+/* Read without the lock on every step from any thread, so that disabled stats cost a single
+ * atomic test */
+static gint g_stats_enabled = 0;
+static pthread_mutex_t g_stats_mutex = PTHREAD_MUTEX_INITIALIZER;
+static GHashTable *g_stats_runs = NULL;		// sqlite3_stmt* -> query_stats_run_s*, from prepare to finalize
+static GHashTable *g_stats_shapes = NULL;		// SQL -> query_stats_shape_s*
+
+static unsigned long long __media_query_stats_now(void);
+static query_stats_run_s *__media_query_stats_get_run(sqlite3_stmt *stmt);
+static unsigned long long __media_query_stats_p99(const unsigned long long *samples, int count);
+static int __media_query_stats_compare(const void *a, const void *b);
+static void __media_query_stats_clear(bool clear_shapes);
+
+static unsigned long long __media_query_stats_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (unsigned long long)ts.tv_sec * 1000000000ULL + (unsigned long long)ts.tv_nsec;
+}
+
+/* Called with g_stats_mutex held. Statements prepared before the stats were enabled have no run */
+static query_stats_run_s *__media_query_stats_get_run(sqlite3_stmt *stmt)
+{
+	if(g_stats_runs == NULL)
+		return NULL;
+
+	return (query_stats_run_s*)g_hash_table_lookup(g_stats_runs, stmt);
+}
+
+static int __media_query_stats_compare(const void *a, const void *b)
+{
+	unsigned long long x = *(const unsigned long long *)a;
+	unsigned long long y = *(const unsigned long long *)b;
+
+	return (x > y) - (x < y);
+}
+
+static unsigned long long __media_query_stats_p99(const unsigned long long *samples, int count)
+{
+	unsigned long long sorted[QUERY_STATS_SAMPLE_COUNT];
+
+	if(count <= 0)
+		return 0;
+
+	if(count > QUERY_STATS_SAMPLE_COUNT)
+		count = QUERY_STATS_SAMPLE_COUNT;
+
+	memcpy(sorted, samples, count * sizeof(unsigned long long));
+	qsort(sorted, count, sizeof(unsigned long long), __media_query_stats_compare);
+
+	return sorted[(count * 99 + 99) / 100 - 1];
+}
+
+/* Called with g_stats_mutex held */
+static void __media_query_stats_clear(bool clear_shapes)
+{
+	if(g_stats_runs != NULL)
+	{
+		g_hash_table_destroy(g_stats_runs);
+		g_stats_runs = NULL;
+	}
+
+	if(clear_shapes && g_stats_shapes != NULL)
+	{
+		g_hash_table_destroy(g_stats_shapes);
+		g_stats_shapes = NULL;
+	}
+}
+
+void _media_query_stats_load(void)
+{
+	if(getenv(MEDIA_CONTENT_STATS_ENV) != NULL)
+		media_content_enable_stats();
+}
+
+unsigned long long _media_query_stats_begin(void)
+{
+	if(!g_atomic_int_get(&g_stats_enabled))
+		return 0;
+
+	return __media_query_stats_now();
+}
+
+void _media_query_stats_prepared(sqlite3_stmt *stmt, unsigned long long begin)
+{
+	query_stats_run_s *run = NULL;
+
+	if(begin == 0 || stmt == NULL)
+		return;
+
+	run = (query_stats_run_s*)calloc(1, sizeof(query_stats_run_s));
+	if(run == NULL)
+		return;
+
+	run->prepare_ns = __media_query_stats_now() - begin;
+
+	pthread_mutex_lock(&g_stats_mutex);
+
+	if(g_stats_runs == NULL)
+		g_stats_runs = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, free);
+
+	/* A statement left unfinalized by its last run starts over */
+	g_hash_table_insert(g_stats_runs, stmt, run);
+
+	pthread_mutex_unlock(&g_stats_mutex);
+}
+
+void _media_query_stats_stepped(sqlite3_stmt *stmt, unsigned long long begin, bool row)
+{
+	unsigned long long elapsed = 0;
+	query_stats_run_s *run = NULL;
+
+	if(begin == 0)
+		return;
+
+	elapsed = __media_query_stats_now() - begin;
+
+	pthread_mutex_lock(&g_stats_mutex);
+
+	run = __media_query_stats_get_run(stmt);
+	if(run != NULL)
+	{
+		run->step_ns += elapsed;
+		if(row)
+			run->rows++;
+	}
+
+	pthread_mutex_unlock(&g_stats_mutex);
+}
+
+void _media_query_stats_materialized(sqlite3_stmt *stmt)
+{
+	query_stats_run_s *run = NULL;
+
+	if(!g_atomic_int_get(&g_stats_enabled))
+		return;
+
+	pthread_mutex_lock(&g_stats_mutex);
+
+	run = __media_query_stats_get_run(stmt);
+	if(run != NULL)
+		run->materialized++;
+
+	pthread_mutex_unlock(&g_stats_mutex);
+}
+
+/* Adds the run of the statement to its query. Called before the statement is reset or finalized */
+void _media_query_stats_finish(sqlite3_stmt *stmt)
+{
+	query_stats_run_s *run = NULL;
+	query_stats_shape_s *shape = NULL;
+	const char *sql = NULL;
+	char *key = NULL;
+	int slot = 0;
+
+	if(!g_atomic_int_get(&g_stats_enabled))
+		return;
+
+	pthread_mutex_lock(&g_stats_mutex);
+
+	run = __media_query_stats_get_run(stmt);
+	sql = sqlite3_sql(stmt);
+
+	if(run != NULL && STRING_VALID(sql))
+	{
+		if(g_stats_shapes == NULL)
+			g_stats_shapes = g_hash_table_new_full(g_str_hash, g_str_equal, free, free);
+
+		shape = (query_stats_shape_s*)g_hash_table_lookup(g_stats_shapes, sql);
+
+		/* Conditions are written into the SQL, so the number of queries is capped */
+		if(shape == NULL && g_hash_table_size(g_stats_shapes) < QUERY_STATS_MAX_QUERIES)
+		{
+			shape = (query_stats_shape_s*)calloc(1, sizeof(query_stats_shape_s));
+			if(shape != NULL)
+			{
+				key = strdup(sql);
+				if(key != NULL)
+				{
+					g_hash_table_insert(g_stats_shapes, key, shape);
+				}
+				else
+				{
+					SAFE_FREE(shape);
+				}
+			}
+		}
+
+		if(shape != NULL)
+		{
+			slot = shape->count % QUERY_STATS_SAMPLE_COUNT;
+			shape->prepare_samples[slot] = run->prepare_ns;
+			shape->step_samples[slot] = run->step_ns;
+
+			shape->count++;
+			shape->prepare_ns += run->prepare_ns;
+			shape->step_ns += run->step_ns;
+			shape->rows += run->rows;
+			shape->materialized += run->materialized;
+		}
+	}
+
+	if(run != NULL)
+		g_hash_table_remove(g_stats_runs, stmt);
+
+	pthread_mutex_unlock(&g_stats_mutex);
+}
+
+int media_content_enable_stats(void)
+{
+	media_content_debug_func();
+
+	g_atomic_int_set(&g_stats_enabled, 1);
+
+	return MEDIA_CONTENT_ERROR_NONE;
+}
+
+int media_content_disable_stats(void)
+{
+	media_content_debug_func();
+
+	g_atomic_int_set(&g_stats_enabled, 0);
+
+	/* Statements which are still running are not counted. The statistics stay readable */
+	pthread_mutex_lock(&g_stats_mutex);
+	__media_query_stats_clear(FALSE);
+	pthread_mutex_unlock(&g_stats_mutex);
+
+	return MEDIA_CONTENT_ERROR_NONE;
+}
+
+int media_content_reset_stats(void)
+{
+	media_content_debug_func();
+
+	pthread_mutex_lock(&g_stats_mutex);
+	__media_query_stats_clear(TRUE);
+	pthread_mutex_unlock(&g_stats_mutex);
+
+	return MEDIA_CONTENT_ERROR_NONE;
+}
+
+int media_content_get_stats(media_content_stats_cb callback, void *user_data)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	int count = 0;
+	int idx = 0;
+	GHashTableIter iter;
+	gpointer key = NULL;
+	gpointer value = NULL;
+	query_stats_shape_s *shape = NULL;
+	query_stats_copy_s *copies = NULL;
+
+	if(callback == NULL)
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+
+	/* The callback may run queries, so it is called on a copy, outside of the lock */
+	pthread_mutex_lock(&g_stats_mutex);
+
+	if(g_stats_shapes != NULL && g_hash_table_size(g_stats_shapes) > 0)
+	{
+		copies = (query_stats_copy_s*)calloc(g_hash_table_size(g_stats_shapes), sizeof(query_stats_copy_s));
+		if(copies == NULL)
+		{
+			media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
+			ret = MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
+		}
+		else
+		{
+			g_hash_table_iter_init(&iter, g_stats_shapes);
+			while(g_hash_table_iter_next(&iter, &key, &value))
+			{
+				shape = (query_stats_shape_s*)value;
+
+				copies[count].query = strdup((const char *)key);
+				if(copies[count].query == NULL)
+				{
+					media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
+					ret = MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
+					break;
+				}
+
+				copies[count].stats.count = shape->count;
+				copies[count].stats.prepare_total = shape->prepare_ns / 1000;
+				copies[count].stats.prepare_avg = shape->prepare_ns / 1000 / shape->count;
+				copies[count].stats.prepare_p99 = __media_query_stats_p99(shape->prepare_samples, shape->count) / 1000;
+				copies[count].stats.step_total = shape->step_ns / 1000;
+				copies[count].stats.step_avg = shape->step_ns / 1000 / shape->count;
+				copies[count].stats.step_p99 = __media_query_stats_p99(shape->step_samples, shape->count) / 1000;
+				copies[count].stats.rows_returned = shape->rows;
+				copies[count].stats.rows_materialized = shape->materialized;
+				count++;
+			}
+		}
+	}
+
+	pthread_mutex_unlock(&g_stats_mutex);
+
+	for(idx = 0; ret == MEDIA_CONTENT_ERROR_NONE && idx < count; idx++)
+	{
+		if(callback(copies[idx].query, &copies[idx].stats, user_data) == false)
+			break;
+	}
+
+	for(idx = 0; idx < count; idx++)
+		SAFE_FREE(copies[idx].query);
+	SAFE_FREE(copies);
+
+	return ret;
+}
@@ -0,0 +1,324 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include <media_info_private.h>
+
+
+static char *__media_stmt_cache_normalize(const char *query);
+static void __media_stmt_cache_item_free(stmt_cache_item_s *item);
+static void __media_stmt_cache_touch(stmt_cache_s *cache, stmt_cache_item_s *item);
+static bool __media_stmt_cache_evict(stmt_cache_s *cache);
+static int __media_stmt_cache_prepare_stmt(sqlite3 *db, const char *query, sqlite3_stmt **stmt);
+
+/* Collapse whitespace runs outside of quoted literals and trim both ends, so that
+ * queries which only differ in the padding added by _content_query_prepare() share one entry. */
+static char *__media_stmt_cache_normalize(const char *query)
+{
+	char *normalized = NULL;
+	char *dst = NULL;
+	const char *src = query;
+	char quote = '\0';
+	bool pending_space = FALSE;
+
+	normalized = (char*)calloc(strlen(query) + 1, sizeof(char));
+	if(normalized == NULL)
+		return NULL;
+
+	dst = normalized;
+
+	while(*src == ' ' || *src == '\t' || *src == '\n')
+		src++;
+
+	for(; *src != '\0'; src++)
+	{
+		if(quote != '\0')
+		{
+			if(*src == quote)
+				quote = '\0';
+
+			*dst++ = *src;
+			continue;
+		}
+
+		if(*src == ' ' || *src == '\t' || *src == '\n')
+		{
+			pending_space = TRUE;
+			continue;
+		}
+
+		if(pending_space)
+		{
+			*dst++ = ' ';
+			pending_space = FALSE;
+		}
+
+		if(*src == '\'' || *src == '"')
+			quote = *src;
+
+		*dst++ = *src;
+	}
+
+	*dst = '\0';
+
+	return normalized;
+}
+
+static void __media_stmt_cache_item_free(stmt_cache_item_s *item)
+{
+	if(item != NULL)
+	{
+		SAFE_FREE(item->query);
+		if(item->stmt != NULL)
+			sqlite3_finalize(item->stmt);
+		SAFE_FREE(item);
+	}
+}
+
+static void __media_stmt_cache_touch(stmt_cache_s *cache, stmt_cache_item_s *item)
+{
+	if(cache->lru_list == item->link)
+		return;
+
+	cache->lru_list = g_list_remove_link(cache->lru_list, item->link);
+	cache->lru_list = g_list_concat(item->link, cache->lru_list);
+}
+
+/* Drop the least recently used statement which is not handed out right now. */
+static bool __media_stmt_cache_evict(stmt_cache_s *cache)
+{
+	GList *iter = NULL;
+	stmt_cache_item_s *item = NULL;
+
+	for(iter = g_list_last(cache->lru_list); iter != NULL; iter = iter->prev)
+	{
+		item = (stmt_cache_item_s*)iter->data;
+
+		if(!item->in_use)
+		{
+			g_hash_table_remove(cache->query_map, item->query);
+			g_hash_table_remove(cache->stmt_map, item->stmt);
+			cache->lru_list = g_list_delete_link(cache->lru_list, iter);
+			__media_stmt_cache_item_free(item);
+
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+static int __media_stmt_cache_prepare_stmt(sqlite3 *db, const char *query, sqlite3_stmt **stmt)
+{
+	int err = SQLITE_OK;
+
+	err = sqlite3_prepare_v2(db, query, strlen(query), stmt, NULL);
+	if(err != SQLITE_OK)
+	{
+		media_content_error("DB_FAILED(0x%08x) fail to sqlite3_prepare(), %s", MEDIA_CONTENT_ERROR_DB_FAILED, sqlite3_errmsg(db));
+
+		if(err == SQLITE_BUSY)
+			return MEDIA_CONTENT_ERROR_DB_BUSY;
+		else
+			return MEDIA_CONTENT_ERROR_DB_FAILED;
+	}
+
+	return MEDIA_CONTENT_ERROR_NONE;
+}
+
+/* Statements which are stepped outside of the calling thread or for a long time (cursors)
+ * are not shared through a cache; _content_query_finalize() finalizes them. */
+int _content_stmt_prepare(sqlite3 *db, const char *query, sqlite3_stmt **stmt)
+{
+	if(db == NULL || !STRING_VALID(query) || stmt == NULL)
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+
+	return __media_stmt_cache_prepare_stmt(db, query, stmt);
+}
+
+int _content_stmt_cache_create(sqlite3 *db, int capacity, stmt_cache_h *cache)
+{
+	stmt_cache_s *_cache = NULL;
+
+	if(db == NULL || capacity <= 0 || cache == NULL)
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+
+	_cache = (stmt_cache_s*)calloc(1, sizeof(stmt_cache_s));
+	if(_cache == NULL)
+	{
+		media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
+		return MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
+	}
+
+	_cache->db = db;
+	_cache->capacity = capacity;
+	_cache->query_map = g_hash_table_new(g_str_hash, g_str_equal);
+	_cache->stmt_map = g_hash_table_new(g_direct_hash, g_direct_equal);
+
+	*cache = (stmt_cache_h)_cache;
+
+	return MEDIA_CONTENT_ERROR_NONE;
+}
+
+int _content_stmt_cache_destroy(stmt_cache_h cache)
+{
+	GList *iter = NULL;
+	stmt_cache_item_s *item = NULL;
+	stmt_cache_s *_cache = (stmt_cache_s*)cache;
+
+	if(_cache == NULL)
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+
+	media_content_debug("statement cache hit : %u miss : %u", _cache->hit_count, _cache->miss_count);
+
+	for(iter = _cache->lru_list; iter != NULL; iter = iter->next)
+	{
+		item = (stmt_cache_item_s*)iter->data;
+
+		/* Still being stepped; the holder finalizes it, since it is no longer found in any cache */
+		if(item->in_use)
+			item->stmt = NULL;
+
+		__media_stmt_cache_item_free(item);
+	}
+
+	g_list_free(_cache->lru_list);
+	g_hash_table_destroy(_cache->query_map);
+	g_hash_table_destroy(_cache->stmt_map);
+	SAFE_FREE(_cache);
+
+	return MEDIA_CONTENT_ERROR_NONE;
+}
+
+int _content_stmt_cache_prepare(stmt_cache_h cache, const char *query, sqlite3_stmt **stmt)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	char *normalized = NULL;
+	stmt_cache_item_s *item = NULL;
+	stmt_cache_s *_cache = (stmt_cache_s*)cache;
+
+	if(_cache == NULL || !STRING_VALID(query) || stmt == NULL)
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+
+	normalized = __media_stmt_cache_normalize(query);
+	if(normalized == NULL)
+	{
+		media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
+		return MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
+	}
+
+	item = (stmt_cache_item_s*)g_hash_table_lookup(_cache->query_map, normalized);
+	if(item != NULL && !item->in_use)
+	{
+		_cache->hit_count++;
+		item->in_use = TRUE;
+		__media_stmt_cache_touch(_cache, item);
+		*stmt = item->stmt;
+		SAFE_FREE(normalized);
+
+		return MEDIA_CONTENT_ERROR_NONE;
+	}
+
+	_cache->miss_count++;
+
+	ret = __media_stmt_cache_prepare_stmt(_cache->db, normalized, stmt);
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+	{
+		SAFE_FREE(normalized);
+		return ret;
+	}
+
+	/* The same shape is still being stepped by an outer caller (e.g. a nested
+	 * query from a foreach callback); hand out a private statement instead. */
+	if(item != NULL)
+	{
+		SAFE_FREE(normalized);
+		return MEDIA_CONTENT_ERROR_NONE;
+	}
+
+	if((int)g_hash_table_size(_cache->query_map) >= _cache->capacity)
+	{
+		if(!__media_stmt_cache_evict(_cache))
+		{
+			SAFE_FREE(normalized);
+			return MEDIA_CONTENT_ERROR_NONE;
+		}
+	}
+
+	item = (stmt_cache_item_s*)calloc(1, sizeof(stmt_cache_item_s));
+	if(item == NULL)
+	{
+		/* Not fatal, the statement is simply not cached */
+		SAFE_FREE(normalized);
+		return MEDIA_CONTENT_ERROR_NONE;
+	}
+
+	item->query = normalized;
+	item->stmt = *stmt;
+	item->in_use = TRUE;
+
+	_cache->lru_list = g_list_prepend(_cache->lru_list, item);
+	item->link = _cache->lru_list;
+	g_hash_table_insert(_cache->query_map, item->query, item);
+	g_hash_table_insert(_cache->stmt_map, item->stmt, item);
+
+	return MEDIA_CONTENT_ERROR_NONE;
+}
+
+void _content_stmt_cache_release(stmt_cache_h cache, sqlite3_stmt *stmt)
+{
+	stmt_cache_item_s *item = NULL;
+	stmt_cache_s *_cache = (stmt_cache_s*)cache;
+
+	if(stmt == NULL)
+		return;
+
+	if(_cache != NULL)
+		item = (stmt_cache_item_s*)g_hash_table_lookup(_cache->stmt_map, stmt);
+
+	if(item == NULL)
+	{
+		sqlite3_finalize(stmt);
+		return;
+	}
+
+	sqlite3_reset(stmt);
+	sqlite3_clear_bindings(stmt);
+	item->in_use = FALSE;
+}
+
+void _content_stmt_cache_get_stats(stmt_cache_h cache, unsigned int *hit_count, unsigned int *miss_count)
+{
+	stmt_cache_s *_cache = (stmt_cache_s*)cache;
+
+	if(hit_count != NULL)
+		*hit_count = (_cache != NULL) ? _cache->hit_count : 0;
+
+	if(miss_count != NULL)
+		*miss_count = (_cache != NULL) ? _cache->miss_count : 0;
+}
@@ -19,81 +19,119 @@
 #include <media_info_private.h>
 
 
-static __thread GList *g_tag_item_list = NULL;
-
-static void __media_tag_item_add(media_tag_item_s *item_s);
-static void __media_tag_item_release(void);
-static int __media_tag_insert_item_to_tag(int tag_id, const char *media_id);
-static int __media_tag_remove_item_from_tag(int tag_id, const char *media_id);
-static int __media_tag_update_tag_name(int tag_id, const char *tag_name);
+static int __media_tag_item_add(media_tag_s *tag, int function, const char *media_id, const char *tag_name);
+static void __media_tag_item_release(media_tag_s *tag);
+static int __media_tag_apply_item(int tag_id, media_tag_item_s *item, sqlite3_stmt **stmts);
 static int __media_tag_get_tag_info_from_db(const char *name, media_tag_h tag);
 
-static void __media_tag_item_add(media_tag_item_s *item_s)
-{
-	g_tag_item_list = g_list_append(g_tag_item_list, item_s);
-}
+/* Indexed by tag_function_e */
+static const char *g_tag_item_query[MEDIA_TAG_FUNCTION_MAX] = {
+	INSERT_TAG_ITEM_TO_TAG_MAP,
+	REMOVE_TAG_ITEM_FROM_TAG_MAP,
+	UPDATE_TAG_NAME_FROM_TAG,
+};
 
-static void __media_tag_item_release(void)
+static int __media_tag_item_add(media_tag_s *tag, int function, const char *media_id, const char *tag_name)
 {
-	int idx = 0;
-	int list_cnt = 0;
+	int size = 0;
+	media_tag_item_s *items = NULL;
 	media_tag_item_s *item = NULL;
 
-	list_cnt = g_list_length(g_tag_item_list);
-
-	media_content_debug("list_cnt : [%d]", list_cnt);
-
-	for(idx = 0; idx < list_cnt; idx++)
+	if(tag->item_count == tag->item_size)
 	{
-		item = (media_tag_item_s*)g_list_nth_data(g_tag_item_list, idx);
-		if(item != NULL)
+		size = (tag->item_size > 0) ? tag->item_size * 2 : MEDIA_CONTENT_PENDING_ITEM_SIZE;
+		items = (media_tag_item_s*)realloc(tag->items, size * sizeof(media_tag_item_s));
+		if(items == NULL)
 		{
-			SAFE_FREE(item->media_id);
-			SAFE_FREE(item->tag_name);
-			SAFE_FREE(item);
+			media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
+			return MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
 		}
+
+		tag->items = items;
+		tag->item_size = size;
 	}
 
-	g_list_free(g_tag_item_list);
-	g_tag_item_list = NULL;
+	item = &tag->items[tag->item_count];
+	memset(item, 0x00, sizeof(media_tag_item_s));
+	item->function = function;
 
-}
+	if(STRING_VALID(media_id))
+		item->media_id = strdup(media_id);
+	if(STRING_VALID(tag_name))
+		item->tag_name = strdup(tag_name);
 
-static int __media_tag_insert_item_to_tag(int tag_id, const char *media_id)
-{
-	int ret = MEDIA_CONTENT_ERROR_NONE;
-	char *query_str = NULL;
+	if((STRING_VALID(media_id) && item->media_id == NULL) || (STRING_VALID(tag_name) && item->tag_name == NULL))
+	{
+		SAFE_FREE(item->media_id);
+		SAFE_FREE(item->tag_name);
+		media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
+		return MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
+	}
 
-	query_str = sqlite3_mprintf("INSERT INTO %q (tag_id, media_uuid) values (%d, '%q')",
-			DB_TABLE_TAG_MAP, tag_id, media_id);
-	ret = _content_query_sql(query_str);
-	sqlite3_free(query_str);
+	tag->item_count++;
 
-	return ret;
+	return MEDIA_CONTENT_ERROR_NONE;
 }
 
-static int __media_tag_remove_item_from_tag(int tag_id, const char *media_id)
+static void __media_tag_item_release(media_tag_s *tag)
 {
-	int ret = MEDIA_CONTENT_ERROR_NONE;
-	char *query_str = NULL;
+	int idx = 0;
 
-	query_str = sqlite3_mprintf(REMOVE_TAG_ITEM_FROM_TAG_MAP, tag_id, media_id);
+	media_content_debug("list_cnt : [%d]", tag->item_count);
 
-	ret = _content_query_sql(query_str);
-	sqlite3_free(query_str);
+	for(idx = 0; idx < tag->item_count; idx++)
+	{
+		SAFE_FREE(tag->items[idx].media_id);
+		SAFE_FREE(tag->items[idx].tag_name);
+	}
 
-	return ret;
+	SAFE_FREE(tag->items);
+	tag->item_count = 0;
+	tag->item_size = 0;
 }
 
-static int __media_tag_update_tag_name(int tag_id, const char *tag_name)
+/* Statements are prepared on first use and kept in stmts for the rest of the batch */
+static int __media_tag_apply_item(int tag_id, media_tag_item_s *item, sqlite3_stmt **stmts)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
-	char *query_str = NULL;
+	sqlite3_stmt *stmt = NULL;
+
+	if(item->function < 0 || item->function >= MEDIA_TAG_FUNCTION_MAX)
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
 
-	query_str = sqlite3_mprintf(UPDATE_TAG_NAME_FROM_TAG, tag_name, tag_id);
+	if(stmts[item->function] == NULL)
+	{
+		ret = _content_query_prepare_str(&stmts[item->function], g_tag_item_query[item->function]);
+		media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
+	}
 
-	ret = _content_query_sql(query_str);
-	sqlite3_free(query_str);
+	stmt = stmts[item->function];
+	sqlite3_reset(stmt);
+
+	switch(item->function) {
+		case MEDIA_TAG_ADD:
+		case MEDIA_TAG_REMOVE:
+		{
+			ret = _content_query_bind_int(stmt, 1, tag_id);
+			if(ret == MEDIA_CONTENT_ERROR_NONE)
+				ret = _content_query_bind_text(stmt, 2, item->media_id);
+		}
+		break;
+
+		case MEDIA_TAG_UPDATE_TAG_NAME:
+		{
+			ret = _content_query_bind_text(stmt, 1, item->tag_name);
+			if(ret == MEDIA_CONTENT_ERROR_NONE)
+				ret = _content_query_bind_int(stmt, 2, tag_id);
+		}
+		break;
+	}
+
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = _content_query_step_done(stmt);
 
 	return ret;
 }
@@ -117,7 +155,7 @@ static int __media_tag_get_tag_info_from_db(const char *name, media_tag_h tag)
 	sqlite3_free(select_query);
 	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
 
-	while(sqlite3_step(stmt) == SQLITE_ROW)
+	while(_content_query_step(stmt) == SQLITE_ROW)
 	{
 		_tag->tag_id = (int)sqlite3_column_int(stmt,0);
 
@@ -219,6 +257,23 @@ int media_tag_foreach_tag_from_db (filter_h filter, media_tag_cb callback, void
 	return ret;
 }
 
+int media_tag_foreach_tag_with_count_from_db(filter_h filter, media_tag_count_cb callback, void *user_data)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+
+	media_content_debug_func();
+
+	if(callback == NULL)
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+
+	ret = _media_db_get_tag_with_count(filter, callback, user_data);
+
+	return ret;
+}
+
 int media_tag_get_media_count_from_db(int tag_id, filter_h filter, int *media_count)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
@@ -261,6 +316,7 @@ int media_tag_destroy(media_tag_h tag)
 	media_tag_s *_tag = (media_tag_s*)tag;
 	if(_tag)
 	{
+		__media_tag_item_release(_tag);
 		SAFE_FREE(_tag->name);
 		SAFE_FREE(_tag);
 		ret = MEDIA_CONTENT_ERROR_NONE;
@@ -382,7 +438,7 @@ int media_tag_get_tag_from_db(int tag_id, media_tag_h *tag)
 	ret = _content_query_prepare(&stmt, select_query, NULL, NULL);
 	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
 
-	while(sqlite3_step(stmt) == SQLITE_ROW)
+	while(_content_query_step(stmt) == SQLITE_ROW)
 	{
 		media_tag_s *_tag = (media_tag_s*)calloc(1, sizeof(media_tag_s));
 
@@ -415,18 +471,7 @@ int media_tag_add_media(media_tag_h tag, const char *media_id)
 
 	if((_tag != NULL) && STRING_VALID(media_id))
 	{
-		media_tag_item_s *_item = (media_tag_item_s*)calloc(1, sizeof(media_tag_item_s));
-
-		_item->media_id = strdup(media_id);
-		_item->function = MEDIA_TAG_ADD;
-
-		if(_item->media_id == NULL)
-		{
-			media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
-			return MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
-		}
-
-		__media_tag_item_add(_item);
+		ret = __media_tag_item_add(_tag, MEDIA_TAG_ADD, media_id, NULL);
 	}
 	else
 	{
@@ -444,18 +489,7 @@ int media_tag_remove_media(media_tag_h tag, const char *media_id)
 
 	if(_tag != NULL && STRING_VALID(media_id))
 	{
-		media_tag_item_s *_item = (media_tag_item_s*)calloc(1, sizeof(media_tag_item_s));
-
-		_item->media_id = strdup(media_id);
-		_item->function = MEDIA_TAG_REMOVE;
-
-		if(_item->media_id == NULL)
-		{
-			media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
-			return MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
-		}
-
-		__media_tag_item_add(_item);
+		ret = __media_tag_item_add(_tag, MEDIA_TAG_REMOVE, media_id, NULL);
 	}
 	else
 	{
@@ -473,27 +507,16 @@ int media_tag_set_name(media_tag_h tag, char *tag_name)
 
 	if(_tag != NULL && STRING_VALID(tag_name))
 	{
-		SAFE_FREE(_tag->name);
-
-		media_tag_item_s *_item = (media_tag_item_s*)calloc(1, sizeof(media_tag_item_s));
-
-		_item->tag_name = strdup(tag_name);
-		_item->function = MEDIA_TAG_UPDATE_TAG_NAME;
-
-		if(_item->tag_name == NULL)
-		{
-			media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
-			return MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
-		}
+		ret = __media_tag_item_add(_tag, MEDIA_TAG_UPDATE_TAG_NAME, NULL, tag_name);
+		media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
 
+		SAFE_FREE(_tag->name);
 		_tag->name = strdup(tag_name);
 		if(_tag->name == NULL)
 		{
 			media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
 			return MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
 		}
-
-		__media_tag_item_add(_item);
 	}
 	else
 	{
@@ -505,12 +528,17 @@ int media_tag_set_name(media_tag_h tag, char *tag_name)
 }
 
 int media_tag_update_to_db(media_tag_h tag)
+{
+	return media_tag_update_to_db_with_count(tag, NULL);
+}
+
+int media_tag_update_to_db_with_count(media_tag_h tag, int *applied_count)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
 	media_tag_s *_tag = (media_tag_s*)tag;
+	sqlite3_stmt *stmts[MEDIA_TAG_FUNCTION_MAX];
 	int idx = 0;
-	int length = 0;
-	media_tag_item_s *_tag_item = NULL;
+	int count = 0;
 
 	if(_tag == NULL)
 	{
@@ -518,34 +546,42 @@ int media_tag_update_to_db(media_tag_h tag)
 		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
 	}
 
-	length = g_list_length(g_tag_item_list);
-
-	for (idx = 0; idx < length; idx++) {
-		_tag_item = (media_tag_item_s*)g_list_nth_data(g_tag_item_list, idx);
-		if(_tag_item != NULL) {
-			switch(_tag_item->function) {
-				case MEDIA_TAG_ADD:
-				{
-					ret = __media_tag_insert_item_to_tag(_tag->tag_id, _tag_item->media_id);
-				}
-				break;
-
-				case MEDIA_TAG_REMOVE:
-				{
-					ret = __media_tag_remove_item_from_tag(_tag->tag_id, _tag_item->media_id);
-				}
-				break;
-
-				case MEDIA_TAG_UPDATE_TAG_NAME:
-				{
-					ret = __media_tag_update_tag_name(_tag->tag_id, _tag_item->tag_name);
-				}
-				break;
-			}
-		}
+	if(applied_count != NULL)
+		*applied_count = 0;
+
+	if(_tag->item_count == 0)
+		return MEDIA_CONTENT_ERROR_NONE;
+
+	memset(stmts, 0x00, sizeof(stmts));
+
+	ret = _content_transaction_begin();
+	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
+
+	for(count = 0; count < _tag->item_count; count++)
+	{
+		ret = __media_tag_apply_item(_tag->tag_id, &_tag->items[count], stmts);
+		if(ret != MEDIA_CONTENT_ERROR_NONE)
+			break;
 	}
 
-	__media_tag_item_release();
+	for(idx = 0; idx < MEDIA_TAG_FUNCTION_MAX; idx++)
+	{
+		SQLITE3_FINALIZE(stmts[idx]);
+	}
+
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = _content_transaction_commit();
+	else
+		_content_transaction_rollback();
+
+	/* A rolled back batch stays pending, so it can be fixed up and applied again */
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+	{
+		if(applied_count != NULL)
+			*applied_count = count;
+
+		__media_tag_item_release(_tag);
+	}
 
 	return ret;
 }
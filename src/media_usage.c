@@ -0,0 +1,308 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include <media_content.h>
+#include <media_info_private.h>
+
+
+typedef struct
+{
+	int ref;							// the cache and every foreach reading the table
+	long long version;					// usage version the rows were read at
+	int count;
+	media_content_usage_s *rows;		// mime_type of every row is allocated
+}usage_table_s;
+
+/* Set on connect and by enable/disable. Another process may drop the version meanwhile,
+ * so a failed version query falls back to reading the usage and clears it.
+ * Read by every usage query from any thread, so it is only accessed atomically. */
+static gint g_usage_cache_enabled = 0;
+static pthread_mutex_t g_usage_mutex = PTHREAD_MUTEX_INITIALIZER;
+static usage_table_s *g_usage_cache = NULL;
+
+static void __media_usage_unref(usage_table_s *table);
+static void __media_usage_set_cache(usage_table_s *table);
+static int __media_usage_get_version(long long *version);
+static int __media_usage_read(filter_h filter, usage_table_s **table);
+
+static void __media_usage_unref(usage_table_s *table)
+{
+	int idx = 0;
+	int ref = 0;
+
+	pthread_mutex_lock(&g_usage_mutex);
+	ref = --table->ref;
+	pthread_mutex_unlock(&g_usage_mutex);
+
+	if(ref > 0)
+		return;
+
+	for(idx = 0; idx < table->count; idx++)
+		free((char *)table->rows[idx].mime_type);
+
+	SAFE_FREE(table->rows);
+	SAFE_FREE(table);
+}
+
+/* Replaces the cached table, NULL drops it */
+static void __media_usage_set_cache(usage_table_s *table)
+{
+	usage_table_s *old = NULL;
+
+	pthread_mutex_lock(&g_usage_mutex);
+
+	old = g_usage_cache;
+	g_usage_cache = table;
+	if(table != NULL)
+		table->ref++;
+
+	pthread_mutex_unlock(&g_usage_mutex);
+
+	if(old != NULL)
+		__media_usage_unref(old);
+}
+
+static int __media_usage_get_version(long long *version)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	sqlite3_stmt *stmt = NULL;
+
+	ret = _content_query_prepare_str(&stmt, SELECT_USAGE_VERSION);
+	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
+
+	if(_content_query_step(stmt) == SQLITE_ROW)
+	{
+		*version = sqlite3_column_int64(stmt, 0);
+	}
+	else
+	{
+		media_content_error("DB_FAILED(0x%08x) no usage version", MEDIA_CONTENT_ERROR_DB_FAILED);
+		ret = MEDIA_CONTENT_ERROR_DB_FAILED;
+	}
+
+	SQLITE3_FINALIZE(stmt);
+
+	return ret;
+}
+
+/* One GROUP BY over the media of the filter, into a table with a single reference */
+static int __media_usage_read(filter_h filter, usage_table_s **table)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	int err = SQLITE_OK;
+	int size = 0;
+	query_builder_s query;
+	sqlite3_stmt *stmt = NULL;
+	usage_table_s *_table = NULL;
+	media_content_usage_s *rows = NULL;
+	media_content_usage_s *row = NULL;
+
+	_content_query_builder_init(&query);
+	_content_query_builder_append(&query, SELECT_MEDIA_USAGE);
+
+	ret = _media_filter_attribute_append_group_query(_content_get_attirbute_handle(), filter, MEDIA_USAGE_GROUP_BY, &query);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = _content_query_builder_prepare(&query, &stmt);
+
+	_content_query_builder_release(&query);
+	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
+
+	_table = (usage_table_s*)calloc(1, sizeof(usage_table_s));
+	if(_table == NULL)
+	{
+		SQLITE3_FINALIZE(stmt);
+		media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
+		return MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
+	}
+
+	_table->ref = 1;
+
+	while((err = _content_query_step(stmt)) == SQLITE_ROW)
+	{
+		if(_table->count == size)
+		{
+			size = (size > 0) ? size * 2 : 16;
+			rows = (media_content_usage_s*)realloc(_table->rows, size * sizeof(media_content_usage_s));
+			if(rows == NULL)
+			{
+				media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
+				ret = MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
+				break;
+			}
+			_table->rows = rows;
+		}
+
+		row = &_table->rows[_table->count];
+		row->storage_type = (media_content_storage_e)sqlite3_column_int(stmt, 0);
+		row->media_type = (media_content_type_e)sqlite3_column_int(stmt, 1);
+		row->mime_type = NULL;
+		if(sqlite3_column_type(stmt, 2) != SQLITE_NULL)
+		{
+			row->mime_type = strdup((const char *)sqlite3_column_text(stmt, 2));
+			if(row->mime_type == NULL)
+			{
+				media_content_error("OUT_OF_MEMORY(0x%08x)", MEDIA_CONTENT_ERROR_OUT_OF_MEMORY);
+				ret = MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
+				break;
+			}
+		}
+		row->media_count = sqlite3_column_int(stmt, 3);
+		row->total_size = (unsigned long long)sqlite3_column_int64(stmt, 4);
+
+		/* Counted once complete, so the unref of a failed read frees only what was set */
+		_table->count++;
+	}
+
+	if(ret == MEDIA_CONTENT_ERROR_NONE && err != SQLITE_DONE)
+	{
+		media_content_error("DB_FAILED(0x%08x) fail to sqlite3_step(), %s", MEDIA_CONTENT_ERROR_DB_FAILED, sqlite3_errmsg(sqlite3_db_handle(stmt)));
+		ret = MEDIA_CONTENT_ERROR_DB_FAILED;
+	}
+
+	SQLITE3_FINALIZE(stmt);
+
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+	{
+		__media_usage_unref(_table);
+		return ret;
+	}
+
+	*table = _table;
+
+	return MEDIA_CONTENT_ERROR_NONE;
+}
+
+void _media_usage_load(void)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	sqlite3_stmt *stmt = NULL;
+	int count = 0;
+
+	/* The database may have been recreated since the usage was cached */
+	__media_usage_set_cache(NULL);
+
+	ret = _content_query_prepare_str(&stmt, SELECT_USAGE_VERSION_OBJECT_COUNT);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+	{
+		if(_content_query_step(stmt) == SQLITE_ROW)
+			count = sqlite3_column_int(stmt, 0);
+		SQLITE3_FINALIZE(stmt);
+	}
+
+	g_atomic_int_set(&g_usage_cache_enabled, (count == USAGE_VERSION_OBJECT_COUNT) ? 1 : 0);
+
+	media_content_debug("usage cache : %s", g_atomic_int_get(&g_usage_cache_enabled) ? "enabled" : "disabled");
+}
+
+int media_info_foreach_usage_from_db(filter_h filter, media_content_usage_cb callback, void *user_data)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	int idx = 0;
+	long long version = 0;
+	bool cached = FALSE;
+	usage_table_s *table = NULL;
+
+	media_content_debug_func();
+
+	if(callback == NULL)
+	{
+		media_content_error("INVALID_PARAMETER(0x%08x)", MEDIA_CONTENT_ERROR_INVALID_PARAMETER);
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+
+	/* The version is read before the usage, so a change made in between is seen on the next call */
+	if(filter == NULL && g_atomic_int_get(&g_usage_cache_enabled))
+	{
+		if(__media_usage_get_version(&version) == MEDIA_CONTENT_ERROR_NONE)
+		{
+			cached = TRUE;
+
+			pthread_mutex_lock(&g_usage_mutex);
+			if(g_usage_cache != NULL && g_usage_cache->version == version)
+			{
+				table = g_usage_cache;
+				table->ref++;
+			}
+			pthread_mutex_unlock(&g_usage_mutex);
+		}
+		else
+		{
+			/* The version was dropped by another process */
+			g_atomic_int_set(&g_usage_cache_enabled, 0);
+			__media_usage_set_cache(NULL);
+		}
+	}
+
+	if(table == NULL)
+	{
+		ret = __media_usage_read(filter, &table);
+		media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
+
+		if(cached)
+		{
+			table->version = version;
+			__media_usage_set_cache(table);
+		}
+	}
+
+	for(idx = 0; idx < table->count; idx++)
+	{
+		if(callback(&table->rows[idx], user_data) == false)
+			break;
+	}
+
+	__media_usage_unref(table);
+
+	return ret;
+}
+
+int media_content_enable_usage_cache(void)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+
+	media_content_debug_func();
+
+	ret = _content_transaction_begin();
+	media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
+
+	ret = _content_query_sql(CREATE_USAGE_VERSION);
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+	{
+		_content_transaction_rollback();
+		return ret;
+	}
+
+	ret = _content_transaction_commit();
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		g_atomic_int_set(&g_usage_cache_enabled, 1);
+
+	return ret;
+}
+
+int media_content_disable_usage_cache(void)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+
+	media_content_debug_func();
+
+	g_atomic_int_set(&g_usage_cache_enabled, 0);
+	__media_usage_set_cache(NULL);
+
+	ret = _content_query_sql(DROP_USAGE_VERSION);
+
+	return ret;
+}
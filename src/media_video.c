@@ -709,13 +709,24 @@ int video_meta_update_to_db(video_meta_h video)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
 	video_meta_s *_video = (video_meta_s*)video;
-	char *sql = NULL;
+	sqlite3_stmt *stmt = NULL;
 
 	if(_video != NULL && STRING_VALID(_video->media_id))
 	{
-		sql = sqlite3_mprintf(UPDATE_AV_META_FROM_MEDIA, _video->played_count, _video->played_time, _video->played_position, _video->media_id);
-		ret = _content_query_sql(sql);
-		sqlite3_free(sql);
+		ret = _content_query_prepare(&stmt, UPDATE_AV_META_FROM_MEDIA, NULL, NULL);
+		media_content_retv_if(ret != MEDIA_CONTENT_ERROR_NONE, ret);
+
+		ret = _content_query_bind_int(stmt, 1, _video->played_count);
+		if(ret == MEDIA_CONTENT_ERROR_NONE)
+			ret = _content_query_bind_int(stmt, 2, _video->played_time);
+		if(ret == MEDIA_CONTENT_ERROR_NONE)
+			ret = _content_query_bind_int(stmt, 3, _video->played_position);
+		if(ret == MEDIA_CONTENT_ERROR_NONE)
+			ret = _content_query_bind_text(stmt, 4, _video->media_id);
+		if(ret == MEDIA_CONTENT_ERROR_NONE)
+			ret = _content_query_step_done(stmt);
+
+		SQLITE3_FINALIZE(stmt);
 	}
 	else
 	{
@@ -0,0 +1,811 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/*
+ * Benchmark on a generated library.
+ *
+ *   media-content_bench [-n media_count] [-r repeat] [-o db_path] [-k]
+ *
+ * A media DB of media_count rows (10000 by default; 100000 and 1000000 are the other tracked sizes)
+ * is generated with a fixed seed, then the foreach, count, group, playlist and tag calls are timed
+ * and printed with their latency percentiles. -k reuses a DB generated by an earlier run.
+ *
+ * media_svc_connect() and media_svc_disconnect() below take the place of the ones of media-svc,
+ * since the library looks them up in the executable first. So the library runs on the generated DB
+ * instead of the one of the device.
+ */
+#include <sys/time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <media_content.h>
+#include <media_info_private.h>
+#include <dlog.h>
+#include <glib.h>
+
+#define BENCH_DEFAULT_MEDIA_COUNT	10000
+#define BENCH_DEFAULT_REPEAT		10
+#define BENCH_DEFAULT_DB_PATH		"/tmp/media-content-bench.db"
+#define BENCH_SEED					0x5eed5eedULL
+#define BENCH_PLAYLIST_COUNT		20
+#define BENCH_PLAYLIST_SIZE		200
+#define BENCH_PAGE_SIZE			100
+#define BENCH_COLUMNS_CAPACITY		1024
+
+/* Schema of the tables and views the library reads, close to the one of media-svc */
+static const char *g_bench_schema[] = {
+	"CREATE TABLE media (media_uuid TEXT PRIMARY KEY, path TEXT NOT NULL UNIQUE, file_name TEXT, media_type INTEGER, mime_type TEXT, \
+		size INTEGER DEFAULT 0, added_time INTEGER DEFAULT 0, modified_time INTEGER DEFAULT 0, folder_uuid TEXT NOT NULL, thumbnail_path TEXT, \
+		title TEXT, album_id INTEGER DEFAULT 0, album TEXT, artist TEXT, genre TEXT, composer TEXT, year TEXT, recorded_date TEXT, copyright TEXT, \
+		track_num TEXT, description TEXT, bitrate INTEGER DEFAULT -1, samplerate INTEGER DEFAULT -1, channel INTEGER DEFAULT -1, duration INTEGER DEFAULT -1, \
+		longitude DOUBLE DEFAULT 0, latitude DOUBLE DEFAULT 0, altitude DOUBLE DEFAULT 0, width INTEGER DEFAULT -1, height INTEGER DEFAULT -1, \
+		datetaken TEXT, orientation INTEGER DEFAULT -1, played_count INTEGER DEFAULT 0, last_played_time INTEGER DEFAULT 0, last_played_position INTEGER DEFAULT 0, \
+		rating INTEGER DEFAULT 0, favourite INTEGER DEFAULT 0, author TEXT, provider TEXT, content_name TEXT, category TEXT, location_tag TEXT, \
+		age_rating TEXT, keyword TEXT, is_drm INTEGER DEFAULT 0, storage_type INTEGER, validity INTEGER DEFAULT 1)",
+	"CREATE INDEX media_folder_uuid_idx ON media (folder_uuid)",
+	"CREATE INDEX media_media_type_idx ON media (media_type)",
+	"CREATE TABLE folder (folder_uuid TEXT PRIMARY KEY, path TEXT NOT NULL UNIQUE, name TEXT, modified_time INTEGER DEFAULT 0, storage_type INTEGER)",
+	"CREATE TABLE album (album_id INTEGER PRIMARY KEY AUTOINCREMENT, name TEXT NOT NULL, artist TEXT, album_art TEXT)",
+	"CREATE TABLE tag (tag_id INTEGER PRIMARY KEY AUTOINCREMENT, name TEXT NOT NULL UNIQUE)",
+	"CREATE TABLE tag_map (_id INTEGER PRIMARY KEY AUTOINCREMENT, tag_id INTEGER NOT NULL, media_uuid TEXT NOT NULL, UNIQUE (tag_id, media_uuid))",
+	"CREATE TABLE playlist (playlist_id INTEGER PRIMARY KEY AUTOINCREMENT, name TEXT NOT NULL UNIQUE)",
+	"CREATE TABLE playlist_map (_id INTEGER PRIMARY KEY AUTOINCREMENT, playlist_id INTEGER NOT NULL, media_uuid TEXT NOT NULL, play_order INTEGER NOT NULL)",
+	"CREATE INDEX playlist_map_playlist_id_idx ON playlist_map (playlist_id)",
+	"CREATE TABLE bookmark (bookmark_id INTEGER PRIMARY KEY AUTOINCREMENT, media_uuid TEXT NOT NULL, marked_time INTEGER DEFAULT 0, thumbnail_path TEXT)",
+	"CREATE VIEW tag_view AS SELECT t.tag_id, t.name, (SELECT COUNT(*) FROM tag_map WHERE tag_id=t.tag_id) AS media_count, tm._id AS tm_id, m.* \
+		FROM tag AS t LEFT OUTER JOIN tag_map AS tm ON (t.tag_id=tm.tag_id) LEFT OUTER JOIN media AS m ON (tm.media_uuid=m.media_uuid) \
+		WHERE m.validity=1 OR m.media_uuid IS NULL",
+	"CREATE VIEW playlist_view AS SELECT p.playlist_id, p.name, (SELECT COUNT(*) FROM playlist_map WHERE playlist_id=p.playlist_id) AS media_count, \
+		pm._id AS pm_id, pm.play_order, m.* FROM playlist AS p LEFT OUTER JOIN playlist_map AS pm ON (p.playlist_id=pm.playlist_id) \
+		LEFT OUTER JOIN media AS m ON (pm.media_uuid=m.media_uuid) WHERE m.validity=1 OR m.media_uuid IS NULL",
+};
+
+#define INSERT_BENCH_MEDIA	"INSERT INTO media (media_uuid, path, file_name, media_type, mime_type, size, added_time, modified_time, folder_uuid, \
+		title, album_id, album, artist, genre, composer, year, duration, width, height, storage_type, validity) \
+		VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)"
+
+#define INSERT_BENCH_TAG_MAP		"INSERT OR IGNORE INTO tag_map (tag_id, media_uuid) VALUES (?, ?)"
+#define INSERT_BENCH_PLAYLIST_MAP	"INSERT INTO playlist_map (playlist_id, media_uuid, play_order) VALUES (?, ?, ?)"
+
+typedef struct
+{
+	const char *name;
+	int (*run)(int *rows);
+}bench_op_s;
+
+typedef struct
+{
+	sqlite3_stmt *media_stmt;
+	sqlite3_stmt *tag_map_stmt;
+	sqlite3_stmt *playlist_map_stmt;
+	int media_count;
+	int folder_count;
+	int artist_count;
+	int tag_count;
+}bench_gen_s;
+
+static char *g_bench_db_path = NULL;
+static unsigned long long g_bench_random = BENCH_SEED;
+
+/* Stand-in for media-svc: the handle is the sqlite3 connection, as the library expects */
+int media_svc_connect(MediaSvcHandle **handle)
+{
+	sqlite3 *db = NULL;
+
+	if(sqlite3_open_v2(g_bench_db_path, &db, SQLITE_OPEN_READWRITE, NULL) != SQLITE_OK)
+	{
+		printf("fail to open %s : %s\n", g_bench_db_path, sqlite3_errmsg(db));
+		sqlite3_close(db);
+		return MEDIA_INFO_ERROR_DATABASE_CONNECT;
+	}
+
+	sqlite3_busy_timeout(db, 1000);
+	*handle = (MediaSvcHandle*)db;
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+int media_svc_disconnect(MediaSvcHandle *handle)
+{
+	if(sqlite3_close((sqlite3*)handle) != SQLITE_OK)
+		return MEDIA_INFO_ERROR_DATABASE_DISCONNECT;
+
+	return MEDIA_INFO_ERROR_NONE;
+}
+
+/* xorshift64, so that every run generates the same library */
+unsigned long long bench_random(void)
+{
+	g_bench_random ^= g_bench_random << 13;
+	g_bench_random ^= g_bench_random >> 7;
+	g_bench_random ^= g_bench_random << 17;
+
+	return g_bench_random;
+}
+
+int bench_uniform(int n)
+{
+	return (int)(bench_random() % (unsigned long long)n);
+}
+
+/* Most picks fall on the first values: a few big folders and popular artists, and a long tail */
+int bench_skewed(int n)
+{
+	double u = (double)(bench_random() % 1000000) / 1000000;
+
+	return (int)(n * u * u * u);
+}
+
+long bench_time_us(struct timeval *start)
+{
+	struct timeval end;
+
+	gettimeofday(&end, NULL);
+
+	return (end.tv_sec * 1000000 + end.tv_usec) - (start->tv_sec * 1000000 + start->tv_usec);
+}
+
+int bench_compare_long(const void *a, const void *b)
+{
+	long x = *(const long *)a;
+	long y = *(const long *)b;
+
+	return (x > y) - (x < y);
+}
+
+long bench_percentile(long *sorted, int count, int percent)
+{
+	return sorted[(count * percent + 99) / 100 - 1];
+}
+
+int bench_exec(sqlite3 *db, const char *sql)
+{
+	char *err_msg = NULL;
+
+	if(sqlite3_exec(db, sql, NULL, NULL, &err_msg) != SQLITE_OK)
+	{
+		printf("fail to run [%s] : %s\n", sql, err_msg);
+		sqlite3_free(err_msg);
+		return MEDIA_CONTENT_ERROR_DB_FAILED;
+	}
+
+	return MEDIA_CONTENT_ERROR_NONE;
+}
+
+int bench_step(sqlite3_stmt *stmt)
+{
+	if(sqlite3_step(stmt) != SQLITE_DONE)
+	{
+		printf("fail to insert : %s\n", sqlite3_errmsg(sqlite3_db_handle(stmt)));
+		return MEDIA_CONTENT_ERROR_DB_FAILED;
+	}
+
+	sqlite3_reset(stmt);
+	sqlite3_clear_bindings(stmt);
+
+	return MEDIA_CONTENT_ERROR_NONE;
+}
+
+int bench_insert_media(bench_gen_s *gen, int idx)
+{
+	char uuid[64] = {0, };
+	char path[256] = {0, };
+	char name[64] = {0, };
+	char folder[64] = {0, };
+	char text[64] = {0, };
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	int type = 0;
+	int folder_idx = bench_skewed(gen->folder_count);
+	int artist_idx = 0;
+	int album_idx = 0;
+	int playlist_id = 0;
+	int music_count = gen->media_count / 5 + 1;
+	long long added_time = 1262304000LL + (long long)idx * (5LL * 365 * 86400) / gen->media_count;	/* spread over five years from 2010 */
+	sqlite3_stmt *stmt = gen->media_stmt;
+	static const char *mime[] = {"image/jpeg", "video/mp4", "audio/ogg", "audio/mpeg"};
+	static const char *ext[] = {"jpg", "mp4", "ogg", "mp3"};
+
+	/* 60% images, 15% videos, 5% sounds, 20% music */
+	type = bench_uniform(100);
+	type = (type < 60) ? 0 : (type < 75) ? 1 : (type < 80) ? 2 : 3;
+
+	snprintf(uuid, sizeof(uuid), "%08x-%04x-4%03x-8000-%012d", (unsigned int)(bench_random() & 0xffffffff), idx & 0xffff, folder_idx & 0xfff, idx);
+	snprintf(folder, sizeof(folder), "folder-%05d", folder_idx);
+	snprintf(name, sizeof(name), "%s_%07d.%s", (type == 0) ? "IMG" : (type == 1) ? "VID" : "TRACK", idx, ext[type]);
+	snprintf(path, sizeof(path), "/opt/usr/media/dir%05d/%s", folder_idx, name);
+
+	sqlite3_bind_text(stmt, 1, uuid, -1, SQLITE_TRANSIENT);
+	sqlite3_bind_text(stmt, 2, path, -1, SQLITE_TRANSIENT);
+	sqlite3_bind_text(stmt, 3, name, -1, SQLITE_TRANSIENT);
+	sqlite3_bind_int(stmt, 4, type);
+	sqlite3_bind_text(stmt, 5, mime[type], -1, SQLITE_STATIC);
+	sqlite3_bind_int64(stmt, 6, (type == 1) ? 10000000 + bench_uniform(500000000) : 1000000 + bench_uniform(9000000));
+	sqlite3_bind_int64(stmt, 7, added_time);
+	sqlite3_bind_int64(stmt, 8, added_time + bench_uniform(3600));
+	sqlite3_bind_text(stmt, 9, folder, -1, SQLITE_TRANSIENT);
+	sqlite3_bind_text(stmt, 10, name, -1, SQLITE_TRANSIENT);
+
+	if(type >= 2)
+	{
+		artist_idx = bench_skewed(gen->artist_count);
+		album_idx = bench_uniform(3);
+
+		sqlite3_bind_int(stmt, 11, artist_idx * 3 + album_idx + 1);
+		snprintf(text, sizeof(text), "Album %d-%d", artist_idx, album_idx);
+		sqlite3_bind_text(stmt, 12, text, -1, SQLITE_TRANSIENT);
+		snprintf(text, sizeof(text), "Artist %d", artist_idx);
+		sqlite3_bind_text(stmt, 13, text, -1, SQLITE_TRANSIENT);
+		snprintf(text, sizeof(text), "Genre %d", bench_skewed(20));
+		sqlite3_bind_text(stmt, 14, text, -1, SQLITE_TRANSIENT);
+		snprintf(text, sizeof(text), "Composer %d", bench_skewed(200));
+		sqlite3_bind_text(stmt, 15, text, -1, SQLITE_TRANSIENT);
+		snprintf(text, sizeof(text), "%d", 2013 - bench_skewed(45));
+		sqlite3_bind_text(stmt, 16, text, -1, SQLITE_TRANSIENT);
+		sqlite3_bind_int(stmt, 17, 120000 + bench_uniform(300000));
+	}
+	else
+	{
+		sqlite3_bind_int(stmt, 11, 0);
+		sqlite3_bind_int(stmt, 17, (type == 1) ? 10000 + bench_uniform(600000) : -1);
+		sqlite3_bind_int(stmt, 18, (bench_uniform(2) == 0) ? 1920 : 3264);
+		sqlite3_bind_int(stmt, 19, (bench_uniform(2) == 0) ? 1080 : 2448);
+	}
+
+	/* One media out of ten is on the SD card, one out of a hundred is gone */
+	sqlite3_bind_int(stmt, 20, (bench_uniform(10) == 0) ? 1 : 0);
+	sqlite3_bind_int(stmt, 21, (bench_uniform(100) == 0) ? 0 : 1);
+
+	ret = bench_step(stmt);
+
+	/* One media out of ten is tagged, popular tags first */
+	if(ret == MEDIA_CONTENT_ERROR_NONE && bench_uniform(10) == 0)
+	{
+		sqlite3_bind_int(gen->tag_map_stmt, 1, bench_skewed(gen->tag_count) + 1);
+		sqlite3_bind_text(gen->tag_map_stmt, 2, uuid, -1, SQLITE_TRANSIENT);
+		ret = bench_step(gen->tag_map_stmt);
+	}
+
+	/* Music lands in each playlist with a chance of BENCH_PLAYLIST_SIZE out of the music count */
+	for(playlist_id = 1; type == 3 && playlist_id <= BENCH_PLAYLIST_COUNT && ret == MEDIA_CONTENT_ERROR_NONE; playlist_id++)
+	{
+		if(bench_uniform(music_count) >= BENCH_PLAYLIST_SIZE)
+			continue;
+
+		sqlite3_bind_int(gen->playlist_map_stmt, 1, playlist_id);
+		sqlite3_bind_text(gen->playlist_map_stmt, 2, uuid, -1, SQLITE_TRANSIENT);
+		sqlite3_bind_int(gen->playlist_map_stmt, 3, idx);
+		ret = bench_step(gen->playlist_map_stmt);
+	}
+
+	return ret;
+}
+
+int bench_generate(const char *db_path, int media_count)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	sqlite3 *db = NULL;
+	char *sql = NULL;
+	unsigned int idx = 0;
+	bench_gen_s gen;
+	struct timeval start;
+
+	memset(&gen, 0, sizeof(gen));
+	gen.media_count = media_count;
+	gen.folder_count = (media_count / 100 > 10) ? media_count / 100 : 10;
+	gen.artist_count = (media_count / 50 > 10) ? media_count / 50 : 10;
+	gen.tag_count = (media_count / 200 > 10) ? media_count / 200 : 10;
+
+	gettimeofday(&start, NULL);
+	unlink(db_path);
+
+	if(sqlite3_open(db_path, &db) != SQLITE_OK)
+	{
+		printf("fail to create %s : %s\n", db_path, sqlite3_errmsg(db));
+		sqlite3_close(db);
+		return MEDIA_CONTENT_ERROR_DB_FAILED;
+	}
+
+	for(idx = 0; idx < sizeof(g_bench_schema) / sizeof(g_bench_schema[0]) && ret == MEDIA_CONTENT_ERROR_NONE; idx++)
+		ret = bench_exec(db, g_bench_schema[idx]);
+
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = bench_exec(db, "BEGIN");
+
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+	{
+		if(sqlite3_prepare_v2(db, INSERT_BENCH_MEDIA, -1, &gen.media_stmt, NULL) != SQLITE_OK
+			|| sqlite3_prepare_v2(db, INSERT_BENCH_TAG_MAP, -1, &gen.tag_map_stmt, NULL) != SQLITE_OK
+			|| sqlite3_prepare_v2(db, INSERT_BENCH_PLAYLIST_MAP, -1, &gen.playlist_map_stmt, NULL) != SQLITE_OK)
+		{
+			printf("fail to prepare : %s\n", sqlite3_errmsg(db));
+			ret = MEDIA_CONTENT_ERROR_DB_FAILED;
+		}
+	}
+
+	g_bench_random = BENCH_SEED;
+
+	for(idx = 0; idx < (unsigned int)media_count && ret == MEDIA_CONTENT_ERROR_NONE; idx++)
+		ret = bench_insert_media(&gen, idx);
+
+	sqlite3_finalize(gen.media_stmt);
+	sqlite3_finalize(gen.tag_map_stmt);
+	sqlite3_finalize(gen.playlist_map_stmt);
+
+	for(idx = 0; idx < (unsigned int)gen.folder_count && ret == MEDIA_CONTENT_ERROR_NONE; idx++)
+	{
+		sql = sqlite3_mprintf("INSERT INTO folder VALUES ('folder-%05d', '/opt/usr/media/dir%05d', 'dir%05d', %d, 0)", idx, idx, idx, 1262304000 + idx);
+		ret = bench_exec(db, sql);
+		sqlite3_free(sql);
+	}
+
+	for(idx = 1; idx <= (unsigned int)gen.artist_count * 3 && ret == MEDIA_CONTENT_ERROR_NONE; idx++)
+	{
+		sql = sqlite3_mprintf("INSERT INTO album (album_id, name, artist) VALUES (%d, 'Album %d-%d', 'Artist %d')", idx, (idx - 1) / 3, (idx - 1) % 3, (idx - 1) / 3);
+		ret = bench_exec(db, sql);
+		sqlite3_free(sql);
+	}
+
+	for(idx = 1; idx <= (unsigned int)gen.tag_count && ret == MEDIA_CONTENT_ERROR_NONE; idx++)
+	{
+		sql = sqlite3_mprintf("INSERT INTO tag (tag_id, name) VALUES (%d, 'Tag %d')", idx, idx);
+		ret = bench_exec(db, sql);
+		sqlite3_free(sql);
+	}
+
+	for(idx = 1; idx <= BENCH_PLAYLIST_COUNT && ret == MEDIA_CONTENT_ERROR_NONE; idx++)
+	{
+		sql = sqlite3_mprintf("INSERT INTO playlist (playlist_id, name) VALUES (%d, 'Playlist %d')", idx, idx);
+		ret = bench_exec(db, sql);
+		sqlite3_free(sql);
+	}
+
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = bench_exec(db, "COMMIT");
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = bench_exec(db, "ANALYZE");
+
+	sqlite3_close(db);
+
+	printf("generated %d media, %d folders, %d artists, %d tags, %d playlists in %ld ms\n",
+		media_count, gen.folder_count, gen.artist_count, gen.tag_count, BENCH_PLAYLIST_COUNT, bench_time_us(&start) / 1000);
+
+	return ret;
+}
+
+bool bench_media_cb(media_info_h media, void *user_data)
+{
+	media_content_type_e media_type = MEDIA_CONTENT_TYPE_OTHERS;
+	image_meta_h image = NULL;
+
+	/* Getters the gallery calls for every item */
+	media_info_get_media_type(media, &media_type);
+	if(media_type == MEDIA_CONTENT_TYPE_IMAGE && media_info_get_image(media, &image) == MEDIA_CONTENT_ERROR_NONE)
+		image_meta_destroy(image);
+
+	(*(int*)user_data)++;
+
+	return true;
+}
+
+bool bench_size_cb(media_info_h media, void *user_data)
+{
+	unsigned long long *size_by_type = (unsigned long long*)user_data;
+	media_content_type_e media_type = MEDIA_CONTENT_TYPE_OTHERS;
+	unsigned long long size = 0;
+
+	media_info_get_media_type(media, &media_type);
+	media_info_get_size(media, &size);
+	size_by_type[media_type] += size;
+	size_by_type[MEDIA_CONTENT_TYPE_OTHERS + 1]++;
+
+	return true;
+}
+
+bool bench_size_columns_cb(const media_info_columns_s *columns, void *user_data)
+{
+	unsigned long long *size_by_type = (unsigned long long*)user_data;
+	int idx = 0;
+
+	for(idx = 0; idx < columns->count; idx++)
+		size_by_type[columns->media_type[idx]] += columns->size[idx];
+	size_by_type[MEDIA_CONTENT_TYPE_OTHERS + 1] += columns->count;
+
+	return true;
+}
+
+bool bench_member_cb(int playlist_member_id, media_info_h media, void *user_data)
+{
+	(*(int*)user_data)++;
+
+	return true;
+}
+
+bool bench_group_cb(const char *group_name, void *user_data)
+{
+	(*(int*)user_data)++;
+
+	return true;
+}
+
+bool bench_folder_count_cb(media_folder_h folder, int media_count, void *user_data)
+{
+	(*(int*)user_data)++;
+
+	return true;
+}
+
+bool bench_album_cb(media_album_h album, void *user_data)
+{
+	(*(int*)user_data)++;
+
+	return true;
+}
+
+bool bench_playlist_cb(media_playlist_h playlist, void *user_data)
+{
+	(*(int*)user_data)++;
+
+	return true;
+}
+
+bool bench_tag_cb(media_tag_h tag, void *user_data)
+{
+	(*(int*)user_data)++;
+
+	return true;
+}
+
+int bench_media_count(int *rows)
+{
+	return media_info_get_media_count_from_db(NULL, rows);
+}
+
+int bench_media_foreach(int *rows)
+{
+	return media_info_foreach_media_from_db(NULL, bench_media_cb, rows);
+}
+
+/* Size per media type, the last entry counts the rows */
+int bench_size_foreach(int *rows)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	unsigned long long size_by_type[MEDIA_CONTENT_TYPE_OTHERS + 2] = {0, };
+
+	ret = media_info_foreach_media_from_db(NULL, bench_size_cb, size_by_type);
+	*rows = (int)size_by_type[MEDIA_CONTENT_TYPE_OTHERS + 1];
+
+	return ret;
+}
+
+int bench_size_columns(int *rows)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	unsigned long long size_by_type[MEDIA_CONTENT_TYPE_OTHERS + 2] = {0, };
+	unsigned long long size[BENCH_COLUMNS_CAPACITY];
+	int media_type[BENCH_COLUMNS_CAPACITY];
+	media_info_columns_s columns = {0, };
+
+	columns.capacity = BENCH_COLUMNS_CAPACITY;
+	columns.size = size;
+	columns.media_type = media_type;
+
+	ret = media_info_foreach_columns_from_db(NULL, &columns, bench_size_columns_cb, size_by_type);
+	*rows = (int)size_by_type[MEDIA_CONTENT_TYPE_OTHERS + 1];
+
+	return ret;
+}
+
+/* Size and media count per media type, the counts of all types give the rows */
+int bench_size_aggregate(int *rows)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	int media_type = 0;
+	double size = 0;
+	double count = 0;
+	char condition[32];
+	filter_h filter = NULL;
+
+	media_filter_create(&filter);
+
+	for(media_type = MEDIA_CONTENT_TYPE_IMAGE; ret == MEDIA_CONTENT_ERROR_NONE && media_type <= MEDIA_CONTENT_TYPE_OTHERS; media_type++)
+	{
+		snprintf(condition, sizeof(condition), "MEDIA_TYPE=%d", media_type);
+		media_filter_set_condition(filter, condition, MEDIA_CONTENT_COLLATE_DEFAULT);
+		count = 0;
+		ret = media_info_get_aggregate_from_db(filter, MEDIA_SIZE, MEDIA_CONTENT_AGGREGATE_SUM, &size);
+		if(ret == MEDIA_CONTENT_ERROR_NONE)
+			ret = media_info_get_aggregate_from_db(filter, MEDIA_SIZE, MEDIA_CONTENT_AGGREGATE_COUNT, &count);
+
+		*rows += (int)count;
+	}
+
+	media_filter_destroy(filter);
+
+	return ret;
+}
+
+bool bench_usage_cb(const media_content_usage_s *usage, void *user_data)
+{
+	int *rows = (int*)user_data;
+
+	*rows += usage->media_count;
+
+	return true;
+}
+
+int bench_storage_usage(int *rows)
+{
+	return media_info_foreach_usage_from_db(NULL, bench_usage_cb, rows);
+}
+
+int bench_gallery_page(int *rows)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	filter_h filter = NULL;
+
+	media_filter_create(&filter);
+	media_filter_set_condition(filter, "MEDIA_TYPE=0", MEDIA_CONTENT_COLLATE_DEFAULT);
+	media_filter_set_order(filter, MEDIA_CONTENT_ORDER_DESC, MEDIA_ADDED_TIME, MEDIA_CONTENT_COLLATE_DEFAULT);
+	media_filter_set_offset(filter, 0, BENCH_PAGE_SIZE);
+
+	ret = media_info_foreach_media_from_db(filter, bench_media_cb, rows);
+
+	media_filter_destroy(filter);
+
+	return ret;
+}
+
+int bench_folder_list(int *rows)
+{
+	return media_folder_foreach_folder_with_count_from_db(NULL, bench_folder_count_cb, rows);
+}
+
+int bench_folder_media(int *rows)
+{
+	/* folder-00000 is the largest one */
+	return media_folder_foreach_media_from_db("folder-00000", NULL, bench_media_cb, rows);
+}
+
+int bench_artist_list(int *rows)
+{
+	return media_group_foreach_group_from_db(NULL, MEDIA_CONTENT_GROUP_ARTIST, bench_group_cb, rows);
+}
+
+int bench_artist_count(int *rows)
+{
+	return media_group_get_group_count_from_db(NULL, MEDIA_CONTENT_GROUP_ARTIST, rows);
+}
+
+int bench_artist_media_count(int *rows)
+{
+	return media_group_get_media_count_from_db("Artist 0", MEDIA_CONTENT_GROUP_ARTIST, NULL, rows);
+}
+
+int bench_album_list(int *rows)
+{
+	return media_album_foreach_album_from_db(NULL, bench_album_cb, rows);
+}
+
+int bench_playlist_list(int *rows)
+{
+	return media_playlist_foreach_playlist_from_db(NULL, bench_playlist_cb, rows);
+}
+
+int bench_playlist_media(int *rows)
+{
+	return media_playlist_foreach_media_from_db(1, NULL, bench_member_cb, rows);
+}
+
+int bench_tag_list(int *rows)
+{
+	return media_tag_foreach_tag_from_db(NULL, bench_tag_cb, rows);
+}
+
+int bench_tag_media(int *rows)
+{
+	return media_tag_foreach_media_from_db(1, NULL, bench_media_cb, rows);
+}
+
+static const bench_op_s g_bench_ops[] = {
+	{"media count", bench_media_count},
+	{"media foreach, all", bench_media_foreach},
+	{"size by type, foreach", bench_size_foreach},
+	{"size by type, columns", bench_size_columns},
+	{"size and count by type, aggregate", bench_size_aggregate},
+	{"storage usage", bench_storage_usage},
+	{"gallery page, images by added time", bench_gallery_page},
+	{"folder list with count", bench_folder_list},
+	{"folder media, largest folder", bench_folder_media},
+	{"artist list", bench_artist_list},
+	{"artist count", bench_artist_count},
+	{"media count of an artist", bench_artist_media_count},
+	{"album list", bench_album_list},
+	{"playlist list", bench_playlist_list},
+	{"playlist media", bench_playlist_media},
+	{"tag list", bench_tag_list},
+	{"tag media", bench_tag_media},
+};
+
+/* Runs op repeat times and prints its latency percentiles. Count calls give their count as rows */
+int bench_run(const bench_op_s *op, int repeat)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	int rows = 0;
+	int total_rows = 0;
+	int i = 0;
+	long total = 0;
+	long *latency = NULL;
+	struct timeval start;
+
+	latency = (long*)calloc(repeat, sizeof(long));
+	if(latency == NULL)
+		return MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
+
+	for(i = 0; i < repeat && ret == MEDIA_CONTENT_ERROR_NONE; i++)
+	{
+		rows = 0;
+		gettimeofday(&start, NULL);
+		ret = op->run(&rows);
+		latency[i] = bench_time_us(&start);
+
+		total += latency[i];
+		total_rows += rows;
+	}
+
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+	{
+		qsort(latency, repeat, sizeof(long), bench_compare_long);
+		printf("%-36s %9d %9ld %9ld %9ld %9ld %12.0f\n", op->name, total_rows / repeat,
+			bench_percentile(latency, repeat, 50), bench_percentile(latency, repeat, 90), bench_percentile(latency, repeat, 99),
+			latency[repeat - 1], (total > 0) ? (double)total_rows * 1000000 / total : 0.0);
+	}
+	else
+	{
+		printf("%-36s failed : %d\n", op->name, ret);
+	}
+
+	free(latency);
+
+	return ret;
+}
+
+int bench_all(int repeat)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	unsigned int idx = 0;
+
+	printf("\n%-36s %9s %9s %9s %9s %9s %12s\n", "operation (us)", "rows", "p50", "p90", "p99", "max", "rows/s");
+
+	for(idx = 0; idx < sizeof(g_bench_ops) / sizeof(g_bench_ops[0]); idx++)
+	{
+		if(bench_run(&g_bench_ops[idx], repeat) != MEDIA_CONTENT_ERROR_NONE)
+			ret = MEDIA_CONTENT_ERROR_DB_FAILED;
+	}
+
+	return ret;
+}
+
+/* Foreach throughput at each runtime log level. Levels above the one of the build are compiled out */
+int bench_log_level(int repeat)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	int saved_level = _content_log_level;
+	int level = 0;
+	char name[64] = {0, };
+	bench_op_s op = {name, bench_media_foreach};
+
+	printf("\n== media foreach by log level, compiled level %d ==\n", MEDIA_CONTENT_LOG_LEVEL);
+	printf("%-36s %9s %9s %9s %9s %9s %12s\n", "log level (us)", "rows", "p50", "p90", "p99", "max", "rows/s");
+
+	for(level = MEDIA_CONTENT_LOG_NONE; level <= MEDIA_CONTENT_LOG_VERBOSE && ret == MEDIA_CONTENT_ERROR_NONE; level++)
+	{
+		_content_log_level = level;
+
+		snprintf(name, sizeof(name), "%d%s", level, (level > MEDIA_CONTENT_LOG_LEVEL) ? " (compiled out)" : "");
+		ret = bench_run(&op, repeat);
+	}
+
+	_content_log_level = saved_level;
+
+	return ret;
+}
+
+/* Storage usage answered from the cache, which holds until the library changes */
+int bench_usage_cache(int repeat)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	bench_op_s op = {"storage usage, cached", bench_storage_usage};
+
+	ret = media_content_enable_usage_cache();
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+		return ret;
+
+	printf("\n%-36s %9s %9s %9s %9s %9s %12s\n", "usage cache (us)", "rows", "p50", "p90", "p99", "max", "rows/s");
+	ret = bench_run(&op, repeat);
+
+	media_content_disable_usage_cache();
+
+	return ret;
+}
+
+int main(int argc, char *argv[])
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	int media_count = BENCH_DEFAULT_MEDIA_COUNT;
+	int repeat = BENCH_DEFAULT_REPEAT;
+	bool keep = false;
+	int opt = 0;
+
+	g_bench_db_path = BENCH_DEFAULT_DB_PATH;
+
+	while((opt = getopt(argc, argv, "n:r:o:k")) != -1)
+	{
+		switch(opt)
+		{
+			case 'n':
+				media_count = atoi(optarg);
+				break;
+			case 'r':
+				repeat = atoi(optarg);
+				break;
+			case 'o':
+				g_bench_db_path = optarg;
+				break;
+			case 'k':
+				keep = true;
+				break;
+			default:
+				printf("usage : %s [-n media_count] [-r repeat] [-o db_path] [-k]\n", argv[0]);
+				return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+		}
+	}
+
+	if(media_count <= 0 || repeat <= 0)
+	{
+		printf("media_count and repeat must be positive\n");
+		return MEDIA_CONTENT_ERROR_INVALID_PARAMETER;
+	}
+
+	if(!keep || access(g_bench_db_path, F_OK) != 0)
+	{
+		ret = bench_generate(g_bench_db_path, media_count);
+		if(ret != MEDIA_CONTENT_ERROR_NONE)
+			return ret;
+	}
+
+	ret = media_content_connect();
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+	{
+		printf("media_content_connect failed : %d\n", ret);
+		return ret;
+	}
+
+	/* Warm up the page cache and the statement caches */
+	bench_all(1);
+
+	printf("\n== %s, %d runs of each ==", g_bench_db_path, repeat);
+	ret = bench_all(repeat);
+
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = bench_log_level(repeat);
+
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = bench_usage_cache(repeat);
+
+	media_content_disconnect();
+
+	return ret;
+}
@@ -1752,113 +1752,1331 @@ int test_insert(void)
 	return ret;
 }
 
+typedef struct
+{
+	const char **paths;
+	unsigned int count;
+	unsigned int next;		// index of the path the next callback has to report
+	int failed;				// callbacks out of order or with an inconsistent result
+}insert_batch_test_s;
+
+bool insert_batch_cb(const char *path, int result, media_info_h media, void *user_data)
+{
+	insert_batch_test_s *test = (insert_batch_test_s*)user_data;
+	char *media_id = NULL;
+	char *media_path = NULL;
+
+	if(test->next >= test->count || path == NULL || strcmp(path, test->paths[test->next]) != 0)
+	{
+		media_content_error("[%s] is reported out of order, expected [%d]", path, test->next);
+		test->failed++;
+		test->next++;
+		return true;
+	}
+
+	test->next++;
+
+	if(result != MEDIA_CONTENT_ERROR_NONE)
+	{
+		media_content_error("[%s] insertion is failed : %d", path, result);
+		if(media != NULL)
+			test->failed++;
+		return true;
+	}
+
+	media_info_get_media_id(media, &media_id);
+	media_info_get_file_path(media, &media_path);
+	media_content_debug("[%s] media id : %s", path, media_id);
+
+	if(media_id == NULL || media_path == NULL || strcmp(media_path, path) != 0)
+	{
+		media_content_error("[%s] is registered as [%s]", path, media_path);
+		test->failed++;
+	}
+
+	SAFE_FREE(media_id);
+	SAFE_FREE(media_path);
+
+	return true;
+}
+
+int test_insert_batch(void)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	const char *path_array[] = {
+		"/opt/media/Images/Default.jpg",
+		"/opt/media/Others/other.txt",
+		"/opt/media/Others/not_existing.txt",
+	};
+	insert_batch_test_s test = {path_array, sizeof(path_array) / sizeof(path_array[0]), 0, 0};
+
+	media_content_debug("\n============DB Batch Insert Test============\n\n");
+
+	ret = media_info_insert_batch_to_db(path_array, test.count, insert_batch_cb, &test);
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+	{
+		media_content_error("media_info_insert_batch_to_db is failed : %d", ret);
+		return ret;
+	}
+
+	/* Every path is reported once, in the order of the array */
+	if(test.next != test.count || test.failed > 0)
+	{
+		media_content_error("%d/%d paths reported, %d failed", test.next, test.count, test.failed);
+		ret = MEDIA_CONTENT_ERROR_INVALID_OPERATION;
+	}
+
+	return ret;
+}
+
 int test_move(void)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
-	const char *move_media_id = "60aea677-4742-408e-b5f7-f2628062d06d";
-	char *dst_path = "/opt/media/Images/XX/Default1.jpg";
-	media_info_h move_media = NULL;
+	const char *move_media_id = "60aea677-4742-408e-b5f7-f2628062d06d";
+	char *dst_path = "/opt/media/Images/XX/Default1.jpg";
+	media_info_h move_media = NULL;
+
+	ret = media_info_get_media_from_db(move_media_id, &move_media);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		media_content_debug("media_info_get_media_from_db success\n\n");
+	else
+		media_content_error("media_info_get_media_from_db failed: %d\n\n", ret);
+
+	media_content_debug("\n============DB Move Test============\n\n");
+
+	if(move_media) {
+		ret = media_info_move_to_db(move_media, dst_path);
+
+		if(ret == MEDIA_CONTENT_ERROR_NONE)
+			media_content_debug("Move is success\n\n");
+		else
+			media_content_error("Move is failed\n\n");
+	} else {
+		media_content_debug("There is no item : %s\n", move_media_id);
+	}
+
+	return ret;
+}
+
+void thumbnail_completed_cb(media_content_error_e error, const char *path, void *user_data)
+{
+	char *thumbnail_path = NULL;
+	g_cnt++;
+
+	printf("=================[%d][%d]\n", g_media_cnt, g_cnt);
+	printf("error_code [%d]\n", error);
+	printf("thumbnail_path [%s]\n", path);
+	if(user_data != NULL)
+	{
+		media_info_h media = (media_info_h)user_data;
+		media_info_get_thumbnail_path(media, &thumbnail_path);
+		printf("thumbnail_path get from media[%s]\n", thumbnail_path);
+		SAFE_FREE(thumbnail_path);
+		media_info_destroy(media);
+	}
+
+	if(g_cnt == g_media_cnt)
+		g_main_loop_quit(g_loop);
+
+	return;
+}
+
+bool thumbnail_create_cb(media_info_h media, void *user_data)
+{
+	char *media_id = NULL;
+	media_info_h dst = NULL;
+
+	if(media == NULL)
+	{
+		media_content_debug("NO Item \n");
+		return true;
+	}
+
+	media_info_get_media_id(media, &media_id);
+	media_content_debug("media_id : [%s] \n", media_id);
+
+	media_info_clone(&dst, media);
+	media_info_create_thumbnail(dst, thumbnail_completed_cb, dst);
+
+	return true;
+}
+
+gboolean create_thumbnail_start(gpointer data)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+
+	ret = media_info_foreach_media_from_db(g_filter, thumbnail_create_cb, NULL);
+
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		media_content_debug("media_info_foreach_media_from_db is success\n\n");
+	else
+		media_content_error("media_info_foreach_media_from_db is failed\n\n");
+
+	return false;
+}
+
+int test_create_thumbnail(void)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	GSource *source = NULL;
+	GMainContext *context = NULL;
+
+	test_filter_create();
+
+	media_info_get_media_count_from_db(g_filter, &g_media_cnt);
+	media_content_debug("media_count : [%d],\n", g_media_cnt);
+
+	g_loop = g_main_loop_new(NULL, FALSE);
+	context = g_main_loop_get_context(g_loop);
+	source = g_idle_source_new();
+	g_source_set_callback (source, create_thumbnail_start, NULL, NULL);
+	g_source_attach (source, context);
+
+	g_main_loop_run(g_loop);
+	g_main_loop_unref(g_loop);
+
+	test_filter_destroy();
+
+	return ret;
+}
+
+typedef struct
+{
+	int field_groups;		// groups the filter loads
+	int count;
+	int failed;				// media whose getters disagree with field_groups
+}projection_test_s;
+
+/* Getters of a loaded group succeed, getters of any other group return NOT_LOADED */
+static int projection_expected(projection_test_s *test, int field_group)
+{
+	return (test->field_groups & field_group) ? MEDIA_CONTENT_ERROR_NONE : MEDIA_CONTENT_ERROR_NOT_LOADED;
+}
+
+bool projection_item_cb(media_info_h media, void *user_data)
+{
+	projection_test_s *test = (projection_test_s*)user_data;
+	char *path = NULL;
+	double longitude = 0.0;
+	double latitude = 0.0;
+	image_meta_h image = NULL;
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	bool failed = false;
+
+	test->count++;
+
+	ret = media_info_get_file_path(media, &path);
+	if(ret != MEDIA_CONTENT_ERROR_NONE || path == NULL)
+	{
+		media_content_error("path should be loaded : %d", ret);
+		failed = true;
+	}
+
+	ret = media_info_get_longitude(media, &longitude);
+	if(ret != projection_expected(test, MEDIA_CONTENT_FIELD_LOCATION))
+	{
+		media_content_error("[%s] longitude : %d", path, ret);
+		failed = true;
+	}
+
+	ret = media_info_get_latitude(media, &latitude);
+	if(ret != projection_expected(test, MEDIA_CONTENT_FIELD_LOCATION))
+	{
+		media_content_error("[%s] latitude : %d", path, ret);
+		failed = true;
+	}
+
+	ret = media_info_get_image(media, &image);
+	if(ret != projection_expected(test, MEDIA_CONTENT_FIELD_IMAGE_META))
+	{
+		media_content_error("[%s] image meta : %d", path, ret);
+		failed = true;
+	}
+
+	if(image != NULL)
+		image_meta_destroy(image);
+
+	if(failed)
+		test->failed++;
+
+	SAFE_FREE(path);
+
+	return true;
+}
+
+int test_projection(void)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	int media_count = 0;
+	unsigned int idx = 0;
+	filter_h filter = NULL;
+	projection_test_s test;
+	const int field_groups[] = {
+		MEDIA_CONTENT_FIELD_CORE,		/* a grid view only needs path and thumbnail */
+		MEDIA_CONTENT_FIELD_CORE | MEDIA_CONTENT_FIELD_LOCATION,
+	};
+
+	media_content_debug("\n============Projection Test============\n\n");
+
+	ret = media_filter_create(&filter);
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+		return ret;
+
+	media_filter_set_condition(filter, "MEDIA_TYPE=0", MEDIA_CONTENT_COLLATE_DEFAULT);
+
+	ret = media_info_get_media_count_from_db(filter, &media_count);
+
+	for(idx = 0; ret == MEDIA_CONTENT_ERROR_NONE && idx < sizeof(field_groups) / sizeof(field_groups[0]); idx++)
+	{
+		memset(&test, 0, sizeof(test));
+		test.field_groups = field_groups[idx];
+
+		media_filter_set_projection(filter, test.field_groups);
+
+		ret = media_info_foreach_media_from_db(filter, projection_item_cb, &test);
+		if(ret != MEDIA_CONTENT_ERROR_NONE)
+		{
+			media_content_error("media_info_foreach_media_from_db failed: %d", ret);
+			break;
+		}
+
+		media_content_debug("fields 0x%x : %d/%d media, %d failed", test.field_groups, test.count, media_count, test.failed);
+
+		if(test.count != media_count || test.failed > 0)
+			ret = MEDIA_CONTENT_ERROR_INVALID_OPERATION;
+	}
+
+	media_filter_destroy(filter);
+
+	return ret;
+}
+
+int test_filter_generate_benchmark(void)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	int clause_cnt = 0;
+	int token_cnt = 0;
+	int i = 0;
+	int loop = 1000;
+	char *condition = NULL;
+	char *generated = NULL;
+	struct timeval start, end;
+	long time = 0;
+
+	media_content_debug("\n============Filter Generate Benchmark============\n\n");
+
+	/* Every clause is "MEDIA_TYPE = 1 AND" : 4 tokens */
+	for(clause_cnt = 4; clause_cnt <= 256; clause_cnt *= 2)
+	{
+		condition = (char*)calloc(clause_cnt, 32);
+		if(condition == NULL)
+			return MEDIA_CONTENT_ERROR_OUT_OF_MEMORY;
+
+		for(i = 0; i < clause_cnt; i++)
+		{
+			if(i > 0)
+				strcat(condition, " AND ");
+			strcat(condition, MEDIA_TYPE"=1");
+		}
+		token_cnt = clause_cnt * 4 - 1;
+
+		gettimeofday(&start, NULL);
+
+		for(i = 0; i < loop; i++)
+		{
+			ret = _media_filter_attribute_generate(_content_get_attirbute_handle(), condition, MEDIA_CONTENT_COLLATE_DEFAULT, &generated);
+			SAFE_FREE(generated);
+			if(ret != MEDIA_CONTENT_ERROR_NONE)
+				break;
+		}
+
+		gettimeofday(&end, NULL);
+		time = (end.tv_sec * 1000000 + end.tv_usec) - (start.tv_sec * 1000000 + start.tv_usec);
+		printf("tokens : %4d, %ld usec per condition, %ld nsec per token\n", token_cnt, time / loop, time * 1000 / loop / token_cnt);
+
+		SAFE_FREE(condition);
+
+		if(ret != MEDIA_CONTENT_ERROR_NONE)
+			return ret;
+	}
+
+	return ret;
+}
+
+static int cursor_count(filter_h filter, int prefetch_count, int *count)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	media_cursor_h cursor = NULL;
+	media_info_h media = NULL;
+	char *path = NULL;
+	bool available = false;
+
+	*count = 0;
+
+	ret = media_cursor_open(filter, prefetch_count, &cursor);
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+		return ret;
+
+	while((ret = media_cursor_next(cursor, &available)) == MEDIA_CONTENT_ERROR_NONE && available)
+	{
+		ret = media_cursor_get_media(cursor, &media);
+		if(ret != MEDIA_CONTENT_ERROR_NONE)
+			break;
+
+		media_info_get_file_path(media, &path);
+		media_content_debug("[%d] path : [%s]", (*count)++, path);
+		SAFE_FREE(path);
+	}
+
+	media_cursor_close(cursor);
+
+	return ret;
+}
+
+int test_cursor(void)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	int media_count = 0;
+	int count = 0;
+	int prefetch[4] = {1, 16, 0, 0};
+	int i = 0;
+
+	media_content_debug("\n============Cursor Test============\n\n");
+
+	ret = media_info_get_media_count_from_db(g_filter, &media_count);
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+		return ret;
+
+	/* A page ending exactly on the last row, and one longer than the result */
+	prefetch[2] = (media_count > 0) ? media_count : 1;
+	prefetch[3] = media_count + 1;
+
+	for(i = 0; i < 4; i++)
+	{
+		ret = cursor_count(g_filter, prefetch[i], &count);
+		if(ret != MEDIA_CONTENT_ERROR_NONE)
+			break;
+
+		media_content_debug("prefetch %d : %d/%d", prefetch[i], count, media_count);
+
+		if(count != media_count)
+		{
+			media_content_error("cursor with prefetch %d returned %d of %d media", prefetch[i], count, media_count);
+			ret = MEDIA_CONTENT_ERROR_INVALID_OPERATION;
+			break;
+		}
+	}
+
+	return ret;
+}
+
+typedef struct
+{
+	GHashTable *expected;		// media_id to artist of the unpaged list
+	GHashTable *seen;			// media_id of the pages read so far
+	media_content_order_e order_type;
+	char *last_id;				// last row of the page, the token is taken from it
+	char *last_artist;
+	media_info_h last;
+	int count;
+	int failed;
+}token_test_s;
+
+/* Artist of the audio or video meta, NULL for other media */
+static char *token_get_artist(media_info_h media)
+{
+	media_content_type_e media_type = 0;
+	audio_meta_h audio = NULL;
+	video_meta_h video = NULL;
+	char *artist = NULL;
+
+	media_info_get_media_type(media, &media_type);
+
+	if(media_type == MEDIA_CONTENT_TYPE_MUSIC || media_type == MEDIA_CONTENT_TYPE_SOUND)
+	{
+		if(media_info_get_audio(media, &audio) == MEDIA_CONTENT_ERROR_NONE)
+		{
+			audio_meta_get_artist(audio, &artist);
+			audio_meta_destroy(audio);
+		}
+	}
+	else if(media_type == MEDIA_CONTENT_TYPE_VIDEO)
+	{
+		if(media_info_get_video(media, &video) == MEDIA_CONTENT_ERROR_NONE)
+		{
+			video_meta_get_artist(video, &artist);
+			video_meta_destroy(video);
+		}
+	}
+
+	return artist;
+}
+
+static bool token_expected_cb(media_info_h media, void *user_data)
+{
+	GHashTable *expected = (GHashTable*)user_data;
+	char *media_id = NULL;
+	char *artist = NULL;
+
+	media_info_get_media_id(media, &media_id);
+	artist = token_get_artist(media);
+
+	g_hash_table_insert(expected, media_id, artist);
+
+	return true;
+}
+
+/* Rows must come as (artist, media_id) in the order of the filter. NULL artists sort first in ascending order. */
+static int token_compare(const char *artist1, const char *id1, const char *artist2, const char *id2)
+{
+	int diff = 0;
+
+	if(artist1 == NULL || artist2 == NULL)
+		diff = (artist1 != NULL) - (artist2 != NULL);
+	else
+		diff = strcmp(artist1, artist2);
+
+	return (diff != 0) ? diff : strcmp(id1, id2);
+}
+
+static bool token_page_cb(media_info_h media, void *user_data)
+{
+	token_test_s *test = (token_test_s*)user_data;
+	char *media_id = NULL;
+	char *artist = NULL;
+	int diff = 0;
+
+	media_info_get_media_id(media, &media_id);
+	artist = token_get_artist(media);
+
+	if(media_id == NULL || !g_hash_table_contains(test->expected, media_id))
+	{
+		media_content_error("[%s] is not in the unpaged list", media_id);
+		test->failed++;
+	}
+	else if(g_hash_table_contains(test->seen, media_id))
+	{
+		media_content_error("[%s] is listed twice", media_id);
+		test->failed++;
+	}
+
+	if(media_id != NULL && test->last_id != NULL)
+	{
+		diff = token_compare(test->last_artist, test->last_id, artist, media_id);
+		if((test->order_type == MEDIA_CONTENT_ORDER_ASC) ? (diff >= 0) : (diff <= 0))
+		{
+			media_content_error("[%s] [%s] is out of order after [%s] [%s]", artist, media_id, test->last_artist, test->last_id);
+			test->failed++;
+		}
+	}
+
+	if(media_id != NULL)
+		g_hash_table_add(test->seen, g_strdup(media_id));
+
+	SAFE_FREE(test->last_id);
+	SAFE_FREE(test->last_artist);
+	test->last_id = media_id;
+	test->last_artist = artist;
+	test->count++;
+
+	if(test->last != NULL)
+		media_info_destroy(test->last);
+	media_info_clone(&test->last, media);
+
+	return true;
+}
+
+/* Pages of 64 through a nullable order with ties, compared with one unpaged list */
+int test_continuation_token(void)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	filter_h filter = NULL;
+	token_test_s test;
+	char *token = NULL;
+	int read = 0;
+	int page = 0;
+	int i = 0;
+
+	media_content_debug("\n============Continuation Token Test============\n\n");
+
+	memset(&test, 0x00, sizeof(token_test_s));
+	test.expected = g_hash_table_new_full(g_str_hash, g_str_equal, free, free);
+	test.seen = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+	ret = media_info_foreach_media_from_db(NULL, token_expected_cb, test.expected);
+
+	for(i = 0; ret == MEDIA_CONTENT_ERROR_NONE && i < 2; i++)
+	{
+		test.order_type = (i == 0) ? MEDIA_CONTENT_ORDER_ASC : MEDIA_CONTENT_ORDER_DESC;
+		test.count = 0;
+		SAFE_FREE(test.last_id);
+		SAFE_FREE(test.last_artist);
+		g_hash_table_remove_all(test.seen);
+
+		if(test.last != NULL)
+			media_info_destroy(test.last);
+		test.last = NULL;
+
+		ret = media_filter_create(&filter);
+		if(ret != MEDIA_CONTENT_ERROR_NONE)
+			break;
+
+		media_filter_set_order(filter, test.order_type, MEDIA_ARTIST, MEDIA_CONTENT_COLLATE_DEFAULT);
+		media_filter_set_offset(filter, 0, 64);
+		media_filter_set_continuation_token(filter, "");
+
+		/* Every page starts after the last media of the previous one */
+		page = 0;
+		do
+		{
+			if(test.last != NULL)
+			{
+				ret = media_filter_get_continuation_token(filter, test.last, &token);
+				if(ret != MEDIA_CONTENT_ERROR_NONE)
+					break;
+
+				media_info_destroy(test.last);
+				test.last = NULL;
+
+				media_content_debug("page [%d] token : [%s]", page, token);
+				media_filter_set_continuation_token(filter, token);
+				SAFE_FREE(token);
+			}
+
+			read = test.count;
+			ret = media_info_foreach_media_from_db(filter, token_page_cb, &test);
+			page++;
+		} while(ret == MEDIA_CONTENT_ERROR_NONE && test.count > read);
+
+		media_filter_destroy(filter);
+
+		media_content_debug("%s : %d pages, %d/%d media", (i == 0) ? "asc" : "desc", page, test.count, g_hash_table_size(test.expected));
+
+		if(ret == MEDIA_CONTENT_ERROR_NONE && (test.failed > 0 || test.count != (int)g_hash_table_size(test.expected)))
+		{
+			media_content_error("%d of %d media were paged, %d rows failed", test.count, g_hash_table_size(test.expected), test.failed);
+			ret = MEDIA_CONTENT_ERROR_INVALID_OPERATION;
+		}
+	}
+
+	if(test.last != NULL)
+		media_info_destroy(test.last);
+
+	SAFE_FREE(test.last_id);
+	SAFE_FREE(test.last_artist);
+	g_hash_table_destroy(test.expected);
+	g_hash_table_destroy(test.seen);
+
+	return ret;
+}
+
+typedef struct
+{
+	GPtrArray *names;			// group names, NULL for the group of media without a value
+	int media_count;			// sum of the counts of the groups
+}group_test_s;
+
+static bool group_count_cb(const char *group_name, int media_count, void *user_data)
+{
+	group_test_s *test = (group_test_s*)user_data;
+
+	media_content_debug("group : [%s], media count : [%d]", group_name, media_count);
+
+	g_ptr_array_add(test->names, g_strdup(group_name));
+	test->media_count += media_count;
+
+	return true;
+}
+
+static bool group_name_cb(const char *group_name, void *user_data)
+{
+	group_test_s *test = (group_test_s*)user_data;
+
+	g_ptr_array_add(test->names, g_strdup(group_name));
+
+	return true;
+}
+
+static gint group_name_compare(gconstpointer a, gconstpointer b)
+{
+	return g_strcmp0(*(const char **)a, *(const char **)b);
+}
+
+static bool album_count_cb(media_album_h album, int media_count, void *user_data)
+{
+	char *name = NULL;
+
+	media_album_get_name(album, &name);
+	media_content_debug("album : [%s], media count : [%d]", name, media_count);
+	SAFE_FREE(name);
+
+	return true;
+}
+
+/* The counts of the groups must add up to the media of the filter, and the groups must be the ones listed without counts */
+int test_group_with_count(void)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	filter_h filters[2] = {NULL, g_filter};
+	group_test_s counted;
+	group_test_s listed;
+	int media_count = 0;
+	int i = 0;
+	int j = 0;
+
+	media_content_debug("\n============Group With Count Test============\n\n");
+
+	for(i = 0; ret == MEDIA_CONTENT_ERROR_NONE && i < 2; i++)
+	{
+		memset(&counted, 0x00, sizeof(group_test_s));
+		memset(&listed, 0x00, sizeof(group_test_s));
+		counted.names = g_ptr_array_new_with_free_func(g_free);
+		listed.names = g_ptr_array_new_with_free_func(g_free);
+
+		ret = media_info_get_media_count_from_db(filters[i], &media_count);
+		if(ret == MEDIA_CONTENT_ERROR_NONE)
+			ret = media_group_foreach_group_with_count_from_db(filters[i], MEDIA_CONTENT_GROUP_ARTIST, group_count_cb, &counted);
+		if(ret == MEDIA_CONTENT_ERROR_NONE)
+			ret = media_group_foreach_group_from_db(filters[i], MEDIA_CONTENT_GROUP_ARTIST, group_name_cb, &listed);
+
+		if(ret == MEDIA_CONTENT_ERROR_NONE && counted.media_count != media_count)
+		{
+			media_content_error("groups count %d media of %d", counted.media_count, media_count);
+			ret = MEDIA_CONTENT_ERROR_INVALID_OPERATION;
+		}
+
+		if(ret == MEDIA_CONTENT_ERROR_NONE && counted.names->len != listed.names->len)
+		{
+			media_content_error("%d groups with count, %d without", counted.names->len, listed.names->len);
+			ret = MEDIA_CONTENT_ERROR_INVALID_OPERATION;
+		}
+
+		g_ptr_array_sort(counted.names, group_name_compare);
+		g_ptr_array_sort(listed.names, group_name_compare);
+
+		for(j = 0; ret == MEDIA_CONTENT_ERROR_NONE && j < (int)counted.names->len; j++)
+		{
+			if(g_strcmp0(g_ptr_array_index(counted.names, j), g_ptr_array_index(listed.names, j)) != 0 ||
+				(j > 0 && g_strcmp0(g_ptr_array_index(counted.names, j - 1), g_ptr_array_index(counted.names, j)) == 0))
+			{
+				media_content_error("group [%s] with count, [%s] without", (char*)g_ptr_array_index(counted.names, j), (char*)g_ptr_array_index(listed.names, j));
+				ret = MEDIA_CONTENT_ERROR_INVALID_OPERATION;
+			}
+		}
+
+		media_content_debug("filter %d : %d groups, %d/%d media", i, counted.names->len, counted.media_count, media_count);
+
+		g_ptr_array_free(counted.names, TRUE);
+		g_ptr_array_free(listed.names, TRUE);
+	}
+
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+		return ret;
+
+	ret = media_album_foreach_album_with_count_from_db(g_filter, album_count_cb, NULL);
+
+	return ret;
+}
+
+int test_group_summary(void)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	int scanned_count = 0;
+	int summary_count = 0;
+
+	media_content_debug("\n============Group Summary Test============\n\n");
+
+	ret = media_group_get_group_count_from_db(NULL, MEDIA_CONTENT_GROUP_ARTIST, &scanned_count);
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+		return ret;
+
+	ret = media_content_enable_group_summary();
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+		return ret;
+
+	ret = media_group_get_group_count_from_db(NULL, MEDIA_CONTENT_GROUP_ARTIST, &summary_count);
+	if(ret == MEDIA_CONTENT_ERROR_NONE && scanned_count != summary_count)
+	{
+		media_content_error("artist count : %d, from summary : %d", scanned_count, summary_count);
+		ret = MEDIA_CONTENT_ERROR_INVALID_OPERATION;
+	}
+
+	media_content_disable_group_summary();
+
+	return ret;
+}
+
+int test_query_plan(void)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	filter_h filter = NULL;
+	int plan = 0;
+	char *detail = NULL;
+
+	media_content_debug("\n============Query Plan Test============\n\n");
+
+	media_filter_create(&filter);
+	media_filter_set_condition(filter, "MEDIA_TYPE=0", MEDIA_CONTENT_COLLATE_DEFAULT);
+	media_filter_set_order(filter, MEDIA_CONTENT_ORDER_DESC, MEDIA_ADDED_TIME, MEDIA_CONTENT_COLLATE_DEFAULT);
+
+	ret = media_content_create_indexes();
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = media_filter_get_query_plan(filter, &plan, &detail);
+
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+	{
+		media_content_debug("plan : 0x%02x\n%s", plan, detail);
+		if(plan != MEDIA_CONTENT_QUERY_PLAN_INDEXED)
+			ret = MEDIA_CONTENT_ERROR_INVALID_OPERATION;
+	}
+
+	SAFE_FREE(detail);
+	media_filter_destroy(filter);
+
+	return ret;
+}
+
+bool stats_cb(const char *query, const media_content_stats_s *stats, void *user_data)
+{
+	media_content_debug("[%s]", query);
+	media_content_debug("count : %d, prepare avg/p99 : %llu/%llu us, step avg/p99 : %llu/%llu us, rows : %llu, materialized : %llu",
+		stats->count, stats->prepare_avg, stats->prepare_p99, stats->step_avg, stats->step_p99, stats->rows_returned, stats->rows_materialized);
+
+	if(user_data != NULL)
+		*(int*)user_data += stats->count;
+
+	return true;
+}
+
+int test_stats(void)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	int media_count = 0;
+	int run_count = 0;
+
+	media_content_debug("\n============Stats Test============\n\n");
+
+	media_content_reset_stats();
+	media_content_enable_stats();
+
+	ret = media_info_foreach_media_from_db(NULL, media_item_cb, NULL);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = media_info_get_media_count_from_db(NULL, &media_count);
+
+	media_content_disable_stats();
+
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = media_content_get_stats(stats_cb, &run_count);
+
+	if(ret == MEDIA_CONTENT_ERROR_NONE && run_count < 2)
+	{
+		media_content_error("runs recorded : %d", run_count);
+		ret = MEDIA_CONTENT_ERROR_INVALID_OPERATION;
+	}
+
+	media_content_reset_stats();
+
+	return ret;
+}
+
+bool batch_count_cb(media_info_h *media, int count, void *user_data)
+{
+	int *media_count = (int*)user_data;
+
+	media_content_debug("batch of %d", count);
+	*media_count += count;
+
+	return true;
+}
+
+int test_foreach_batch(void)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	int media_count = 0;
+	int batch_media_count = 0;
+
+	media_content_debug("\n============Foreach Batch Test============\n\n");
+
+	ret = media_info_get_media_count_from_db(NULL, &media_count);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = media_info_foreach_media_batch_from_db(NULL, 10, batch_count_cb, &batch_media_count);
+
+	media_content_debug("media %d/%d", batch_media_count, media_count);
+
+	if(ret == MEDIA_CONTENT_ERROR_NONE && batch_media_count != media_count)
+		ret = MEDIA_CONTENT_ERROR_INVALID_OPERATION;
+
+	return ret;
+}
+
+#define COLUMNS_TEST_CAPACITY	16
+
+bool columns_cb(const media_info_columns_s *columns, void *user_data)
+{
+	unsigned long long *total_size = (unsigned long long*)user_data;
+	int idx = 0;
+
+	for(idx = 0; idx < columns->count; idx++)
+		*total_size += columns->size[idx];
+
+	if(columns->count > 0)
+		media_content_debug("%d rows, first [%s]", columns->count, columns->path + columns->path_offset[0]);
+
+	return true;
+}
+
+bool size_cb(media_info_h media, void *user_data)
+{
+	unsigned long long size = 0;
+
+	media_info_get_size(media, &size);
+	*(unsigned long long*)user_data += size;
+
+	return true;
+}
+
+int test_columns(void)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	unsigned long long total_size = 0;
+	unsigned long long columns_size = 0;
+	unsigned long long size[COLUMNS_TEST_CAPACITY];
+	int path_offset[COLUMNS_TEST_CAPACITY + 1];
+	char path[COLUMNS_TEST_CAPACITY * 256];
+	media_info_columns_s columns = {0, };
+
+	media_content_debug("\n============Columns Test============\n\n");
+
+	columns.capacity = COLUMNS_TEST_CAPACITY;
+	columns.size = size;
+	columns.path_offset = path_offset;
+	columns.path = path;
+	columns.path_capacity = sizeof(path);
+
+	ret = media_info_foreach_media_from_db(NULL, size_cb, &total_size);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = media_info_foreach_columns_from_db(NULL, &columns, columns_cb, &columns_size);
+
+	media_content_debug("size %llu/%llu", columns_size, total_size);
+
+	if(ret == MEDIA_CONTENT_ERROR_NONE && columns_size != total_size)
+		ret = MEDIA_CONTENT_ERROR_INVALID_OPERATION;
+
+	return ret;
+}
+
+int test_aggregate(void)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	int media_count = 0;
+	double count = 0;
+	double total_size = 0;
+	double max_duration = 0;
+	unsigned long long foreach_size = 0;
+	filter_h filter = NULL;
+
+	media_content_debug("\n============Aggregate Test============\n\n");
+
+	ret = media_info_get_media_count_from_db(NULL, &media_count);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = media_info_get_aggregate_from_db(NULL, MEDIA_SIZE, MEDIA_CONTENT_AGGREGATE_COUNT, &count);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = media_info_get_aggregate_from_db(NULL, MEDIA_SIZE, MEDIA_CONTENT_AGGREGATE_SUM, &total_size);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = media_info_foreach_media_from_db(NULL, size_cb, &foreach_size);
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+		return ret;
+
+	media_content_debug("count %.0f/%d, size %.0f/%llu", count, media_count, total_size, foreach_size);
+
+	if((int)count != media_count || (unsigned long long)total_size != foreach_size)
+		return MEDIA_CONTENT_ERROR_INVALID_OPERATION;
+
+	/* Longest music on the internal storage */
+	media_filter_create(&filter);
+	media_filter_set_condition(filter, "MEDIA_TYPE=3 AND MEDIA_STORAGE_TYPE=0", MEDIA_CONTENT_COLLATE_DEFAULT);
+
+	ret = media_info_get_aggregate_from_db(filter, MEDIA_DURATION, MEDIA_CONTENT_AGGREGATE_MAX, &max_duration);
+	media_content_debug("max duration : %.0f", max_duration);
+
+	media_filter_destroy(filter);
+
+	/* Only numeric fields */
+	if(ret == MEDIA_CONTENT_ERROR_NONE && media_info_get_aggregate_from_db(NULL, MEDIA_PATH, MEDIA_CONTENT_AGGREGATE_MAX, &max_duration) != MEDIA_CONTENT_ERROR_INVALID_PARAMETER)
+		ret = MEDIA_CONTENT_ERROR_INVALID_OPERATION;
+
+	return ret;
+}
+
+typedef struct
+{
+	int media_count;
+	unsigned long long total_size;
+}usage_test_s;
+
+bool usage_cb(const media_content_usage_s *usage, void *user_data)
+{
+	usage_test_s *test = (usage_test_s*)user_data;
+
+	media_content_debug("storage %d, type %d, [%s] : %d media, %llu bytes", usage->storage_type, usage->media_type,
+		usage->mime_type ? usage->mime_type : "", usage->media_count, usage->total_size);
+
+	test->media_count += usage->media_count;
+	test->total_size += usage->total_size;
+
+	return true;
+}
+
+int test_usage(void)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	int media_count = 0;
+	double total_size = 0;
+	usage_test_s usage = {0, 0};
+	usage_test_s cached = {0, 0};
 
-	ret = media_info_get_media_from_db(move_media_id, &move_media);
+	media_content_debug("\n============Usage Test============\n\n");
+
+	ret = media_info_get_media_count_from_db(NULL, &media_count);
 	if(ret == MEDIA_CONTENT_ERROR_NONE)
-		media_content_debug("media_info_get_media_from_db success\n\n");
-	else
-		media_content_error("media_info_get_media_from_db failed: %d\n\n", ret);
+		ret = media_info_get_aggregate_from_db(NULL, MEDIA_SIZE, MEDIA_CONTENT_AGGREGATE_SUM, &total_size);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = media_info_foreach_usage_from_db(NULL, usage_cb, &usage);
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+		return ret;
 
-	media_content_debug("\n============DB Move Test============\n\n");
+	media_content_debug("count %d/%d, size %llu/%.0f", usage.media_count, media_count, usage.total_size, total_size);
 
-	if(move_media) {
-		ret = media_info_move_to_db(move_media, dst_path);
+	if(usage.media_count != media_count || usage.total_size != (unsigned long long)total_size)
+		return MEDIA_CONTENT_ERROR_INVALID_OPERATION;
 
-		if(ret == MEDIA_CONTENT_ERROR_NONE)
-			media_content_debug("Move is success\n\n");
-		else
-			media_content_error("Move is failed\n\n");
-	} else {
-		media_content_debug("There is no item : %s\n", move_media_id);
+	/* The second call is answered from the cache */
+	ret = media_content_enable_usage_cache();
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = media_info_foreach_usage_from_db(NULL, usage_cb, &cached);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+	{
+		memset(&cached, 0, sizeof(cached));
+		ret = media_info_foreach_usage_from_db(NULL, usage_cb, &cached);
 	}
 
+	media_content_disable_usage_cache();
+
+	if(ret == MEDIA_CONTENT_ERROR_NONE && (cached.media_count != usage.media_count || cached.total_size != usage.total_size))
+		ret = MEDIA_CONTENT_ERROR_INVALID_OPERATION;
+
 	return ret;
 }
 
-void thumbnail_completed_cb(media_content_error_e error, const char *path, void *user_data)
+typedef struct
 {
-	char *thumbnail_path = NULL;
-	g_cnt++;
+	GMainLoop *loop;
+	int media_count;		// media handed to the batch callback
+	int folder_count;
+	int ret;
+}async_test_s;
 
-	printf("=================[%d][%d]\n", g_media_cnt, g_cnt);
-	printf("error_code [%d]\n", error);
-	printf("thumbnail_path [%s]\n", path);
-	if(user_data != NULL)
+bool async_batch_cb(media_info_h *media, int count, void *user_data)
+{
+	async_test_s *test = (async_test_s*)user_data;
+	char *media_id = NULL;
+
+	if(count > 0 && media_info_get_media_id(media[0], &media_id) == MEDIA_CONTENT_ERROR_NONE)
 	{
-		media_info_h media = (media_info_h)user_data;
-		media_info_get_thumbnail_path(media, &thumbnail_path);
-		printf("thumbnail_path get from media[%s]\n", thumbnail_path);
-		SAFE_FREE(thumbnail_path);
-		media_info_destroy(media);
+		media_content_debug("batch of %d, first [%s]", count, media_id);
+		SAFE_FREE(media_id);
 	}
 
-	if(g_cnt == g_media_cnt)
-		g_main_loop_quit(g_loop);
+	test->media_count += count;
 
-	return;
+	return true;
 }
 
-bool thumbnail_create_cb(media_info_h media, void *user_data)
+void async_folder_count_cb(media_content_error_e error, int count, void *user_data)
 {
-	char *media_id = NULL;
-	media_info_h dst = NULL;
+	async_test_s *test = (async_test_s*)user_data;
 
-	if(media == NULL)
+	test->ret = error;
+	test->folder_count = count;
+
+	g_main_loop_quit(test->loop);
+}
+
+void async_completed_cb(media_content_error_e error, void *user_data)
+{
+	async_test_s *test = (async_test_s*)user_data;
+
+	test->ret = error;
+	if(error == MEDIA_CONTENT_ERROR_NONE)
+		test->ret = media_folder_get_folder_count_from_db_async(NULL, g_main_loop_get_context(test->loop), async_folder_count_cb, test, NULL);
+
+	if(test->ret != MEDIA_CONTENT_ERROR_NONE)
+		g_main_loop_quit(test->loop);
+}
+
+int test_async(void)
+{
+	int ret = MEDIA_CONTENT_ERROR_NONE;
+	int media_count = 0;
+	int folder_count = 0;
+	unsigned int request_id = 0;
+	GMainContext *context = NULL;
+	async_test_s test = {0, };
+
+	media_content_debug("\n============Async Test============\n\n");
+
+	ret = media_info_get_media_count_from_db(NULL, &media_count);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = media_folder_get_folder_count_from_db(NULL, &folder_count);
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+		return ret;
+
+	context = g_main_context_new();
+	test.loop = g_main_loop_new(context, FALSE);
+
+	/* A cancelled request calls nothing */
+	ret = media_info_foreach_media_from_db_async(NULL, 0, context, async_batch_cb, async_completed_cb, &test, &request_id);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = media_content_cancel_request(request_id);
+
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = media_info_foreach_media_from_db_async(NULL, 16, context, async_batch_cb, async_completed_cb, &test, NULL);
+
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
 	{
-		media_content_debug("NO Item \n");
-		return true;
+		g_main_loop_run(test.loop);
+		ret = test.ret;
 	}
 
-	media_info_get_media_id(media, &media_id);
-	media_content_debug("media_id : [%s] \n", media_id);
+	g_main_loop_unref(test.loop);
+	g_main_context_unref(context);
 
-	media_info_clone(&dst, media);
-	media_info_create_thumbnail(dst, thumbnail_completed_cb, dst);
+	media_content_debug("media %d/%d, folder %d/%d", test.media_count, media_count, test.folder_count, folder_count);
 
-	return true;
+	if(ret == MEDIA_CONTENT_ERROR_NONE && (test.media_count != media_count || test.folder_count != folder_count))
+		ret = MEDIA_CONTENT_ERROR_INVALID_OPERATION;
+
+	return ret;
 }
 
-gboolean create_thumbnail_start(gpointer data)
+#define CONCURRENT_PLAYLIST_CNT	8
+#define CONCURRENT_MEMBER_CNT	200
+
+typedef struct
+{
+	int index;
+	int ret;
+}playlist_thread_s;
+
+void *playlist_thread_func(void *data)
+{
+	playlist_thread_s *param = (playlist_thread_s*)data;
+	media_playlist_h playlist = NULL;
+	char name[64];
+	int playlist_id = 0;
+	int applied_count = 0;
+	int media_count = 0;
+	int i = 0;
+
+	snprintf(name, sizeof(name), "concurrent_playlist_%d", param->index);
+
+	param->ret = media_playlist_insert_to_db(name, &playlist);
+	if(param->ret != MEDIA_CONTENT_ERROR_NONE)
+		return NULL;
+
+	media_playlist_get_playlist_id(playlist, &playlist_id);
+
+	/* Every thread queues its own changes on its own handle */
+	for(i = 0; i < CONCURRENT_MEMBER_CNT; i++)
+	{
+		param->ret = media_playlist_add_media(playlist, (i % 2) ? test_audio_id : test_video_id);
+		if(param->ret != MEDIA_CONTENT_ERROR_NONE)
+			break;
+	}
+
+	if(param->ret == MEDIA_CONTENT_ERROR_NONE)
+		param->ret = media_playlist_update_to_db_with_count(playlist, &applied_count);
+
+	if(param->ret == MEDIA_CONTENT_ERROR_NONE)
+		param->ret = media_playlist_get_media_count_from_db(playlist_id, NULL, &media_count);
+
+	if(param->ret == MEDIA_CONTENT_ERROR_NONE && (applied_count != CONCURRENT_MEMBER_CNT || media_count != CONCURRENT_MEMBER_CNT))
+	{
+		media_content_error("playlist [%d] applied : %d, members : %d", playlist_id, applied_count, media_count);
+		param->ret = MEDIA_CONTENT_ERROR_INVALID_OPERATION;
+	}
+
+	media_playlist_destroy(playlist);
+	media_playlist_delete_from_db(playlist_id);
+
+	return NULL;
+}
+
+int test_playlist_concurrency(void)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
+	pthread_t threads[CONCURRENT_PLAYLIST_CNT];
+	playlist_thread_s params[CONCURRENT_PLAYLIST_CNT];
+	int i = 0;
 
-	ret = media_info_foreach_media_from_db(g_filter, thumbnail_create_cb, NULL);
+	media_content_debug("\n============Playlist Concurrency Test============\n\n");
 
-	if(ret == MEDIA_CONTENT_ERROR_NONE)
-		media_content_debug("media_info_foreach_media_from_db is success\n\n");
-	else
-		media_content_error("media_info_foreach_media_from_db is failed\n\n");
+	for(i = 0; i < CONCURRENT_PLAYLIST_CNT; i++)
+	{
+		params[i].index = i;
+		params[i].ret = MEDIA_CONTENT_ERROR_NONE;
+		pthread_create(&threads[i], NULL, playlist_thread_func, &params[i]);
+	}
 
-	return false;
+	for(i = 0; i < CONCURRENT_PLAYLIST_CNT; i++)
+	{
+		pthread_join(threads[i], NULL);
+
+		if(params[i].ret != MEDIA_CONTENT_ERROR_NONE)
+		{
+			media_content_error("thread [%d] failed : %d", i, params[i].ret);
+			ret = params[i].ret;
+		}
+	}
+
+	return ret;
 }
 
-int test_create_thumbnail(void)
+/* A rename onto a name that is taken fails in the middle of the batch.
+ * Nothing may be applied, and the queued changes must apply once the name is free. */
+int test_update_rollback(void)
 {
 	int ret = MEDIA_CONTENT_ERROR_NONE;
-	GSource *source = NULL;
-	GMainContext *context = NULL;
+	media_playlist_h playlist = NULL;
+	media_playlist_h taken_playlist = NULL;
+	media_tag_h tag = NULL;
+	media_tag_h taken_tag = NULL;
+	int playlist_id = 0;
+	int taken_playlist_id = 0;
+	int tag_id = 0;
+	int taken_tag_id = 0;
+	int applied_count = -1;
+	int media_count = -1;
+	char *name = NULL;
 
-	test_filter_create();
+	media_content_debug("\n============Update Rollback Test============\n\n");
 
-	media_info_get_media_count_from_db(g_filter, &g_media_cnt);
-	media_content_debug("media_count : [%d],\n", g_media_cnt);
+	ret = media_playlist_insert_to_db("rollback_playlist", &playlist);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = media_playlist_insert_to_db("rollback_playlist_taken", &taken_playlist);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = media_tag_insert_to_db("rollback_tag", &tag);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = media_tag_insert_to_db("rollback_tag_taken", &taken_tag);
 
-	g_loop = g_main_loop_new(NULL, FALSE);
-	context = g_main_loop_get_context(g_loop);
-	source = g_idle_source_new();
-	g_source_set_callback (source, create_thumbnail_start, NULL, NULL);
-	g_source_attach (source, context);
+	media_playlist_get_playlist_id(playlist, &playlist_id);
+	media_playlist_get_playlist_id(taken_playlist, &taken_playlist_id);
+	media_tag_get_tag_id(tag, &tag_id);
+	media_tag_get_tag_id(taken_tag, &taken_tag_id);
 
-	g_main_loop_run(g_loop);
-	g_main_loop_unref(g_loop);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+	{
+		media_playlist_add_media(playlist, test_audio_id);
+		media_playlist_add_media(playlist, test_video_id);
+		media_playlist_set_name(playlist, "rollback_playlist_taken");
+		media_playlist_add_media(playlist, test_audio_id);
+
+		media_tag_add_media(tag, test_audio_id);
+		media_tag_add_media(tag, test_video_id);
+		media_tag_set_name(tag, "rollback_tag_taken");
+	}
 
-	test_filter_destroy();
+	/* Playlist */
+	if(ret == MEDIA_CONTENT_ERROR_NONE && media_playlist_update_to_db_with_count(playlist, &applied_count) == MEDIA_CONTENT_ERROR_NONE)
+	{
+		media_content_error("playlist update did not fail");
+		ret = MEDIA_CONTENT_ERROR_INVALID_OPERATION;
+	}
+
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = media_playlist_get_media_count_from_db(playlist_id, NULL, &media_count);
+
+	if(ret == MEDIA_CONTENT_ERROR_NONE && (applied_count != 0 || media_count != 0))
+	{
+		media_content_error("rolled back playlist applied : %d, members : %d", applied_count, media_count);
+		ret = MEDIA_CONTENT_ERROR_INVALID_OPERATION;
+	}
+
+	/* The pending changes are still on the handle */
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = media_playlist_delete_from_db(taken_playlist_id);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = media_playlist_update_to_db_with_count(playlist, &applied_count);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = media_playlist_get_media_count_from_db(playlist_id, NULL, &media_count);
+
+	if(ret == MEDIA_CONTENT_ERROR_NONE && (applied_count != 4 || media_count != 3))
+	{
+		media_content_error("retried playlist applied : %d, members : %d", applied_count, media_count);
+		ret = MEDIA_CONTENT_ERROR_INVALID_OPERATION;
+	}
+
+	/* Tag */
+	applied_count = -1;
+	media_count = -1;
+
+	if(ret == MEDIA_CONTENT_ERROR_NONE && media_tag_update_to_db_with_count(tag, &applied_count) == MEDIA_CONTENT_ERROR_NONE)
+	{
+		media_content_error("tag update did not fail");
+		ret = MEDIA_CONTENT_ERROR_INVALID_OPERATION;
+	}
+
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = media_tag_get_media_count_from_db(tag_id, NULL, &media_count);
+
+	if(ret == MEDIA_CONTENT_ERROR_NONE && (applied_count != 0 || media_count != 0))
+	{
+		media_content_error("rolled back tag applied : %d, media : %d", applied_count, media_count);
+		ret = MEDIA_CONTENT_ERROR_INVALID_OPERATION;
+	}
+
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = media_tag_delete_from_db(taken_tag_id);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = media_tag_update_to_db_with_count(tag, &applied_count);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = media_tag_get_media_count_from_db(tag_id, NULL, &media_count);
+
+	if(ret == MEDIA_CONTENT_ERROR_NONE && (applied_count != 3 || media_count != 2))
+	{
+		media_content_error("retried tag applied : %d, media : %d", applied_count, media_count);
+		ret = MEDIA_CONTENT_ERROR_INVALID_OPERATION;
+	}
+
+	/* The renames were part of the retried batches */
+	media_tag_destroy(tag);
+	tag = NULL;
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = media_tag_get_tag_from_db(tag_id, &tag);
+	if(ret == MEDIA_CONTENT_ERROR_NONE)
+		ret = media_tag_get_name(tag, &name);
+
+	if(ret == MEDIA_CONTENT_ERROR_NONE && (name == NULL || strcmp(name, "rollback_tag_taken") != 0))
+	{
+		media_content_error("retried tag name : %s", name);
+		ret = MEDIA_CONTENT_ERROR_INVALID_OPERATION;
+	}
+
+	SAFE_FREE(name);
+
+	if(playlist != NULL)
+		media_playlist_destroy(playlist);
+	if(taken_playlist != NULL)
+		media_playlist_destroy(taken_playlist);
+	if(tag != NULL)
+		media_tag_destroy(tag);
+	if(taken_tag != NULL)
+		media_tag_destroy(taken_tag);
+
+	media_playlist_delete_from_db(playlist_id);
+	media_playlist_delete_from_db(taken_playlist_id);
+	media_tag_delete_from_db(tag_id);
+	media_tag_delete_from_db(taken_tag_id);
 
 	return ret;
 }
@@ -2105,6 +3323,10 @@ int main(int argc, char *argv[])
 	if(ret != MEDIA_CONTENT_ERROR_NONE)
 		return ret;
 
+	ret = test_insert_batch();
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+		return ret;
+
 	ret = test_move();
 	if(ret != MEDIA_CONTENT_ERROR_NONE)
 		return ret;
@@ -2116,6 +3338,66 @@ int main(int argc, char *argv[])
 	ret = DFT_test();
 	if(ret != MEDIA_CONTENT_ERROR_NONE)
 		return ret;
+
+	ret = test_filter_generate_benchmark();
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+		return ret;
+
+	ret = test_projection();
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+		return ret;
+
+	ret = test_playlist_concurrency();
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+		return ret;
+
+	ret = test_update_rollback();
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+		return ret;
+
+	ret = test_cursor();
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+		return ret;
+
+	ret = test_continuation_token();
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+		return ret;
+
+	ret = test_group_with_count();
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+		return ret;
+
+	ret = test_group_summary();
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+		return ret;
+
+	ret = test_query_plan();
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+		return ret;
+
+	ret = test_stats();
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+		return ret;
+
+	ret = test_async();
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+		return ret;
+
+	ret = test_foreach_batch();
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+		return ret;
+
+	ret = test_columns();
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+		return ret;
+
+	ret = test_aggregate();
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+		return ret;
+
+	ret = test_usage();
+	if(ret != MEDIA_CONTENT_ERROR_NONE)
+		return ret;
 #endif
 
 	ret = test_disconnect_database();